@@ -0,0 +1,92 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+// ─────────────────────────────────────────
+// Minimal in-tree microbenchmark harness
+// ─────────────────────────────────────────
+
+class BenchState {
+   private:
+    typedef std::chrono::steady_clock Clock;
+
+    long remaining;
+    bool timing;
+    Clock::time_point startTime;
+    double elapsedSeconds;
+
+   public:
+    const long iterations;
+    const int arg;  // Parameter for BENCH_ARGS cases (0 otherwise)
+    std::map<std::string, double> counters;
+
+    BenchState(long iters, int argument)
+        : remaining(iters), timing(false), elapsedSeconds(0), iterations(iters), arg(argument) {}
+
+    // Loop condition for the timed region. Setup done before the first call is not timed.
+    bool keepRunning() {
+        if (remaining > 0) {
+            if (!timing) resumeTiming();
+            --remaining;
+            return true;
+        }
+        pauseTiming();
+        return false;
+    }
+
+    void pauseTiming() {
+        if (!timing) return;
+        elapsedSeconds += std::chrono::duration<double>(Clock::now() - startTime).count();
+        timing = false;
+    }
+
+    void resumeTiming() {
+        if (timing) return;
+        startTime = Clock::now();
+        timing = true;
+    }
+
+    // Record a per-iteration counter (e.g. vertices emitted, entities touched)
+    void setCounter(const std::string& name, double perIteration) { counters[name] = perIteration; }
+
+    double elapsed() const { return elapsedSeconds; }
+};
+
+typedef void (*BenchFn)(BenchState&);
+
+struct BenchCase {
+    std::string name;
+    BenchFn fn;
+    std::vector<int> args;
+};
+
+std::vector<BenchCase>& benchRegistry();
+
+struct BenchRegistrar {
+    BenchRegistrar(const char* name, BenchFn fn, std::vector<int> args = std::vector<int>()) {
+        BenchCase c;
+        c.name = name;
+        c.fn = fn;
+        c.args = args;
+        benchRegistry().push_back(c);
+    }
+};
+
+// Prevent the optimizer from discarding a computed value
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+#define BENCH_CONCAT_(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_(a, b)
+
+#define BENCH(name, fn) static BenchRegistrar BENCH_CONCAT(benchRegistrar_, __LINE__)(name, fn)
+#define BENCH_ARGS(name, fn, ...) \
+    static BenchRegistrar BENCH_CONCAT(benchRegistrar_, __LINE__)(name, fn, {__VA_ARGS__})
+
+#endif
@@ -0,0 +1,211 @@
+// Sprite loading at startup (GL calls go to the sink, whose glTexImage2D copies the pixels
+// the way a driver would)
+
+#include "bench.h"
+#include "constants.h"
+#include "gl_sink.h"
+#include "texture.h"
+#include <chrono>
+#include <fcntl.h>
+#include <fstream>
+#include <iterator>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char* const SPRITE_NAMES[] = {"player", "coin", "enemy", "tile_grass",
+                                           "tile_stone", "tile_moving", "cloud", "particle"};
+static const char* const SPRITE_PACK = "assets/sprites.pha";
+
+static std::string spritePath(const char* name) {
+    return std::string("assets/sprites/") + name + ".png";
+}
+
+static void loadSprites(TextureManager& tm) {
+    for (const char* name : SPRITE_NAMES) tm.loadSpriteAsync(name, spritePath(name));
+    tm.finishLoading();
+}
+
+// Drop a file's pages from the page cache, so the next read goes to the disk
+static void evict(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+}
+
+// With 0 loader threads the decodes run one after another on the waiting thread
+static void benchLoadSprites(BenchState& state) {
+    TextureManager& tm = TextureManager::getInstance();
+    tm.cleanup();
+    tm.setLoaderThreads(state.arg);
+    while (state.keepRunning()) {
+        loadSprites(tm);
+        state.pauseTiming();
+        tm.cleanup();
+        state.resumeTiming();
+    }
+    tm.setLoaderThreads(-1);
+    state.setCounter("sprites", 8);
+}
+BENCH_ARGS("TextureManager::loadSpriteAsync/8_sprites/workers", benchLoadSprites, 0, 1, 3);
+
+// Everything Renderer::loadAssets does, from PNGs or from the pack; arg 1 evicts the files
+// from the page cache before each load (cold start), arg 0 leaves them cached (warm)
+static void benchStartup(BenchState& state, bool packed) {
+    TextureManager& tm = TextureManager::getInstance();
+    tm.cleanup();
+    while (state.keepRunning()) {
+        state.pauseTiming();
+        if (state.arg) {
+            evict(SPRITE_PACK);
+            for (const char* name : SPRITE_NAMES) evict(spritePath(name));
+        }
+        state.resumeTiming();
+
+        if (packed && !tm.openPack(SPRITE_PACK)) {
+            fprintf(stderr, "No %s; run make pack\n", SPRITE_PACK);
+            return;
+        }
+        loadSprites(tm);
+
+        state.pauseTiming();
+        tm.cleanup();
+        state.resumeTiming();
+    }
+}
+
+static void benchStartupPng(BenchState& state) {
+    benchStartup(state, false);
+}
+BENCH_ARGS("TextureManager::startup/png/cold", benchStartupPng, 0, 1);
+
+static void benchStartupPack(BenchState& state) {
+    benchStartup(state, true);
+}
+BENCH_ARGS("TextureManager::startup/pack/cold", benchStartupPack, 0, 1);
+
+// The same sprites drawn in memory by the generators, no files involved. Arg is the
+// number of loader threads.
+static void benchStartupGenerated(BenchState& state) {
+    TextureManager& tm = TextureManager::getInstance();
+    tm.cleanup();
+    tm.setLoaderThreads(state.arg);
+    while (state.keepRunning()) {
+        tm.loadGeneratedSprites();
+        tm.finishLoading();
+        state.pauseTiming();
+        tm.cleanup();
+        state.resumeTiming();
+    }
+    tm.setLoaderThreads(-1);
+}
+BENCH_ARGS("TextureManager::startup/generated/workers", benchStartupGenerated, 0, 1, 3);
+
+// The same, stored RGBA8 (arg 0) or palette-indexed (arg 1); texture_bytes is what was
+// uploaded, palettes included
+static void benchStartupIndexed(BenchState& state) {
+    TextureManager& tm = TextureManager::getInstance();
+    tm.cleanup();
+    tm.setIndexedSprites(state.arg != 0);
+    glSink.reset();
+    while (state.keepRunning()) {
+        tm.loadGeneratedSprites();
+        tm.finishLoading();
+        state.pauseTiming();
+        tm.cleanup();
+        state.resumeTiming();
+    }
+    state.setCounter("texture_bytes", (double)glSink.textureBytes / state.iterations);
+    tm.setIndexedSprites(true);
+}
+BENCH_ARGS("TextureManager::startup/generated/indexed", benchStartupIndexed, 0, 1);
+
+// Hot reload. Sprites are watched in a scratch copy of assets/sprites, so saving one does not
+// touch the repository.
+static const char* const WATCH_DIR = "/tmp/pixel_bench_sprites";
+
+static void saveSprite(const char* name, const std::vector<char>& bytes) {
+    std::string path = std::string(WATCH_DIR) + "/" + name + ".png";
+    std::ofstream(path, std::ios::binary).write(bytes.data(), bytes.size());
+}
+
+static bool watchScratch(TextureManager& tm, std::vector<char>& player) {
+    std::ifstream in(spritePath("player"), std::ios::binary);
+    player.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    mkdir(WATCH_DIR, 0755);
+    saveSprite("player", player);
+    tm.cleanup();
+    tm.loadGeneratedSprites();
+    tm.finishLoading();
+    return !player.empty() && tm.watchSprites(WATCH_DIR);
+}
+
+// Per-frame cost of watching when nothing changed: one read() that finds no events
+static void benchCheckWatchedIdle(BenchState& state) {
+    TextureManager& tm = TextureManager::getInstance();
+    std::vector<char> player;
+    if (!watchScratch(tm, player)) return;
+    while (state.keepRunning()) {
+        tm.checkWatched();
+        tm.uploadDecoded(SPRITE_UPLOADS_PER_FRAME);
+    }
+    tm.cleanup();
+}
+BENCH("TextureManager::checkWatched/idle", benchCheckWatchedIdle);
+
+// Save player.png, then poll as frames would until the new pixels are in the texture. The
+// time is save-to-visible; max_poll_ms is the longest single poll, the hitch a frame sees.
+static void benchHotReload(BenchState& state) {
+    TextureManager& tm = TextureManager::getInstance();
+    std::vector<char> player;
+    if (!watchScratch(tm, player)) return;
+    double maxPollMs = 0;
+    while (state.keepRunning()) {
+        saveSprite("player", player);
+        int uploads = glSink.textureUploads;
+        while (glSink.textureUploads == uploads) {
+            auto start = std::chrono::steady_clock::now();
+            tm.checkWatched();
+            tm.uploadDecoded(SPRITE_UPLOADS_PER_FRAME);
+            maxPollMs = std::max(maxPollMs, std::chrono::duration<double, std::milli>(
+                                                std::chrono::steady_clock::now() - start)
+                                                .count());
+        }
+    }
+    tm.cleanup();
+    state.setCounter("max_poll_ms", maxPollMs);
+}
+BENCH("TextureManager::hotReload/player", benchHotReload);
+
+// Residency under a budget of half the sprites, with frames drawing one half of them. Each
+// iteration switches halves, as a level change would, and draws frames until the new half is
+// all resident; the time is the GL thread's, with 1 ms between frames left to the loaders.
+static void benchResidency(BenchState& state) {
+    TextureManager& tm = TextureManager::getInstance();
+    tm.cleanup();
+    tm.loadGeneratedSprites();
+    tm.finishLoading();
+    tm.setTextureBudget(tm.getStats().residentBytes / 2);
+    int half = 0;
+    long frames = 0;
+    while (state.keepRunning()) {
+        half ^= 1;
+        for (int stalled = -1; stalled != tm.getStats().stalledDraws; frames++) {
+            stalled = tm.getStats().stalledDraws;
+            tm.nextFrame();
+            tm.uploadDecoded(SPRITE_UPLOADS_PER_FRAME);
+            for (int i = 0; i < 4; i++) tm.drawSprite(SPRITE_NAMES[half * 4 + i], 0, 0);
+
+            state.pauseTiming();
+            usleep(1000);
+            state.resumeTiming();
+        }
+    }
+    const TextureStats& stats = tm.getStats();
+    state.setCounter("frames", (double)frames / state.iterations);
+    state.setCounter("evictions", (double)stats.evictions / state.iterations);
+    state.setCounter("stalled_draws", (double)stats.stalledDraws / state.iterations);
+    tm.setTextureBudget(0);
+    tm.cleanup();
+}
+BENCH("TextureManager::residency/switch_half", benchResidency);
@@ -0,0 +1,104 @@
+// Entity-component registry: system iteration and swap-remove churn
+
+#include "bench.h"
+#include "systems.h"
+#include <cstdlib>
+
+static void populate(Registry& registry, int count) {
+    srand(5);
+    for (int i = 0; i < count; i++) {
+        float x = i * 40.0f;
+        spawnEnemy(registry, Enemy(x, 93, x - 30, x + 60), i, 0);
+        spawnCoin(registry, Collectible(x + 20, 200), i);
+    }
+}
+
+static void benchPatrolSystem(BenchState& state) {
+    Registry registry;
+    populate(registry, state.arg);
+    int tick = 0;
+    while (state.keepRunning()) patrolSystem(registry, tick++);
+    doNotOptimize(registry.transforms[0].x);
+}
+BENCH_ARGS("patrolSystem", benchPatrolSystem, 1000, 100000);
+
+static void benchExtractSprites(BenchState& state) {
+    Registry registry;
+    populate(registry, state.arg);
+    std::vector<SpriteInstance> sprites;
+    float tick = 0;
+    while (state.keepRunning()) {
+        sprites.clear();
+        extractSprites(registry, SpriteKind::COIN, tick, sprites);
+        extractSprites(registry, SpriteKind::ENEMY, tick, sprites);
+        tick += 1;
+    }
+    state.setCounter("sprites", sprites.size());
+}
+BENCH_ARGS("extractSprites", benchExtractSprites, 1000, 100000);
+
+// Destroy a random live entity and spawn a replacement, as activity regions do while the
+// player runs
+static void benchRegistryChurn(BenchState& state) {
+    Registry registry;
+    populate(registry, state.arg);
+    std::vector<Entity> live;
+    for (size_t i = 0; i < registry.hazards.size(); i++) live.push_back(registry.hazards.entity(i));
+
+    Enemy enemy(0, 93, -30, 60);
+    while (state.keepRunning()) {
+        size_t victim = rand() % live.size();
+        registry.destroy(live[victim]);
+        live[victim] = spawnEnemy(registry, enemy, 0, 0);
+    }
+    state.setCounter("live", registry.size());
+}
+BENCH_ARGS("Registry::destroy+spawn", benchRegistryChurn, 1000, 100000);
+
+// Player contact tests against 100k coins and 10k patrolling enemies: patrol, re-sort the
+// moved enemies, then query the player's box. Only nearby candidates are visited.
+static void benchBroadphase(BenchState& state) {
+    Registry registry;
+    SweepAndPrune triggers;
+    srand(5);
+    for (int i = 0; i < 100000; i++) {
+        Entity coin = spawnCoin(registry, Collectible(i * 40.0f + 20, 200), i);
+        addTrigger(registry, triggers, coin);
+        if (i % 10 == 0) {
+            float x = i * 40.0f;
+            Entity enemy = spawnEnemy(registry, Enemy(x, 93, x - 30, x + 60), i, 0);
+            addTrigger(registry, triggers, enemy);
+        }
+    }
+
+    std::vector<Entity> contacts;
+    size_t candidates = 0;
+    int tick = 0;
+    while (state.keepRunning()) {
+        state.pauseTiming();
+        patrolSystem(registry, tick++);
+        state.resumeTiming();
+        syncTriggers(registry, triggers);
+        float x = (rand() % 100000) * 40.0f;
+        triggers.query(x - 12, x + 12, contacts);
+        candidates += contacts.size();
+    }
+    state.setCounter("candidates", candidates / (double)state.iterations);
+}
+BENCH("SweepAndPrune::sync+query/100k_coins_10k_enemies", benchBroadphase);
+
+static void benchBroadphaseQuery(BenchState& state) {
+    Registry registry;
+    SweepAndPrune triggers;
+    for (int i = 0; i < 100000; i++) {
+        addTrigger(registry, triggers, spawnCoin(registry, Collectible(i * 40.0f, 200), i));
+    }
+    std::vector<Entity> contacts;
+    srand(5);
+    while (state.keepRunning()) {
+        float x = (rand() % 100000) * 40.0f;
+        triggers.query(x, x, contacts);
+        doNotOptimize(contacts.size());
+    }
+}
+BENCH("SweepAndPrune::query/100k_coins", benchBroadphaseQuery);
@@ -0,0 +1,151 @@
+// Simulation benchmarks: particles, platform collision and full Game::update ticks
+
+#include "bench.h"
+#include "game.h"
+#include <cstdlib>
+
+// Width of the built-in level; tiled copies are laid end to end
+static const float LEVEL_SPAN = 3250.0f;
+
+// Start a game and replace the built-in level with `copies` tiled copies of it.
+// Enemies patrolling the spawn column are dropped so an idle player survives indefinitely.
+static void startScaledGame(Game& game, int copies) {
+    game.handleKeyDown(13);
+    game.handleKeyUp(13);
+
+    std::vector<Platform> platforms = game.getPlatforms();
+    std::vector<Collectible> coins = game.getCollectibles();
+    std::vector<Enemy> enemies = game.getEnemies();
+    float spawnX = game.getPlayer().x;
+
+    game.getPlatforms().clear();
+    game.getCollectibles().clear();
+    game.getEnemies().clear();
+
+    for (int k = 0; k < copies; k++) {
+        float offset = k * LEVEL_SPAN;
+        for (Platform p : platforms) {
+            p.x += offset;
+            p.originalX += offset;
+            game.getPlatforms().push_back(p);
+        }
+        for (Collectible c : coins) {
+            c.x += offset;
+            game.getCollectibles().push_back(c);
+        }
+        for (Enemy e : enemies) {
+            if (k == 0 && e.patrolLeft <= spawnX + 30 && e.patrolRight >= spawnX - 30) continue;
+            e.x += offset;
+            e.spawnX += offset;
+            e.patrolLeft += offset;
+            e.patrolRight += offset;
+            game.getEnemies().push_back(e);
+        }
+    }
+    game.rebuildActivity();
+}
+
+// ─────────────────────────────────────────
+// Particles
+// ─────────────────────────────────────────
+
+static void refillParticles(ParticleSystem& ps, size_t population) {
+    while (ps.getParticles().size() < population) {
+        ps.addParticle(rand() % 1000, rand() % 700, (rand() % 200 - 100) / 20.0f,
+                       (rand() % 100) / 10.0f, Color(1.0f, 1.0f, 0.0f), 20 + rand() % 60);
+    }
+}
+
+static void benchParticleUpdate(BenchState& state) {
+    ParticleSystem ps;
+    srand(7);
+    refillParticles(ps, state.arg);
+
+    while (state.keepRunning()) {
+        ps.update();
+
+        // Top the pool back up so every tick sees the same population and churn
+        state.pauseTiming();
+        refillParticles(ps, state.arg);
+        state.resumeTiming();
+    }
+    state.setCounter("particles", state.arg);
+}
+BENCH_ARGS("ParticleSystem::update", benchParticleUpdate, 100, 1000, 10000);
+
+// ─────────────────────────────────────────
+// Platform collision
+// ─────────────────────────────────────────
+
+static void benchCheckCollisionLoop(BenchState& state) {
+    Game game;
+    startScaledGame(game, state.arg);
+    const std::vector<Platform>& platforms = game.getPlatforms();
+
+    // Sweep the player box across the whole level, one platform pass per tick
+    float x = 0;
+    float span = LEVEL_SPAN * state.arg;
+    int hits = 0;
+    while (state.keepRunning()) {
+        for (const Platform& p : platforms) {
+            if (Game::checkCollision(x - 12, 60, 24, 36, p)) hits++;
+        }
+        x += 4.5f;
+        if (x > span) x = 0;
+    }
+    doNotOptimize(hits);
+    state.setCounter("platforms", platforms.size());
+}
+BENCH_ARGS("Game::checkCollision/level_copies", benchCheckCollisionLoop, 1, 16, 64);
+
+// ─────────────────────────────────────────
+// Full simulation tick
+// ─────────────────────────────────────────
+
+static void benchGameUpdate(BenchState& state) {
+    srand(11);
+    Game game;
+    startScaledGame(game, state.arg);
+
+    // Let the player land and settle before timing
+    for (int i = 0; i < 120; i++) game.update();
+
+    while (state.keepRunning()) game.update();
+
+    state.setCounter("platforms", game.getPlatforms().size());
+    state.setCounter("enemies", game.getEnemies().size());
+    state.setCounter("coins", game.getCollectibles().size());
+}
+BENCH_ARGS("Game::update/level_copies", benchGameUpdate, 1, 16, 64);
+
+// One second of play (running right, jumping) at each tick rate: lower rates cost fewer,
+// longer steps through the swept collision
+static void benchGameSecond(BenchState& state) {
+    srand(11);
+    Game game;
+    game.setTickRate(state.arg);
+    game.setGeneratedLevel(LevelGenParams(1234, 1000));
+    game.handleKeyDown(13);
+    game.handleKeyUp(13);
+    game.handleKeyDown('d');
+
+    int updates = game.getTickRate();
+    while (state.keepRunning()) {
+        for (int i = 0; i < updates; i++) {
+            if (i % 10 == 0) {
+                game.handleKeyDown(' ');
+                game.handleKeyUp(' ');
+            }
+            game.processInput();
+            game.update();
+        }
+        if (game.getState() != GameState::PLAYING) {
+            state.pauseTiming();
+            game.handleKeyDown('r');
+            game.handleKeyUp('r');
+            state.resumeTiming();
+        }
+    }
+    state.setCounter("updates", updates);
+}
+BENCH_ARGS("Game::update/one_second_at_hz", benchGameSecond, 60, 30, 20);
@@ -0,0 +1,79 @@
+// Job system: scheduling overhead and parallel update phases. Args are worker counts
+// (0 runs every job on the benchmark thread).
+
+#include "bench.h"
+#include "capture.h"
+#include "game.h"
+#include "jobs.h"
+#include <cmath>
+#include <cstdlib>
+
+static void benchParallelFor(BenchState& state) {
+    JobSystem jobs(state.arg);
+    std::vector<float> values(1 << 20, 1.0f);
+
+    while (state.keepRunning()) {
+        JobCounter done;
+        jobs.parallelFor(values.size(), 16384, [&values](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) values[i] = sqrtf(values[i] + 1.0f);
+        }, done);
+        jobs.wait(done);
+    }
+    doNotOptimize(values[0]);
+    state.setCounter("items", values.size());
+}
+BENCH_ARGS("JobSystem::parallelFor/1M/workers", benchParallelFor, 0, 1, 3);
+
+static void benchEmptyJobs(BenchState& state) {
+    JobSystem jobs(state.arg);
+    while (state.keepRunning()) {
+        JobCounter done;
+        for (int i = 0; i < 64; i++) jobs.submit([]() {}, done);
+        jobs.wait(done);
+    }
+    state.setCounter("jobs", 64);
+}
+BENCH_ARGS("JobSystem::submit+wait/64_empty/workers", benchEmptyJobs, 0, 1, 3);
+
+// Full ticks on a big generated level with a heavy, constantly refilled particle load
+static void benchGameUpdateParticles(BenchState& state) {
+    srand(11);
+    Game game;
+    game.setWorkerThreads(state.arg);
+    game.setGeneratedLevel(LevelGenParams(1234, 100000));
+    game.handleKeyDown(13);
+    game.handleKeyUp(13);
+    for (int i = 0; i < 120; i++) game.update();
+
+    ParticleSystem& particles = game.getParticleSystem();
+    while (state.keepRunning()) {
+        state.pauseTiming();
+        while (particles.getParticles().size() < 100000) {
+            particles.addParticle(rand() % 1000, rand() % 700, (rand() % 200 - 100) / 20.0f,
+                                  (rand() % 100) / 10.0f, Color(1.0f, 1.0f, 0.0f),
+                                  20 + rand() % 60);
+        }
+        state.resumeTiming();
+        game.update();
+    }
+    state.setCounter("particles", particles.getParticles().size());
+}
+BENCH_ARGS("Game::update/100k_particles/workers", benchGameUpdateParticles, 0, 1, 3);
+
+// Game-thread cost of capturing one window-sized frame into a Y4M stream (GL calls go to the
+// sink, so this is the copy out of the mapped buffer plus the hand-off). Encoders catch up
+// between frames, as they would at 60 Hz.
+static void benchCaptureFrame(BenchState& state) {
+    FrameCapture capture;
+    capture.start("/dev/null", CaptureFormat::Y4M, WINDOW_WIDTH, WINDOW_HEIGHT, 60, state.arg);
+    while (state.keepRunning()) {
+        capture.captureFrame();
+        state.pauseTiming();
+        capture.waitIdle();
+        state.resumeTiming();
+    }
+    state.setCounter("max_game_ms", capture.getStats().maxGameMs);
+    state.setCounter("dropped", capture.getStats().dropped);
+    capture.stop();
+}
+BENCH_ARGS("FrameCapture::captureFrame/y4m/workers", benchCaptureFrame, 1, 3);
@@ -0,0 +1,307 @@
+// Rasterization, clipping and transform kernels from graphics.cpp / types.h
+
+#include "bench.h"
+#include "gl_sink.h"
+#include "arena.h"
+#include "backend.h"
+#include "constants.h"
+#include "graphics.h"
+#include "levelgen.h"
+#include "renderer.h"
+#include "types.h"
+#include <cstdlib>
+
+// ─────────────────────────────────────────
+// Scanline fill
+// ─────────────────────────────────────────
+
+static void benchScanLineFillTriangle(BenchState& state) {
+    // Heart body from drawHeart
+    std::vector<Point> triangle = {Point(19, 675), Point(31, 675), Point(25, 668)};
+    glSink.reset();
+    while (state.keepRunning()) scanLineFill(triangle, Color(0.9f, 0.15f, 0.2f));
+    state.setCounter("vertices_per_op", (double)glSink.vertices / state.iterations);
+}
+BENCH("scanLineFill/triangle", benchScanLineFillTriangle);
+
+static void benchScanLineFillMountains(BenchState& state) {
+    // Distant mountain range from drawBackground
+    std::vector<Point> mountain = {Point(-200, 80), Point(100, 280), Point(300, 220),
+                                   Point(500, 320), Point(700, 200), Point(900, 350),
+                                   Point(1200, 180), Point(1400, 80)};
+    glSink.reset();
+    while (state.keepRunning()) scanLineFill(mountain, Color(0.3f, 0.25f, 0.45f, 0.6f));
+    state.setCounter("vertices_per_op", (double)glSink.vertices / state.iterations);
+}
+BENCH("scanLineFill/mountains", benchScanLineFillMountains);
+
+static void benchScanLineFillGradient(BenchState& state) {
+    std::vector<Point> quad = {Point(0, 0), Point(1000, 0), Point(1000, 700), Point(0, 700)};
+    glSink.reset();
+    while (state.keepRunning()) {
+        scanLineFill(quad, Color(0.35f, 0.55f, 0.75f), Color(0.65f, 0.8f, 0.9f), true);
+    }
+    state.setCounter("vertices_per_op", (double)glSink.vertices / state.iterations);
+}
+BENCH("scanLineFill/gradient_fullscreen", benchScanLineFillGradient);
+
+// The frame's temporaries (polygon points, edge tables, HUD text) come from the frame arena,
+// reset each frame as display() does. Sprites are not loaded, so only the procedural parts draw.
+static void benchBackgroundAndHud(BenchState& state) {
+    Renderer renderer;
+    Player player;
+    size_t arenaBytes = 0;
+    glSink.reset();
+    while (state.keepRunning()) {
+        frameArena.reset();
+        renderer.drawBackground(400);
+        renderer.drawHUD(1234, 2, 95.0f, player);
+        arenaBytes = frameArena.getUsed();
+    }
+    state.setCounter("vertices_per_op", (double)glSink.vertices / state.iterations);
+    state.setCounter("arena_bytes", (double)arenaBytes);
+    state.setCounter("arena_high_water", (double)frameArena.getStats().highWater);
+}
+BENCH("Renderer::drawBackground+drawHUD", benchBackgroundAndHud);
+
+// Particles spread over the screen, as many alive as `count`
+static std::vector<Particle> particleField(int count) {
+    std::vector<Particle> particles;
+    particles.reserve(count);
+    srand(11);
+    for (int i = 0; i < count; i++) {
+        Color color(1.0f, 0.5f + (rand() % 50) / 100.0f, 0.2f, 0.2f + (rand() % 80) / 100.0f);
+        particles.emplace_back(rand() % WINDOW_WIDTH, rand() % WINDOW_HEIGHT, 0, 0, color, 60);
+    }
+    return particles;
+}
+
+// One drawSprite per particle against one instanced set, through the fixed function or the
+// core profile backend. Counts what reaches the GL sink.
+static void benchDrawParticles(BenchState& state, bool instanced, RendererKind kind) {
+    if (kind == RendererKind::CORE) {
+        glSinkVersion = "3.3 gl_sink";
+        selectRenderBackend(kind);
+    }
+    TextureManager& tm = TextureManager::getInstance();
+    tm.loadGeneratedSprites();
+    tm.finishLoading();
+    Renderer renderer;
+    renderer.setInstancing(instanced);
+    std::vector<Particle> particles = particleField(state.arg);
+    glSink.reset();
+    while (state.keepRunning()) {
+        renderBackend().beginFrame(WINDOW_WIDTH, WINDOW_HEIGHT);
+        renderer.drawParticles(particles, 0);
+        renderBackend().endFrame();
+    }
+    state.setCounter("draw_calls_per_op", (double)glSink.primitives / state.iterations);
+    state.setCounter("gl_calls_per_op",
+                     (double)(glSink.vertices + glSink.stateChanges) / state.iterations);
+    if (kind == RendererKind::CORE) {
+        selectRenderBackend(RendererKind::FIXED_FUNCTION);
+        glSinkVersion = "2.1 gl_sink";
+    }
+}
+
+static void benchDrawParticlesInstanced(BenchState& state) {
+    benchDrawParticles(state, true, RendererKind::FIXED_FUNCTION);
+}
+BENCH_ARGS("Renderer::drawParticles/instanced", benchDrawParticlesInstanced, 1000, 100000);
+
+static void benchDrawParticlesInstancedCore(BenchState& state) {
+    benchDrawParticles(state, true, RendererKind::CORE);
+}
+BENCH_ARGS("Renderer::drawParticles/instanced_core", benchDrawParticlesInstancedCore, 1000,
+           100000, 1000000);
+
+static void benchDrawParticlesPerSprite(BenchState& state) {
+    benchDrawParticles(state, false, RendererKind::FIXED_FUNCTION);
+}
+BENCH_ARGS("Renderer::drawParticles/per_sprite", benchDrawParticlesPerSprite, 1000, 100000);
+
+// A screenful of coins: glow and sprite each
+static void benchDrawCollectibles(BenchState& state, bool instanced) {
+    TextureManager& tm = TextureManager::getInstance();
+    tm.loadGeneratedSprites();
+    tm.finishLoading();
+    Renderer renderer;
+    renderer.setInstancing(instanced);
+    std::vector<SpriteInstance> coins;
+    for (int i = 0; i < 200; i++) {
+        coins.push_back(SpriteInstance{SpriteKind::COIN, 25.0f + (i % 25) * 40.0f,
+                                       100.0f + (i / 25) * 60.0f, COIN_SPRITE_SCALE, i % 6,
+                                       false});
+    }
+    glSink.reset();
+    while (state.keepRunning()) renderer.drawCollectibles(coins, 0);
+    state.setCounter("draw_calls_per_op", (double)glSink.primitives / state.iterations);
+}
+
+static void benchDrawCollectiblesInstanced(BenchState& state) {
+    benchDrawCollectibles(state, true);
+}
+BENCH("Renderer::drawCollectibles/instanced/200", benchDrawCollectiblesInstanced);
+
+static void benchDrawCollectiblesPerSprite(BenchState& state) {
+    benchDrawCollectibles(state, false);
+}
+BENCH("Renderer::drawCollectibles/per_sprite/200", benchDrawCollectiblesPerSprite);
+
+// The camera panning across the first 20 screens of a generated level, a frame per op
+static void benchDrawPlatforms(BenchState& state, bool retained, RendererKind kind) {
+    if (kind == RendererKind::CORE) {
+        glSinkVersion = "3.3 gl_sink";
+        selectRenderBackend(kind);
+    }
+    TextureManager& tm = TextureManager::getInstance();
+    tm.loadGeneratedSprites();
+    tm.finishLoading();
+    std::vector<Platform> platforms;
+    std::vector<Collectible> coins;
+    std::vector<Enemy> enemies;
+    generateLevel(LevelGenParams(42), platforms, coins, enemies);
+    {
+        Renderer renderer;
+        renderer.setRetainedPlatforms(retained);
+        float cameraX = 0;
+        glSink.reset();
+        while (state.keepRunning()) {
+            renderBackend().beginFrame(WINDOW_WIDTH, WINDOW_HEIGHT);
+            renderer.drawPlatforms(platforms, cameraX);
+            renderBackend().endFrame();
+            cameraX += 4.5f;
+            if (cameraX > 20 * WINDOW_WIDTH) cameraX = 0;
+        }
+        state.setCounter("draw_calls_per_op", (double)glSink.primitives / state.iterations);
+        state.setCounter("gl_calls_per_op",
+                         (double)(glSink.vertices + glSink.stateChanges) / state.iterations);
+    }
+    if (kind == RendererKind::CORE) {
+        selectRenderBackend(RendererKind::FIXED_FUNCTION);
+        glSinkVersion = "2.1 gl_sink";
+    }
+}
+
+static void benchDrawPlatformsImmediate(BenchState& state) {
+    benchDrawPlatforms(state, false, RendererKind::FIXED_FUNCTION);
+}
+BENCH("Renderer::drawPlatforms/immediate", benchDrawPlatformsImmediate);
+
+static void benchDrawPlatformsImmediateCore(BenchState& state) {
+    benchDrawPlatforms(state, false, RendererKind::CORE);
+}
+BENCH("Renderer::drawPlatforms/immediate_core", benchDrawPlatformsImmediateCore);
+
+static void benchDrawPlatformsRetained(BenchState& state) {
+    benchDrawPlatforms(state, true, RendererKind::FIXED_FUNCTION);
+}
+BENCH("Renderer::drawPlatforms/retained", benchDrawPlatformsRetained);
+
+static void benchDrawPlatformsRetainedCore(BenchState& state) {
+    benchDrawPlatforms(state, true, RendererKind::CORE);
+}
+BENCH("Renderer::drawPlatforms/retained_core", benchDrawPlatformsRetainedCore);
+
+// ─────────────────────────────────────────
+// Line rasterization
+// ─────────────────────────────────────────
+
+static void benchLineDDA(BenchState& state) {
+    // Platform outline edge of the given length, plus the matching diagonal
+    float len = (float)state.arg;
+    Color edge(0.1f, 0.1f, 0.1f, 0.4f);
+    glSink.reset();
+    while (state.keepRunning()) {
+        drawLineDDA(100, 50, 100 + len, 50, edge);
+        drawLineDDA(100, 50, 100 + len, 50 + len * 0.5f, edge);
+    }
+    state.setCounter("vertices_per_op", (double)glSink.vertices / state.iterations);
+}
+BENCH_ARGS("drawLineDDA", benchLineDDA, 16, 128, 1024);
+
+static void benchLineBresenham(BenchState& state) {
+    int len = state.arg;
+    Color edge(0.1f, 0.1f, 0.1f, 0.4f);
+    glSink.reset();
+    while (state.keepRunning()) {
+        drawLineBresenham(100, 50, 100 + len, 50, edge);
+        drawLineBresenham(100, 50, 100 + len, 50 + len / 2, edge);
+    }
+    state.setCounter("vertices_per_op", (double)glSink.vertices / state.iterations);
+}
+BENCH_ARGS("drawLineBresenham", benchLineBresenham, 16, 128, 1024);
+
+static void benchCircleMidpointFilled(BenchState& state) {
+    // Coin glow radius from drawCollectibles
+    glSink.reset();
+    while (state.keepRunning()) drawCircleMidpoint(500, 300, 14, Color(1, 0.9f, 0.3f, 0.15f), true);
+    state.setCounter("vertices_per_op", (double)glSink.vertices / state.iterations);
+}
+BENCH("drawCircleMidpoint/filled14", benchCircleMidpointFilled);
+
+// ─────────────────────────────────────────
+// Clipping
+// ─────────────────────────────────────────
+
+static void benchCohenSutherland(BenchState& state) {
+    // Mix of trivially accepted, trivially rejected and clipped segments around the window
+    const int N = 1024;
+    std::vector<float> segs(N * 4);
+    srand(42);
+    for (int i = 0; i < N * 4; i += 2) {
+        segs[i] = (float)(rand() % 2000 - 500);
+        segs[i + 1] = (float)(rand() % 1400 - 350);
+    }
+
+    int accepted = 0;
+    while (state.keepRunning()) {
+        for (int i = 0; i < N; i++) {
+            float x1 = segs[i * 4], y1 = segs[i * 4 + 1];
+            float x2 = segs[i * 4 + 2], y2 = segs[i * 4 + 3];
+            if (cohenSutherlandClip(x1, y1, x2, y2, 0, 0, 1000, 700)) accepted++;
+            doNotOptimize(x1);
+        }
+    }
+    doNotOptimize(accepted);
+    state.setCounter("segments_per_op", N);
+}
+BENCH("cohenSutherlandClip/1024_segments", benchCohenSutherland);
+
+// ─────────────────────────────────────────
+// Transform2D
+// ─────────────────────────────────────────
+
+static void benchTransformCompose(BenchState& state) {
+    float angle = 0;
+    while (state.keepRunning()) {
+        Transform2D t;
+        t.translate(500, 350);
+        t.rotate(angle);
+        t.scale(1.8f, 1.8f);
+        t.translate(-16, -16);
+        doNotOptimize(t);
+        angle += 0.5f;
+    }
+}
+BENCH("Transform2D/compose", benchTransformCompose);
+
+static void benchTransformPoints(BenchState& state) {
+    const int N = 1024;
+    std::vector<Point> points(N);
+    for (int i = 0; i < N; i++) points[i] = Point((float)(i % 32), (float)(i / 32));
+
+    Transform2D t;
+    t.translate(500, 350);
+    t.rotate(30);
+    t.scale(1.8f, 1.8f);
+
+    while (state.keepRunning()) {
+        for (int i = 0; i < N; i++) {
+            Point p = t.transform(points[i]);
+            doNotOptimize(p);
+        }
+    }
+    state.setCounter("points_per_op", N);
+}
+BENCH("Transform2D/transform_1024_points", benchTransformPoints);
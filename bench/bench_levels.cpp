@@ -0,0 +1,256 @@
+// Level generation, binary level files, streaming and simulation cost at scale
+
+#include "bench.h"
+#include "bot.h"
+#include "game.h"
+#include "levelgen.h"
+#include "levelfile.h"
+#include "netplay.h"
+#include "reachability.h"
+#include "spectator.h"
+#include "streaming.h"
+#include <algorithm>
+#include <chrono>
+#include <map>
+
+static void benchGenerateLevel(BenchState& state) {
+    std::vector<Platform> platforms;
+    std::vector<Collectible> coins;
+    std::vector<Enemy> enemies;
+    LevelGenParams params(1234, state.arg);
+
+    while (state.keepRunning()) {
+        float width = generateLevel(params, platforms, coins, enemies);
+        doNotOptimize(width);
+    }
+    state.setCounter("coins", coins.size());
+    state.setCounter("enemies", enemies.size());
+}
+BENCH_ARGS("generateLevel", benchGenerateLevel, 1000, 100000, 1000000);
+
+static void benchValidateLevel(BenchState& state) {
+    std::vector<Platform> platforms;
+    std::vector<Collectible> coins;
+    std::vector<Enemy> enemies;
+    generateLevel(LevelGenParams(1234, state.arg), platforms, coins, enemies);
+    JobSystem jobs(JobSystem::defaultWorkerCount());
+
+    ReachabilityReport report;
+    while (state.keepRunning()) report = validateLevel(platforms, coins, jobs);
+    state.setCounter("edges", report.edges);
+    state.setCounter("unreachable_coins", report.unreachableCoins.size());
+}
+BENCH_ARGS("validateLevel/generated", benchValidateLevel, 1000, 100000);
+
+static void benchGameUpdateGenerated(BenchState& state) {
+    srand(11);
+    Game game;
+    game.setGeneratedLevel(LevelGenParams(1234, state.arg));
+    game.handleKeyDown(13);
+    game.handleKeyUp(13);
+
+    // Let the player land and settle before timing
+    for (int i = 0; i < 120; i++) game.update();
+
+    while (state.keepRunning()) game.update();
+
+    state.setCounter("enemies", game.getEnemies().size());
+    state.setCounter("coins", game.getCollectibles().size());
+}
+BENCH_ARGS("Game::update/generated", benchGameUpdateGenerated, 1000, 10000, 100000);
+
+// Autoplay soak throughput: planning, maneuver search and the update it drives
+static void benchAutoplay(BenchState& state) {
+    srand(11);
+    Game game;
+    game.setGeneratedLevel(LevelGenParams(1234, state.arg));
+    Bot bot;
+
+    while (state.keepRunning()) {
+        bot.act(game);
+        game.update();
+    }
+    state.setCounter("coins", game.getCoinsCollected());
+}
+BENCH_ARGS("Bot::act+Game::update/generated", benchAutoplay, 200, 10000);
+
+// Worst-case rollback: restore a two-player snapshot and replay MAX_ROLLBACK ticks
+static void benchRollback(BenchState& state) {
+    srand(11);
+    Game game;
+    game.setGeneratedLevel(LevelGenParams(1234, state.arg));
+    game.setTwoPlayer(true);
+    game.handleKeyDown(13);
+    game.handleKeyUp(13);
+    for (int i = 0; i < 120; i++) game.update();
+
+    GameSnapshot snapshot;
+    game.saveState(snapshot);
+    while (state.keepRunning()) {
+        game.loadState(snapshot);
+        game.setReplaying(true);
+        for (int t = 0; t < RollbackSession::MAX_ROLLBACK; t++) {
+            game.applyInput(0, INPUT_RIGHT | (t == 0 ? INPUT_JUMP : 0));
+            game.applyInput(1, INPUT_LEFT);
+            game.update();
+        }
+        game.setReplaying(false);
+    }
+}
+BENCH_ARGS("Game::loadState+8_ticks/generated", benchRollback, 1000, 100000);
+
+// Spectator publishing cost per tick while the bot plays (the update itself is not timed)
+static void benchSpectatorFrame(BenchState& state) {
+    srand(11);
+    Game game;
+    game.setGeneratedLevel(LevelGenParams(1234, state.arg));
+    Bot bot;
+    SpectatorEncoder encoder;
+    std::vector<uint8_t> stream;
+
+    while (state.keepRunning()) {
+        state.pauseTiming();
+        bot.act(game);
+        game.update();
+        state.resumeTiming();
+        encoder.encodeFrame(game, stream);
+    }
+    state.setCounter("bytes", (double)stream.size() / state.iterations);
+}
+BENCH_ARGS("SpectatorEncoder::encodeFrame/generated", benchSpectatorFrame, 1000, 100000);
+
+// ─────────────────────────────────────────
+// Binary level files
+// ─────────────────────────────────────────
+
+// Pack a generated level once per process and return its path
+static std::string benchLevelFile(int platformCount) {
+    static std::map<int, std::string> written;
+    auto it = written.find(platformCount);
+    if (it != written.end()) return it->second;
+
+    std::vector<Platform> platforms;
+    std::vector<Collectible> coins;
+    std::vector<Enemy> enemies;
+    float width = generateLevel(LevelGenParams(1234, platformCount), platforms, coins, enemies);
+
+    std::string path = "/tmp/pixel_bench_level_" + std::to_string(platformCount) + ".phl";
+    writeLevelFile(path, width, WINDOW_HEIGHT, platforms, coins, enemies);
+    written[platformCount] = path;
+    return path;
+}
+
+static void benchLevelFileOpen(BenchState& state) {
+    std::string path = benchLevelFile(state.arg);
+    LevelFile file;
+    while (state.keepRunning()) {
+        file.open(path);
+        doNotOptimize(file.platforms());
+        file.close();
+    }
+}
+BENCH_ARGS("LevelFile::open", benchLevelFileOpen, 1000, 1000000);
+
+static void benchLevelFileInstantiate(BenchState& state) {
+    std::string path = benchLevelFile(state.arg);
+    LevelFile file;
+    file.open(path);
+
+    std::vector<Platform> platforms;
+    std::vector<Collectible> coins;
+    std::vector<Enemy> enemies;
+    while (state.keepRunning()) file.instantiate(platforms, coins, enemies);
+    state.setCounter("entities", platforms.size() + coins.size() + enemies.size());
+}
+BENCH_ARGS("LevelFile::instantiate", benchLevelFileInstantiate, 1000, 1000000);
+
+// ─────────────────────────────────────────
+// Level streaming
+// ─────────────────────────────────────────
+
+static void benchGameUpdateStreamed(BenchState& state) {
+    srand(11);
+    Game game;
+    game.setLevelFile(benchLevelFile(state.arg));
+    game.handleKeyDown(13);
+    game.handleKeyUp(13);
+
+    for (int i = 0; i < 120; i++) game.update();
+
+    while (state.keepRunning()) game.update();
+
+    state.setCounter("enemies", game.getEnemies().size());
+    state.setCounter("coins", game.getCollectibles().size());
+}
+BENCH_ARGS("Game::update/streamed", benchGameUpdateStreamed, 100000, 1000000);
+
+// Camera sweeping across the level at running speed. The worker is given time to catch up
+// between ticks, as it would at 60 Hz, so only game-thread cost is timed.
+static void benchStreamerSweep(BenchState& state) {
+    typedef std::chrono::steady_clock Clock;
+    LevelFile file;
+    file.open(benchLevelFile(state.arg));
+    LevelStreamer streamer;
+    streamer.start(&file);
+
+    std::vector<Platform> platforms;
+    std::vector<Collectible> coins;
+    std::vector<Enemy> enemies;
+    float cameraX = 0, step = PLAYER_SPEED;
+    double worstTick = 0;
+
+    // The first activation has nothing prefetched yet; keep it out of the numbers
+    streamer.update(cameraX, step, platforms, coins, enemies);
+    streamer.waitIdle();
+    long initialSyncLoads = streamer.getStats().syncLoads;
+
+    while (state.keepRunning()) {
+        Clock::time_point begin = Clock::now();
+        streamer.update(cameraX, step, platforms, coins, enemies);
+        worstTick =
+            std::max(worstTick, std::chrono::duration<double>(Clock::now() - begin).count());
+
+        cameraX += step;
+        if (cameraX < 0 || cameraX > file.width() - WINDOW_WIDTH) step = -step;
+
+        state.pauseTiming();
+        streamer.waitIdle();
+        state.resumeTiming();
+    }
+
+    const StreamStats& stats = streamer.getStats();
+    state.setCounter("worst_tick_us", worstTick * 1e6);
+    state.setCounter("resident_chunks", stats.residentChunks);
+    state.setCounter("sync_loads", stats.syncLoads - initialSyncLoads);
+}
+BENCH_ARGS("LevelStreamer::update/sweep", benchStreamerSweep, 100000, 1000000);
+
+// The worst case for the tick that activates chunks: the camera jumps between the start and
+// the middle of the level (a respawn), so nothing it lands on is prefetched and every active
+// chunk is loaded on the game thread
+static void benchStreamerJump(BenchState& state) {
+    LevelFile file;
+    file.open(benchLevelFile(state.arg));
+    LevelStreamer streamer;
+    streamer.start(&file);
+
+    std::vector<Platform> platforms;
+    std::vector<Collectible> coins;
+    std::vector<Enemy> enemies;
+    float cameraX = 0, far = file.width() / 2;
+    long initialSyncLoads = streamer.getStats().syncLoads;
+
+    while (state.keepRunning()) {
+        streamer.update(cameraX, 0, platforms, coins, enemies);
+        cameraX = far - cameraX;
+
+        state.pauseTiming();
+        streamer.waitIdle();
+        state.resumeTiming();
+    }
+
+    const StreamStats& stats = streamer.getStats();
+    state.setCounter("worst_sync_us", stats.worstSyncMs * 1e3);
+    state.setCounter("sync_loads", stats.syncLoads - initialSyncLoads);
+}
+BENCH_ARGS("LevelStreamer::update/jump", benchStreamerJump, 100000, 1000000);
@@ -0,0 +1,184 @@
+// Benchmark runner: calibrates each case, prints a table, writes JSON and compares
+// against a stored baseline.
+//
+// Usage: pixel_bench [--filter SUBSTR] [--min-time SEC] [--reps N] [--json PATH]
+//                    [--baseline PATH] [--threshold FRACTION]
+
+#include "bench.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+std::vector<BenchCase>& benchRegistry() {
+    static std::vector<BenchCase> registry;
+    return registry;
+}
+
+struct BenchResult {
+    std::string name;
+    long iterations;
+    double nsPerOp;
+    std::map<std::string, double> counters;
+};
+
+static std::string caseName(const BenchCase& c, int arg, bool hasArg) {
+    if (!hasArg) return c.name;
+    return c.name + "/" + std::to_string(arg);
+}
+
+static BenchResult runCase(const BenchCase& c, int arg, const std::string& name, double minTime,
+                           int reps) {
+    // Grow the iteration count until one run takes at least minTime
+    long iters = 1;
+    while (true) {
+        BenchState state(iters, arg);
+        c.fn(state);
+        if (state.elapsed() >= minTime || iters >= 1000000000L) break;
+
+        long next = iters * 10;
+        if (state.elapsed() > 0) {
+            next = (long)(iters * (minTime * 1.4 / state.elapsed()));
+            if (next > iters * 10) next = iters * 10;
+        }
+        iters = next > iters ? next : iters + 1;
+    }
+
+    // Best of several repetitions at the calibrated count
+    BenchResult result;
+    result.name = name;
+    result.iterations = iters;
+    result.nsPerOp = -1;
+    for (int r = 0; r < reps; r++) {
+        BenchState state(iters, arg);
+        c.fn(state);
+        double ns = state.elapsed() * 1e9 / iters;
+        if (result.nsPerOp < 0 || ns < result.nsPerOp) {
+            result.nsPerOp = ns;
+            result.counters = state.counters;
+        }
+    }
+    return result;
+}
+
+// ─────────────────────────────────────────
+// JSON output / baseline
+// ─────────────────────────────────────────
+
+// One benchmark object per line, so the baseline can be read back without a JSON library
+static void writeJson(const std::string& path, const std::vector<BenchResult>& results) {
+    std::ofstream out(path.c_str());
+    if (!out) {
+        fprintf(stderr, "Failed to write %s\n", path.c_str());
+        return;
+    }
+    out << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        char buf[128];
+        snprintf(buf, sizeof(buf), "%.2f", r.nsPerOp);
+        out << "    {\"name\": \"" << r.name << "\", \"iterations\": " << r.iterations
+            << ", \"ns_per_op\": " << buf;
+        for (const auto& counter : r.counters) {
+            snprintf(buf, sizeof(buf), "%.2f", counter.second);
+            out << ", \"" << counter.first << "\": " << buf;
+        }
+        out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+static std::map<std::string, double> readBaseline(const std::string& path) {
+    std::map<std::string, double> baseline;
+    std::ifstream in(path.c_str());
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t namePos = line.find("\"name\": \"");
+        size_t nsPos = line.find("\"ns_per_op\": ");
+        if (namePos == std::string::npos || nsPos == std::string::npos) continue;
+
+        namePos += strlen("\"name\": \"");
+        size_t nameEnd = line.find('"', namePos);
+        std::string name = line.substr(namePos, nameEnd - namePos);
+        baseline[name] = atof(line.c_str() + nsPos + strlen("\"ns_per_op\": "));
+    }
+    return baseline;
+}
+
+int main(int argc, char** argv) {
+    std::string filter, jsonPath, baselinePath;
+    double minTime = 0.1;
+    double threshold = 0.25;
+    int reps = 3;
+
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (a == "--filter" && hasValue)
+            filter = argv[++i];
+        else if (a == "--min-time" && hasValue)
+            minTime = atof(argv[++i]);
+        else if (a == "--reps" && hasValue)
+            reps = atoi(argv[++i]);
+        else if (a == "--json" && hasValue)
+            jsonPath = argv[++i];
+        else if (a == "--baseline" && hasValue)
+            baselinePath = argv[++i];
+        else if (a == "--threshold" && hasValue)
+            threshold = atof(argv[++i]);
+        else {
+            fprintf(stderr, "Unknown argument: %s\n", a.c_str());
+            return 2;
+        }
+    }
+
+    std::map<std::string, double> baseline;
+    if (!baselinePath.empty()) baseline = readBaseline(baselinePath);
+
+    printf("%-44s %12s %14s %10s\n", "benchmark", "iterations", "ns/op", "vs base");
+    printf("%s\n", std::string(84, '-').c_str());
+
+    std::vector<BenchResult> results;
+    int regressions = 0;
+    for (const BenchCase& c : benchRegistry()) {
+        std::vector<int> args = c.args;
+        bool hasArg = !args.empty();
+        if (!hasArg) args.push_back(0);
+
+        for (int arg : args) {
+            std::string name = caseName(c, arg, hasArg);
+            if (!filter.empty() && name.find(filter) == std::string::npos) continue;
+
+            BenchResult r = runCase(c, arg, name, minTime, reps);
+            results.push_back(r);
+
+            std::string verdict;
+            auto base = baseline.find(name);
+            if (base != baseline.end() && base->second > 0) {
+                double delta = r.nsPerOp / base->second - 1.0;
+                char buf[32];
+                snprintf(buf, sizeof(buf), "%+.1f%%", delta * 100);
+                verdict = buf;
+                if (delta > threshold) {
+                    verdict += "  REGRESSION";
+                    regressions++;
+                }
+            } else if (!baseline.empty()) {
+                verdict = "new";
+            }
+
+            printf("%-44s %12ld %14.1f %10s\n", name.c_str(), r.iterations, r.nsPerOp,
+                   verdict.c_str());
+            fflush(stdout);
+        }
+    }
+
+    if (!jsonPath.empty()) writeJson(jsonPath, results);
+
+    if (regressions > 0) {
+        printf("\n%d benchmark(s) regressed by more than %.0f%% against %s\n", regressions,
+               threshold * 100, baselinePath.c_str());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,299 @@
+#define GL_GLEXT_PROTOTYPES
+#include "gl_sink.h"
+#include <GL/glut.h>
+#include <cstring>
+#include <vector>
+
+GLSinkStats glSink = {0, 0, 0, 0, 0};
+
+// Font handles referenced through GLUT_BITMAP_* macros
+void* glutBitmap9By15 = nullptr;
+void* glutBitmapHelvetica12 = nullptr;
+void* glutBitmapHelvetica18 = nullptr;
+
+// ─────────────────────────────────────────
+// Primitives
+// ─────────────────────────────────────────
+
+void glBegin(GLenum mode) {
+    glSink.primitives++;
+}
+
+void glEnd() {}
+
+void glVertex2f(GLfloat x, GLfloat y) {
+    glSink.vertices++;
+}
+
+void glVertex2i(GLint x, GLint y) {
+    glSink.vertices++;
+}
+
+void glTexCoord2f(GLfloat s, GLfloat t) {}
+
+void glRasterPos2f(GLfloat x, GLfloat y) {}
+
+void glutBitmapCharacter(void* font, int character) {}
+
+void glBitmap(GLsizei width, GLsizei height, GLfloat xorig, GLfloat yorig, GLfloat xmove,
+              GLfloat ymove, const GLubyte* bitmap) {}
+
+// Core profile: one primitive per draw call, counting indices or corners as vertices
+void glDrawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices,
+                              GLint baseVertex) {
+    glSink.primitives++;
+    glSink.vertices += count;
+}
+
+void glDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount) {
+    glSink.primitives++;
+    glSink.vertices += (long)count * instanceCount;
+}
+
+// Display lists: compiling one counts what goes into it, calling one is a primitive
+static GLuint lists = 0;
+
+GLuint glGenLists(GLsizei range) {
+    GLuint first = lists + 1;
+    lists += range;
+    return first;
+}
+
+void glNewList(GLuint list, GLenum mode) {}
+
+void glEndList() {}
+
+void glCallList(GLuint list) {
+    glSink.primitives++;
+}
+
+void glDeleteLists(GLuint list, GLsizei range) {}
+
+// ─────────────────────────────────────────
+// State
+// ─────────────────────────────────────────
+
+void glColor3f(GLfloat r, GLfloat g, GLfloat b) {
+    glSink.stateChanges++;
+}
+
+void glColor4f(GLfloat r, GLfloat g, GLfloat b, GLfloat a) {
+    glSink.stateChanges++;
+}
+
+void glColor4ub(GLubyte r, GLubyte g, GLubyte b, GLubyte a) {
+    glSink.stateChanges++;
+}
+
+void glPointSize(GLfloat size) {
+    glSink.stateChanges++;
+}
+
+void glEnable(GLenum cap) {
+    glSink.stateChanges++;
+}
+
+void glDisable(GLenum cap) {
+    glSink.stateChanges++;
+}
+
+void glTranslatef(GLfloat x, GLfloat y, GLfloat z) {
+    glSink.stateChanges++;
+}
+
+void glPushMatrix() {}
+
+void glPopMatrix() {}
+
+void glPushAttrib(GLbitfield mask) {}
+
+void glPopAttrib() {}
+
+void glBlendFunc(GLenum sfactor, GLenum dfactor) {}
+void glLineWidth(GLfloat width) {}
+void glHint(GLenum target, GLenum mode) {}
+void glClear(GLbitfield mask) {}
+void glMatrixMode(GLenum mode) {}
+void glLoadIdentity() {}
+void glOrtho(GLdouble left, GLdouble right, GLdouble bottom, GLdouble top, GLdouble zNear,
+             GLdouble zFar) {}
+
+// ─────────────────────────────────────────
+// Textures
+// ─────────────────────────────────────────
+
+static GLuint nextTextureID = 1;
+
+void glGenTextures(GLsizei n, GLuint* textures) {
+    for (GLsizei i = 0; i < n; i++) textures[i] = nextTextureID++;
+}
+
+void glDeleteTextures(GLsizei n, const GLuint* textures) {}
+
+void glBindTexture(GLenum target, GLuint texture) {
+    glSink.stateChanges++;
+}
+
+void glTexParameteri(GLenum target, GLenum pname, GLint param) {}
+
+// Copy the pixels as a driver would, so the source's page faults and reads are counted
+static void copyTexels(GLsizei width, GLsizei height, GLenum format, const GLvoid* pixels) {
+    static std::vector<unsigned char> texture;
+    glSink.textureUploads++;
+    size_t bytes = (size_t)width * height * (format == GL_RGBA ? 4 : 1);
+    glSink.textureBytes += bytes;
+    if (pixels) {
+        texture.resize(bytes);
+        memcpy(texture.data(), pixels, bytes);
+    }
+}
+
+void glTexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height,
+                  GLint border, GLenum format, GLenum type, const GLvoid* pixels) {
+    copyTexels(width, height, format, pixels);
+}
+
+void glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width,
+                     GLsizei height, GLenum format, GLenum type, const GLvoid* pixels) {
+    copyTexels(width, height, format, pixels);
+}
+
+void glPixelStorei(GLenum pname, GLint param) {}
+
+void glActiveTexture(GLenum texture) {
+    glSink.stateChanges++;
+}
+
+// ─────────────────────────────────────────
+// Shaders (sprite palette lookup); every compile and link succeeds
+// ─────────────────────────────────────────
+
+static GLuint nextShaderID = 1;
+
+GLuint glCreateShader(GLenum type) {
+    return nextShaderID++;
+}
+
+void glShaderSource(GLuint shader, GLsizei count, const GLchar* const* string,
+                    const GLint* length) {}
+void glCompileShader(GLuint shader) {}
+void glDeleteShader(GLuint shader) {}
+
+void glGetShaderiv(GLuint shader, GLenum pname, GLint* params) {
+    *params = GL_TRUE;
+}
+
+void glGetShaderInfoLog(GLuint shader, GLsizei maxLength, GLsizei* length, GLchar* infoLog) {}
+
+GLuint glCreateProgram() {
+    return nextShaderID++;
+}
+
+void glAttachShader(GLuint program, GLuint shader) {}
+void glLinkProgram(GLuint program) {}
+void glDeleteProgram(GLuint program) {}
+
+void glGetProgramiv(GLuint program, GLenum pname, GLint* params) {
+    *params = GL_TRUE;
+}
+
+void glUseProgram(GLuint program) {
+    glSink.stateChanges++;
+}
+
+GLint glGetUniformLocation(GLuint program, const GLchar* name) {
+    return 0;
+}
+
+void glUniform1i(GLint location, GLint v0) {
+    glSink.stateChanges++;
+}
+
+void glUniform1f(GLint location, GLfloat v0) {
+    glSink.stateChanges++;
+}
+
+void glUniform2f(GLint location, GLfloat v0, GLfloat v1) {
+    glSink.stateChanges++;
+}
+
+GLuint glGetUniformBlockIndex(GLuint program, const GLchar* name) {
+    return 0;
+}
+
+void glUniformBlockBinding(GLuint program, GLuint blockIndex, GLuint binding) {}
+
+// ─────────────────────────────────────────
+// Vertex arrays (core profile backend)
+// ─────────────────────────────────────────
+
+void glGenVertexArrays(GLsizei n, GLuint* arrays) {
+    for (GLsizei i = 0; i < n; i++) arrays[i] = 1;
+}
+
+void glDeleteVertexArrays(GLsizei n, const GLuint* arrays) {}
+
+void glBindVertexArray(GLuint array) {
+    glSink.stateChanges++;
+}
+
+void glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized,
+                           GLsizei stride, const void* pointer) {}
+void glEnableVertexAttribArray(GLuint index) {}
+void glVertexAttribDivisor(GLuint index, GLuint divisor) {}
+
+// ─────────────────────────────────────────
+// Read-back (frame capture)
+// ─────────────────────────────────────────
+
+// 2.1 by default, so capture takes the pixel buffer path and sprites the palette shader
+const char* glSinkVersion = "2.1 gl_sink";
+
+const GLubyte* glGetString(GLenum name) {
+    return (const GLubyte*)(name == GL_VERSION ? glSinkVersion : "");
+}
+
+void glGetFloatv(GLenum, GLfloat* params) {
+    params[0] = params[1] = 64.0f;  // GL_POINT_SIZE_RANGE, the only query
+}
+
+static std::vector<std::vector<unsigned char>> buffers(1);  // Indexed by buffer name
+static GLuint boundPackBuffer = 0;
+
+void glGenBuffers(GLsizei n, GLuint* names) {
+    for (GLsizei i = 0; i < n; i++) {
+        names[i] = buffers.size();
+        buffers.emplace_back();
+    }
+}
+
+void glDeleteBuffers(GLsizei n, const GLuint* names) {}
+
+void glBindBuffer(GLenum target, GLuint buffer) {
+    if (target == GL_PIXEL_PACK_BUFFER) boundPackBuffer = buffer;
+}
+
+void glBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) {
+    if (target == GL_PIXEL_PACK_BUFFER) buffers[boundPackBuffer].resize(size);
+}
+
+void* glMapBuffer(GLenum target, GLenum access) {
+    return buffers[boundPackBuffer].data();
+}
+
+// Vertex data is copied into scratch, as into a mapped buffer
+void* glMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+    static std::vector<unsigned char> scratch;
+    scratch.resize(length);
+    return scratch.data();
+}
+
+void glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) {}
+void glBindBufferBase(GLenum target, GLuint index, GLuint buffer) {}
+
+GLboolean glUnmapBuffer(GLenum target) {
+    return GL_TRUE;
+}
+
+void glReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type,
+                  GLvoid* pixels) {}
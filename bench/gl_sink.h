@@ -0,0 +1,20 @@
+#ifndef GL_SINK_H
+#define GL_SINK_H
+
+// Counting stand-in for libGL/libglut so rendering code can be benchmarked headless.
+// Every immediate-mode call lands here instead of a driver.
+struct GLSinkStats {
+    long vertices;
+    long primitives;     // glBegin/glEnd pairs
+    long stateChanges;   // glColor, glPointSize, glBindTexture, glEnable, ...
+    long textureUploads;
+    long textureBytes;   // Texels uploaded
+
+    void reset() { vertices = primitives = stateChanges = textureUploads = textureBytes = 0; }
+};
+
+extern GLSinkStats glSink;
+// What glGetString(GL_VERSION) reports; "3.3 gl_sink" lets the core profile backend start
+extern const char* glSinkVersion;
+
+#endif
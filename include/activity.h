@@ -0,0 +1,38 @@
+#ifndef ACTIVITY_H
+#define ACTIVITY_H
+
+#include "platform.h"
+#include "collectible.h"
+#include "enemy.h"
+#include <vector>
+
+// Extra distance beyond the camera / player region in which entities are kept awake
+const float ACTIVITY_MARGIN = 128.0f;
+
+// Finds the entities near the player so that only those are simulated. Each entity is
+// indexed by the X span it can ever occupy (patrol or movement range included); entities
+// outside the queried region sleep and catch up analytically when they wake.
+class ActivityIndex {
+   private:
+    struct Span {
+        float left, right;
+        int index;
+    };
+    std::vector<Span> spans;  // Sorted by left edge
+    float maxWidth;
+
+    void sortSpans();
+
+   public:
+    ActivityIndex();
+
+    void build(const std::vector<Platform>& platforms);
+    void build(const std::vector<Collectible>& collectibles);
+    void build(const std::vector<Enemy>& enemies);
+
+    // Indices of entities whose span overlaps [left, right], in ascending index order so
+    // that update order matches simulating every entity
+    void query(float left, float right, std::vector<int>& out) const;
+};
+
+#endif
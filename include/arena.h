@@ -0,0 +1,113 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <vector>
+
+// ─────────────────────────────────────────
+// Frame arena
+//
+// Bump allocator for temporaries that live no longer than the frame being drawn: polygon
+// points, scan-line edge tables, HUD text. display() resets it before drawing, which frees
+// everything at once; nothing is freed one by one. ArenaAllocator lets standard containers
+// allocate from it (FrameVector), and Scope hands a function's scratch back when it returns,
+// so a helper called many times a frame does not grow the arena.
+//
+// An allocation that does not fit goes to the heap instead and is freed at the reset; the
+// high-water mark and overflow count say whether FRAME_ARENA_BYTES is big enough. Unless
+// NDEBUG is defined, released memory is overwritten with 0xDD so anything still pointing
+// into it reads garbage rather than last frame's values.
+//
+// Not thread-safe: only the thread that draws uses it.
+// ─────────────────────────────────────────
+
+struct FrameArenaStats {
+    size_t capacity;
+    size_t highWater;  // Most bytes in use at once, overflow included
+    int overflows;     // Allocations that went to the heap
+};
+
+class FrameArena {
+   private:
+    char* block;
+    size_t capacity;
+    size_t used;
+    std::vector<void*> overflow;  // Heap blocks, freed at the reset
+    size_t overflowBytes;
+    FrameArenaStats stats;
+
+    void release(size_t toUsed, size_t toOverflow);
+
+   public:
+    // Position to rewind to
+    struct Mark {
+        size_t used;
+        size_t overflowCount;
+        size_t overflowBytes;
+    };
+
+    // Rewinds on destruction
+    class Scope {
+       private:
+        FrameArena& arena;
+        Mark mark;
+
+       public:
+        explicit Scope(FrameArena& arena) : arena(arena), mark(arena.getMark()) {}
+        ~Scope() { arena.rewind(mark); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    explicit FrameArena(size_t capacity);
+    ~FrameArena();
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // `align` must be a power of two
+    void* allocate(size_t bytes, size_t align = alignof(std::max_align_t));
+    // printf into the arena; the text lasts until the reset
+    const char* format(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+
+    // Free everything; call at the start of each frame
+    void reset();
+    Mark getMark() const { return Mark{used, overflow.size(), overflowBytes}; }
+    // Free everything allocated since `mark`
+    void rewind(const Mark& mark);
+
+    size_t getUsed() const { return used + overflowBytes; }
+    const FrameArenaStats& getStats() const { return stats; }
+};
+
+// The arena the renderer draws with
+extern FrameArena frameArena;
+
+// Minimal C++11 allocator over a FrameArena. deallocate() does nothing; a container that
+// grows leaves its old storage behind until the reset, so reserve when the size is known.
+template <class T>
+struct ArenaAllocator {
+    typedef T value_type;
+    FrameArena* arena;
+
+    ArenaAllocator(FrameArena& arena = frameArena) : arena(&arena) {}
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T*, size_t) {}
+};
+
+template <class T, class U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return a.arena == b.arena;
+}
+
+template <class T, class U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return a.arena != b.arena;
+}
+
+template <class T>
+using FrameVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef ASSETPACK_H
+#define ASSETPACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ─────────────────────────────────────────
+// Asset pack format (.pha)
+//
+//   AssetPackHeader
+//   AssetPackEntry[entryCount]
+//   Pixel blobs, each ASSET_PACK_ALIGN-byte aligned
+//
+// Images are stored decoded so a memory-mapped pack can be handed to glTexImage2D as is:
+// RGBA8, or in entries flagged ASSET_FLAG_INDEXED a palette of RGBA8 colours followed by
+// one 8-bit index per pixel (palette.h). Rows run bottom-up, the way GL wants them, in
+// entries flagged ASSET_FLAG_FLIPPED and top-down otherwise. Little-endian.
+//
+// Version 2 added indexed entries; version 1 packs still open.
+// ─────────────────────────────────────────
+
+const uint32_t ASSET_PACK_MAGIC = 0x50414850;  // "PHAP"
+const uint32_t ASSET_PACK_VERSION = 2;
+const uint64_t ASSET_PACK_ALIGN = 64;
+
+const uint32_t ASSET_FLAG_FLIPPED = 1;
+const uint32_t ASSET_FLAG_INDEXED = 2;
+
+struct AssetPackHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+};
+
+struct AssetPackEntry {
+    char name[32];  // NUL-terminated
+    uint32_t width, height;
+    uint32_t frameCount;  // Frames side by side in a sprite sheet
+    uint32_t flags;
+    uint64_t offset;      // Of the pixels, from the start of the file
+    uint64_t size;        // width * height * 4, or palette size * 4 + width * height
+};
+
+// Read-only view of a memory-mapped asset pack. Opening validates the header and the table
+// of contents; pixels are paged in as they are read.
+class AssetPack {
+   private:
+    void* data;
+    size_t size;
+    const AssetPackHeader* header;
+    const AssetPackEntry* entries;
+
+    AssetPack(const AssetPack&);
+    AssetPack& operator=(const AssetPack&);
+
+   public:
+    AssetPack();
+    ~AssetPack();
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return data != nullptr; }
+
+    size_t entryCount() const { return header ? header->entryCount : 0; }
+    const AssetPackEntry& entry(size_t i) const { return entries[i]; }
+    const AssetPackEntry* find(const std::string& name) const;
+    const unsigned char* pixels(const AssetPackEntry& e) const {
+        return (const unsigned char*)data + e.offset;
+    }
+    // Of ASSET_FLAG_INDEXED entries, whose pixels() are the palette
+    int paletteSize(const AssetPackEntry& e) const {
+        return (int)((e.size - (uint64_t)e.width * e.height) / 4);
+    }
+    const unsigned char* indices(const AssetPackEntry& e) const {
+        return pixels(e) + paletteSize(e) * 4;
+    }
+};
+
+// An image to pack, rows top-down as decoded
+struct AssetPackImage {
+    std::string name;
+    int width, height;
+    int frameCount;
+    std::vector<unsigned char> rgba;
+};
+
+// Write a pack; `flip` stores rows bottom-up (ready for GL) instead of top-down, and
+// `indexed` stores images of up to 256 colours palette-indexed
+bool writeAssetPack(const std::string& path, const std::vector<AssetPackImage>& images,
+                    bool flip, bool indexed = true);
+
+#endif
@@ -0,0 +1,177 @@
+#ifndef BACKEND_H
+#define BACKEND_H
+
+#include <GL/gl.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ─────────────────────────────────────────
+// Render backends
+//
+// Everything the game draws goes through the active RenderBackend: graphics.cpp's
+// rasterizers, Renderer and TextureManager describe primitives immediate-mode style (begin,
+// vertex, end) and the backend decides how they reach GL.
+//
+//   FIXED_FUNCTION  glBegin/glEnd, glColor and the matrix stack, as the game always drew.
+//                   Works on any GL; sprites use a fragment-only palette shader on GL 2.0+.
+//   CORE            A 3.3 core profile context: primitives are batched into one vertex
+//                   array, streamed through an orphaned buffer and drawn with one shader
+//                   pair. Smooth points and lines become small quads with coverage computed
+//                   in the fragment shader, so the point-by-point DDA lines and scan-line
+//                   circle fills look as they did. The projection lives in a uniform buffer.
+//
+// Geometry that does not change can be retained: primitives described between
+// beginRetained() and endRetained() are stored in GL, as a display list or a static buffer,
+// and drawRetained() draws them again at an offset without describing them anew.
+//
+// The backend is picked once at startup, with a context of the right profile current, and
+// stays for the life of the process.
+// ─────────────────────────────────────────
+
+enum class RendererKind {
+    FIXED_FUNCTION,
+    CORE  // Needs a GL 3.3 core (or compatibility) context
+};
+
+enum class Primitive {
+    POINTS,  // Sized by pointSize(), smooth
+    LINES,   // Pairs of vertices, one pixel wide, smooth
+    QUADS    // Fours of vertices, counter-clockwise
+};
+
+// One sprite or disc of a set drawn with drawSprites() / drawDiscs()
+struct DrawInstance {
+    float x, y;  // Centre, in pixels
+    float scale;
+    float frame;        // Sprite sheet frame, wrapped to the sheet
+    uint8_t color[4];   // RGBA tint, multiplied with the texture
+};
+
+// What every sprite of a drawSprites() set shares
+struct InstanceSet {
+    float halfWidth, halfHeight;  // Of one frame at scale 1, in pixels
+    float frameWidth;             // Of one frame in texture coordinates
+    int frameCount;
+    float vBottom, vTop;
+};
+
+// Work done by the last complete frame
+struct RenderStats {
+    int drawCalls;  // glBegin/glEnd pairs and bitmaps, or glDrawArrays calls
+    long vertices;  // As submitted, before points and lines are expanded into quads
+    int bufferOrphans;
+};
+
+class RenderBackend {
+   protected:
+    struct Vertex {
+        float x, y, u, v;
+    };
+
+    std::vector<Vertex> vertices;  // Since begin()
+    Primitive primitive;
+    float u, v;
+    RenderStats stats, frameStats;
+
+    // Draw (or batch) what begin()..end() described
+    virtual void submit(Primitive primitive, const Vertex* vertices, size_t count) = 0;
+
+   public:
+    RenderBackend() : primitive(Primitive::POINTS), u(0), v(0), stats(), frameStats() {}
+    virtual ~RenderBackend() {}
+
+    virtual const char* getName() const = 0;
+    // Set up shaders and state; the context must be current. Returns false if the backend
+    // cannot run on it.
+    virtual bool init() = 0;
+    // Clear and start a `width` x `height` frame in pixels, origin bottom-left
+    virtual void beginFrame(int width, int height) = 0;
+    // Submit anything still batched; call before reading or swapping the frame
+    virtual void endFrame() = 0;
+
+    // Move everything drawn from now on (camera shake)
+    virtual void translate(float x, float y) = 0;
+    virtual void color(float r, float g, float b, float a = 1.0f) = 0;
+    virtual void pointSize(float size) = 0;
+
+    // Whether palette-indexed textures can be drawn
+    virtual bool hasPaletteLookup() = 0;
+    // Whether index textures have to be GL_R8 (GL_LUMINANCE is gone from core profiles)
+    virtual bool isCoreProfile() const = 0;
+    // Texture the next primitives with texCoord()s into `texture`: RGBA, or palette indices
+    // looked up in `palette` (paletteSize colours wide) at row coordinate `paletteRow`
+    virtual void bindTexture(GLuint texture, GLuint palette = 0, int paletteSize = 0,
+                             float paletteRow = 0.0f) = 0;
+    virtual void unbindTexture() = 0;
+
+    // GLUT bitmap font text starting at (x, y), like glRasterPos + glutBitmapCharacter, in
+    // the current colour
+    virtual void drawText(const char* text, float x, float y, void* font) = 0;
+
+    // Draw `count` frames of the bound texture in one call, each with its own position,
+    // scale, frame and tint
+    virtual void drawSprites(const InstanceSet& set, const DrawInstance* instances,
+                             size_t count) = 0;
+    // Draw `count` filled circles of `radius` pixels times their scale in one call, as
+    // drawCircleMidpoint draws them. Frames are ignored.
+    virtual void drawDiscs(int radius, const DrawInstance* instances, size_t count) = 0;
+
+    // Store the primitives begin()..end() describe from now on, and the colours and textures
+    // they use, instead of drawing them. No text, instanced sets or translate() meanwhile.
+    virtual void beginRetained() = 0;
+    // Finish what beginRetained() started; the handle is never 0
+    virtual GLuint endRetained() = 0;
+    // Draw retained geometry moved by (x, y). Textures are drawn by GL name, so the geometry
+    // is only good while they keep their names and sizes.
+    virtual void drawRetained(GLuint handle, float x, float y) = 0;
+    virtual void deleteRetained(GLuint handle) = 0;
+
+    void begin(Primitive p) {
+        primitive = p;
+        vertices.clear();
+    }
+    void texCoord(float s, float t) {
+        u = s;
+        v = t;
+    }
+    void vertex(float x, float y) { vertices.push_back(Vertex{x, y, u, v}); }
+    void end() { submit(primitive, vertices.data(), vertices.size()); }
+
+    const RenderStats& getStats() const { return stats; }
+};
+
+// The backend everything draws through; fixed function until selectRenderBackend() says
+// otherwise
+RenderBackend& renderBackend();
+// Switch to and initialise `kind`; the GL context it will draw into must be current.
+// Returns false, leaving the current backend, if it cannot run there.
+bool selectRenderBackend(RendererKind kind);
+
+// ─────────────────────────────────────────
+// GLUT bitmap fonts
+//
+// The fixed function backend draws text with glutBitmapCharacter. The core backend has no
+// glBitmap, and tools drawing through EGL have no glutInit, so both draw the same glyphs
+// from copies of the tables in vendor/glut_fonts.h.
+// ─────────────────────────────────────────
+
+struct BitmapFont {
+    int quantity;  // Characters in the table
+    int height;
+    // Per character: its width, then `height` rows of (width + 7) / 8 bytes, bottom row
+    // first, most significant bit leftmost
+    const unsigned char* glyphs;
+    const unsigned short* offsets;  // Of each character in `glyphs`
+    float xorig, yorig;
+
+    const unsigned char* glyph(int c) const { return glyphs + offsets[c]; }
+};
+
+// The table behind a GLUT_BITMAP_* handle, null for fonts the game does not use
+const BitmapFont* bitmapFont(void* glutFont);
+// Whether the fixed function backend may call glutBitmapCharacter (the default); tools
+// without glutInit turn it off to have the tables drawn with glBitmap
+void setGlutText(bool enabled);
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef BOT_H
+#define BOT_H
+
+#include "game.h"
+#include "reachability.h"
+#include <string>
+#include <vector>
+
+// ─────────────────────────────────────────
+// Autoplay
+//
+// Plays the game through the same key handlers as a person would. Routes are planned on
+// the reachability graph: a breadth-first search from the node the player is on finds the
+// fewest hops to a top from which an uncollected coin is comfortably in reach. Each hop is
+// flown as a maneuver picked by simulating candidates with the game's own player physics
+// and collision (Player::update, sweepPlayer), against platform and enemy positions at
+// the ticks they will be at, so what the bot predicts is what the game does. Maneuvers that
+// touch an enemy other than by stomping it are rejected.
+// ─────────────────────────────────────────
+
+// What a simulated maneuver has to do to pass
+enum class SimGoal {
+    HOP,     // Reach the hop's node (or collect the coin and come down) without getting hurt
+    WALK,    // Stay on the ground, unhurt
+    SURVIVE  // Stay unhurt, on the ground or not
+};
+
+// Inputs for one hop: hold a direction, steering onto the goal once above it, and jump
+// after `firstJump` steps and again `secondJump` steps later (-1 for no jump)
+struct Maneuver {
+    int direction;
+    int firstJump, secondJump;
+    int steps;  // Updates until the goal is reached
+};
+
+class Bot {
+   private:
+    int slot;  // Player driven: 0 (Game::getPlayer) or 1 (the partner)
+    ReachabilityGraph graph;
+    JobSystem jobs;  // Graph builds run on the calling thread
+    const Platform* builtFor;
+    size_t builtCount;
+    std::vector<std::vector<int>> nodeCoins;  // Coins comfortably in reach of each top
+    ActivityIndex enemyIndex;
+
+    // Plan
+    int fromNode;    // Node the route starts at
+    int hopNode;     // Next node on the route, -1 to go for the coin directly
+    int targetCoin;  // -1 if nothing is reachable
+    int planTick;    // Game tick when targetCoin was chosen
+    int hopTick;     // Game tick when hopNode was chosen
+    int idleUntil;   // Nothing in reach: tick of the next search
+    int lastTick, lastLives;
+    std::vector<int> skipUntil;  // Per coin, tick before which it is not targeted
+    struct BannedHop {
+        int from, to, until;
+    };
+    std::vector<BannedHop> bannedHops;  // Graph edges that could not be flown
+    std::vector<int> parent, queue;
+
+    // Maneuver being flown
+    bool flying;
+    Maneuver maneuver;
+    int maneuverStep;
+    int heldDirection;  // Key held down: -1 'a', 1 'd', 0 none
+
+    // Simulation scratch
+    std::vector<int> localPlatforms, localEnemies, reachScratch;
+    std::vector<char> stomped;
+
+    Player& self(Game& game) const { return slot == 0 ? game.getPlayer() : game.getPartner(); }
+    void buildGraph(Game& game);
+    int currentNode(Game& game) const;
+    bool banned(int from, int to, int tick) const;
+    void plan(Game& game, int node);
+    bool reached(Game& game, const Player& player, int tick, bool collected) const;
+    int input(Game& game, const Maneuver& m, int step, const Player& player, int tick,
+              bool& jump) const;
+    int simulate(Game& game, const Maneuver& m, int maxSteps, SimGoal goal);
+    void gatherNearby(Game& game);
+    bool findManeuver(Game& game);
+    bool evade(Game& game);
+    void hold(Game& game, int direction);
+
+   public:
+    explicit Bot(int playerSlot = 0);
+
+    // Press and release keys for the next Game::update(). Starts the game from the menu and
+    // restarts it after a win or game over. Keyboard play is player 0 only.
+    void act(Game& game);
+    // Controls for the next update while PLAYING, for Game::applyInput or a network session
+    InputBits decide(Game& game);
+    int getTargetCoin() const { return targetCoin; }
+};
+
+// ─────────────────────────────────────────
+// Physics checks
+//
+// Looks at the player after every update for states the collision solver should never
+// produce. Respawns and level restarts are not checked across.
+// ─────────────────────────────────────────
+
+struct Anomaly {
+    int tick;
+    std::string kind;
+    float x, y;
+};
+
+class PhysicsMonitor {
+   private:
+    ActivityIndex index;
+    const Platform* builtFor;
+    size_t builtCount;
+    std::vector<int> nearby;
+
+    bool tracking;  // Previous state is comparable with the current one
+    Box lastBox;
+    int lastTick, lastLives;
+
+   public:
+    PhysicsMonitor();
+
+    // Check the state the last Game::update() left; anomalies are appended to `out`
+    void check(Game& game, std::vector<Anomaly>& out);
+};
+
+#endif
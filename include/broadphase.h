@@ -0,0 +1,43 @@
+#ifndef BROADPHASE_H
+#define BROADPHASE_H
+
+#include "ecs.h"
+#include <vector>
+
+// Sweep-and-prune along X for trigger volumes (coins, enemies). Proxies are kept sorted
+// by their left edge; the world scrolls horizontally, so an overlap query is a binary
+// search plus a short scan over the entities actually near the query. Moving a proxy
+// re-sorts it incrementally by swapping it past its neighbours, which costs almost nothing
+// for entities that move a few pixels per tick.
+class SweepAndPrune {
+   private:
+    struct Proxy {
+        float minX, maxX;
+        Entity entity;  // Invalid once removed, until the next flush
+    };
+    std::vector<Proxy> proxies;   // Sorted by minX
+    std::vector<Proxy> added;     // Inserted since the last flush
+    std::vector<uint32_t> slots;  // Entity index -> proxy slot, or NO_ENTITY
+    size_t removed;
+    float maxWidth;   // Of any proxy; recomputed at the next flush once stale
+    bool widthStale;  // The widest proxy was removed
+
+    void flush();
+    void setSlot(Entity e, uint32_t slot);
+    bool contains(Entity e) const;
+
+   public:
+    SweepAndPrune();
+
+    void insert(Entity e, float minX, float maxX);
+    void remove(Entity e);
+    // Update a proxy's extent and restore the ordering around it
+    void move(Entity e, float minX, float maxX);
+    void clear();
+    size_t size() const { return proxies.size() + added.size() - removed; }
+
+    // Entities whose extent overlaps [minX, maxX], in ascending minX order
+    void query(float minX, float maxX, std::vector<Entity>& out);
+};
+
+#endif
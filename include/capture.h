@@ -0,0 +1,95 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <GL/glut.h>
+#include "jobs.h"
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// ─────────────────────────────────────────
+// Frame capture
+//
+// Records what the window shows for QA. Each frame is read back into one of a ring of pixel
+// buffer objects; the driver copies it out while the game carries on, and the game only maps
+// the buffer RING - 1 frames later, when the copy is long done. Encoding (PNG through
+// stb_image_write, or raw YUV 4:2:0 into a Y4M video) runs on capture's own worker threads.
+// When the encoders fall MAX_PENDING frames behind, new frames are dropped rather than
+// stalling the game; the count is reported at the end.
+//
+// Without pixel buffer objects (GL < 2.1) frames are read back synchronously instead.
+// ─────────────────────────────────────────
+
+enum class CaptureFormat {
+    PNG,  // One file per frame, DIR/frame_NNNNNN.png
+    Y4M   // One YUV4MPEG2 video
+};
+
+struct CaptureStats {
+    int frames;      // Handed to encoders
+    int dropped;     // Encoders were too far behind
+    int written;
+    double gameMs;   // Total time spent in captureFrame()
+    double maxGameMs;
+};
+
+class FrameCapture {
+   private:
+    static const int RING = 3;
+    static const int MAX_PENDING = 16;
+
+    struct Frame {
+        int number;    // In capture order, counting dropped frames (PNG file names)
+        int sequence;  // Among frames handed to encoders (Y4M order)
+        std::vector<uint8_t> rgba;  // Bottom-up, as GL reads it
+        std::vector<uint8_t> yuv;
+    };
+
+    CaptureFormat format;
+    std::string path;
+    int width, height, fps;
+    bool active;
+    bool usePbo;
+    GLuint pbos[RING];
+    int ringFrame[RING];  // Frame number read into each buffer, -1 if none
+    int frameNumber;
+    FILE* video;
+
+    JobSystem encoders;
+    JobCounter encoding;
+    std::mutex mutex;  // Guards everything below
+    std::vector<std::unique_ptr<Frame>> frames;
+    std::vector<Frame*> idle;
+    std::map<int, Frame*> finished;  // Encoded, waiting for earlier frames to be written
+    int nextSequence, nextToWrite;
+    CaptureStats stats;
+
+    Frame* takeFrame();
+    void dispatch(Frame* frame);
+    void encode(Frame* frame);
+    void collect(int slot);
+
+   public:
+    FrameCapture();
+    ~FrameCapture();
+
+    // Start capturing the `width` x `height` window into `path` (a .y4m file, or a directory
+    // for PNGs, created if missing) with `workers` encoder threads.
+    bool start(const std::string& path, CaptureFormat format, int width, int height, int fps,
+               int workers);
+    // Read the back buffer; call after drawing a frame, before swapping buffers
+    void captureFrame();
+    // Collect the frames still in flight, wait for the encoders and close the output
+    void stop();
+    // Block until every frame handed to the encoders is written
+    void waitIdle();
+
+    bool isActive() const { return active; }
+    const CaptureStats& getStats() const { return stats; }
+};
+
+#endif
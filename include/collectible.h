@@ -8,13 +8,15 @@
 class Collectible {
    public:
     float x, y;
-    float rotation;
-    float bobOffset;
     bool collected;
     Color color;
+    int phase;  // Animation offset in ticks
 
     Collectible(float px, float py);
-    void update();
+
+    // Animation is a pure function of game time (in ticks, fractional for interpolation)
+    float rotationAt(float tick) const { return COIN_ROTATION_SPEED * (tick + phase); }
+    float bobAt(float tick) const { return COIN_BOB_SPEED * (tick + phase); }
 };
 
 void initializeCollectibles(std::vector<Collectible>& collectibles);
@@ -0,0 +1,58 @@
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include "player.h"
+#include "platform.h"
+#include <vector>
+
+// Axis-aligned box given by its edges
+struct Box {
+    float left, bottom, right, top;
+};
+
+// First contact of a moving box with a static one
+struct SweepHit {
+    float time;              // Fraction of the displacement travelled before contact, [0, 1]
+    float normalX, normalY;  // Normal of the surface that was hit, pointing at the mover
+};
+
+// Boxes closer than this count as touching, not overlapping, so a box resting on a surface
+// stays in contact with it despite rounding
+const float CONTACT_SKIN = 0.01f;
+
+// Swept AABB: find when `moving`, displaced by (dx, dy), first touches `target`. Only
+// reports contacts the displacement runs into; moving along or away from a touching
+// surface is free, and boxes that already overlap are left to the caller to separate.
+bool sweepBox(const Box& moving, float dx, float dy, const Box& target, SweepHit& hit);
+
+// True if the boxes overlap by more than CONTACT_SKIN on both axes
+bool overlaps(const Box& a, const Box& b);
+
+// ─────────────────────────────────────────
+// Player against platforms
+// ─────────────────────────────────────────
+
+Box playerBox(const Player& player);
+
+// Append the `candidates` whose movement range meets the player's box swept over its step
+// displacement (Player::moveX, moveY)
+void platformsInReach(const Player& player, const std::vector<Platform>& platforms,
+                      const std::vector<int>& candidates, std::vector<int>& out);
+
+// Where and how fast the player came down onto a platform top during a step
+struct Touchdown {
+    bool landed;
+    float x, y, vy;
+};
+
+// Continuous collision for one step from `fromTick` to `toTick` against the `nearby`
+// platforms. The player travels its step displacement until the earliest time of impact
+// with any platform, resolves that contact (landing, ceiling or wall) and slides along it
+// for the rest of the step. Moving platforms travel linearly between their positions at the
+// two ticks, and are swept in their own frame so a platform moving into the player pushes
+// it instead of passing through. Sets onGround and the wall slide state, and reports the
+// first touchdown.
+Touchdown sweepPlayer(Player& player, const std::vector<Platform>& platforms,
+                      const std::vector<int>& nearby, int fromTick, int toTick);
+
+#endif
@@ -5,6 +5,9 @@
 const int WINDOW_WIDTH = 1000;
 const int WINDOW_HEIGHT = 700;
 
+// Right bound of the built-in level
+const float DEFAULT_LEVEL_WIDTH = 3250.0f;
+
 // physics constants
 const float GRAVITY = 0.6f;
 const float JUMP_VELOCITY = 16.0f;
@@ -14,9 +17,33 @@ const float AIR_RESISTANCE = 0.98f;
 const float GROUND_FRICTION = 0.8f;
 const float ACCELERATION = 0.8f;
 const float MAX_FALL_SPEED = -20.0f;
+const float ENEMY_PATROL_SPEED = 1.5f;
+const float COIN_PICKUP_RADIUS = 25.0f;
+
+// Player collision box (centred on Player::x, y)
+const float PLAYER_HALF_WIDTH = 12.0f;
+const float PLAYER_HALF_HEIGHT = 18.0f;
+// The player loses a life below this height
+const float FALL_DEATH_Y = -100.0f;
+
+// Simulation rate. Velocities and the per-tick constants above are per base tick; running
+// at a lower tick rate advances several base ticks per update.
+const int BASE_TICK_RATE = 60;
+const float BASE_TICK_SECONDS = 0.016f;
+
+// Decoded sprites uploaded per frame while assets load
+const int SPRITE_UPLOADS_PER_FRAME = 4;
+
+// Frame arena (include/arena.h) size; a frame's temporaries take under 1 KiB today
+const int FRAME_ARENA_BYTES = 16 * 1024;
+
+// Static platforms are retained as geometry per this much level width (Renderer::drawPlatforms)
+const float PLATFORM_CHUNK_WIDTH = 512.0f;
 
 // Animation constants
 const float COIN_ROTATION_SPEED = 0.08f;
+const float COIN_BOB_SPEED = 0.1f;
+const float ENEMY_ANIMATION_SPEED = 0.1f;
 const float CLOUD_DRIFT_SPEED = 0.02f;
 const float PARTICLE_LIFE = 60.0f;
 
@@ -0,0 +1,163 @@
+#ifndef ECS_H
+#define ECS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ─────────────────────────────────────────
+// Entity-component storage
+//
+// Every component type lives in its own packed array. Systems walk the dense array of the
+// component they drive and look up the few others they need, so they only stream the data
+// they touch. Removal swaps the last element into the hole: O(1), and removed entities
+// leave every iteration set immediately.
+// ─────────────────────────────────────────
+
+const uint32_t NO_ENTITY = 0xFFFFFFFFu;
+
+// Generational handle: a stale handle (entity destroyed, slot reused) never resolves
+struct Entity {
+    uint32_t index;
+    uint32_t generation;
+
+    Entity(uint32_t i = NO_ENTITY, uint32_t g = 0) : index(i), generation(g) {}
+    bool valid() const { return index != NO_ENTITY; }
+    bool operator==(const Entity& o) const {
+        return index == o.index && generation == o.generation;
+    }
+    bool operator!=(const Entity& o) const { return !(*this == o); }
+};
+
+// Packed array of one component type, indexed sparsely by entity
+template <typename T>
+class ComponentArray {
+   private:
+    std::vector<T> dense;
+    std::vector<Entity> owners;    // Entity owning each dense slot
+    std::vector<uint32_t> sparse;  // Entity index -> dense slot, or NO_ENTITY
+
+   public:
+    size_t size() const { return dense.size(); }
+    T& operator[](size_t slot) { return dense[slot]; }
+    const T& operator[](size_t slot) const { return dense[slot]; }
+    Entity entity(size_t slot) const { return owners[slot]; }
+
+    bool has(Entity e) const {
+        return e.index < sparse.size() && sparse[e.index] != NO_ENTITY &&
+               owners[sparse[e.index]] == e;
+    }
+    T& get(Entity e) { return dense[sparse[e.index]]; }
+    const T& get(Entity e) const { return dense[sparse[e.index]]; }
+
+    void insert(Entity e, const T& component) {
+        if (e.index >= sparse.size()) sparse.resize(e.index + 1, NO_ENTITY);
+        if (has(e)) {
+            get(e) = component;
+            return;
+        }
+        sparse[e.index] = dense.size();
+        dense.push_back(component);
+        owners.push_back(e);
+    }
+
+    void remove(Entity e) {
+        if (!has(e)) return;
+        uint32_t slot = sparse[e.index];
+        uint32_t last = dense.size() - 1;
+        if (slot != last) {
+            dense[slot] = dense[last];
+            owners[slot] = owners[last];
+            sparse[owners[slot].index] = slot;
+        }
+        dense.pop_back();
+        owners.pop_back();
+        sparse[e.index] = NO_ENTITY;
+    }
+
+    void clear() {
+        dense.clear();
+        owners.clear();
+        sparse.clear();
+    }
+};
+
+// ─────────────────────────────────────────
+// Components
+// ─────────────────────────────────────────
+
+struct Transform {
+    float x, y;
+};
+
+struct Velocity {
+    float vx, vy;
+};
+
+// Axis-aligned box centred on the transform
+struct AABB {
+    float halfWidth, halfHeight;
+};
+
+struct Patrol {
+    float spawnX, left, right;
+    int phase;  // Offset in ticks
+};
+
+// Animation clock is (game tick + phase); each sprite kind maps it to frames
+struct Animation {
+    int phase;
+};
+
+enum class SpriteKind { COIN, ENEMY };
+
+struct Drawable {
+    SpriteKind kind;
+    float scale;
+};
+
+// Collected on contact. `record` is the Collectible's index in the level vectors.
+struct Pickup {
+    int record;
+    int value;
+};
+
+// Hurts on contact, dies when stomped. `record` is the Enemy's index in the level vectors.
+struct Hazard {
+    int record;
+    int stompValue;
+};
+
+// ─────────────────────────────────────────
+// Registry
+// ─────────────────────────────────────────
+
+class Registry {
+   private:
+    std::vector<uint32_t> generations;
+    std::vector<uint32_t> freeSlots;
+    size_t liveCount;
+
+   public:
+    ComponentArray<Transform> transforms;
+    ComponentArray<Velocity> velocities;
+    ComponentArray<AABB> boxes;
+    ComponentArray<Patrol> patrols;
+    ComponentArray<Animation> animations;
+    ComponentArray<Drawable> drawables;
+    ComponentArray<Pickup> pickups;
+    ComponentArray<Hazard> hazards;
+
+    Registry();
+
+    Entity create();
+    // Removes the entity from every component array; its handle goes stale
+    void destroy(Entity e);
+    bool alive(Entity e) const {
+        return e.index < generations.size() && generations[e.index] == e.generation;
+    }
+    size_t size() const { return liveCount; }
+    void clear();
+};
+
+#endif
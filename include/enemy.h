@@ -2,6 +2,7 @@
 #define ENEMY_H
 
 #include "types.h"
+#include "constants.h"
 #include <vector>
 
 enum class EnemyType {
@@ -18,14 +19,21 @@ class Enemy {
     Color color;
     bool alive;
     bool facingRight;
-    float animationTimer;
     EnemyType type;
+    float spawnX;
+    int phase;  // Patrol and animation offset in ticks
 
     Enemy(float px, float py, float left, float right, EnemyType t = EnemyType::PATROL);
-    void update();
+
+    float animationAt(float tick) const { return ENEMY_ANIMATION_SPEED * (tick + phase); }
+    // Move to the patrol pose at `tick` (x, vx, facingRight); dead enemies stay put
+    void advanceTo(int tick);
     void kill();
 };
 
+// Patrol position after `tick` ticks for an enemy spawned at spawnX walking [left, right]
+float patrolX(float spawnX, float left, float right, int tick, bool& facingRight);
+
 void initializeEnemies(std::vector<Enemy>& enemies);
 
 #endif
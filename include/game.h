@@ -7,14 +7,56 @@
 #include "particle.h"
 #include "renderer.h"
 #include "enemy.h"
+#include "levelgen.h"
+#include "levelfile.h"
+#include "streaming.h"
+#include "activity.h"
+#include "ecs.h"
+#include "systems.h"
+#include "collision.h"
+#include <cstdint>
+#include <string>
 #include <vector>
 
 // Game states
 enum class GameState { MENU, PLAYING, PAUSED, GAME_OVER, WIN };
 
+// Where resetLevel() takes the level layout from
+enum class LevelSource { BUILTIN, GENERATED, FILE };
+
+// One player's controls for one update (see Game::applyInput)
+typedef uint8_t InputBits;
+const InputBits INPUT_LEFT = 1;
+const InputBits INPUT_RIGHT = 2;
+const InputBits INPUT_JUMP = 4;  // Jump pressed this update, not held
+
+// A coin collected or an enemy killed, in the order they happened
+struct LevelChange {
+    bool coin;   // Else an enemy
+    int record;  // Index into the collectible or enemy vector
+};
+
+// Everything an update can change, so a session can step back and play ticks again.
+// Platform and enemy motion are functions of the tick; coins and enemies are restored by
+// undoing the level changes logged after `changeCount`. Particles are left alone.
+struct GameSnapshot {
+    Player player, partner;
+    float cameraX, cameraTargetX;
+    int score, lives;
+    float gameTimer;
+    int coinsCollected;
+    GameState state;
+    float stateTransitionTimer, damageFlashTimer, cameraShakeTimer, cameraShakeIntensity;
+    int simTick;
+    size_t changeCount;
+};
+
 class Game {
    private:
     Player player;
+    Player partner;   // Second player in co-op
+    bool twoPlayer;
+    bool replaying;   // Ticks being simulated again after a rollback: no effects
     std::vector<Platform> platforms;
     std::vector<Collectible> collectibles;
     std::vector<Enemy> enemies;
@@ -27,6 +69,7 @@ class Game {
     int lives;
     float gameTimer;
     int totalCoins;
+    int coinsCollected;
     bool keys[256];
     GameState state;
     float stateTransitionTimer;
@@ -34,12 +77,46 @@ class Game {
     float cameraShakeTimer;
     float cameraShakeIntensity;
 
-    bool checkCollision(float x, float y, float width, float height, const Platform& platform);
-    void checkCollectibleCollection();
-    void checkEnemyCollisions();
+    // Level source: built-in layout unless a generated or file level was requested
+    LevelSource levelSource;
+    LevelGenParams levelParams;
+    LevelFile levelFile;
+    std::string levelPath;   // Of levelFile
+    LevelStreamer streamer;  // Active for file levels of at least STREAM_MIN_WIDTH
+    float levelWidth;
+    int levelSerial;         // Bumped by every resetLevel()
+
+    // Game clock in ticks. Entity motion and animation are closed-form functions of it, so
+    // only entities near the camera and player (activity regions) are touched each tick.
+    int simTick;
+    int stepTicks;  // Base ticks per update (1 at BASE_TICK_RATE)
+    SpriteSource spriteSource;
+    ActivityIndex platformActivity, coinActivity, enemyActivity;
+    std::vector<int> activePlatforms, activeCoins, activeEnemies;
+    std::vector<int> wakeScratch, changeScratch;
+    std::vector<int> nearPlatforms;  // Platforms the player can reach this step
+
+    // Live coins and enemies inside the activity region. The level vectors stay the record
+    // of where things spawn and what has been collected or killed.
+    Registry registry;
+    JobSystem jobs;
+    std::vector<Entity> coinEntities, enemyEntities;  // Per level record, invalid if asleep
+    SweepAndPrune triggers;  // Coin and enemy volumes, for contact tests against the player
+    std::vector<Entity> contactScratch;
+    std::vector<SpriteInstance> coinSprites, enemySprites;
+    std::vector<LevelChange> changes;  // Since the level was reset
+
+    void updateActivity();
+    void respawnActive();
+    void despawn(Entity e);
+    void tryJump(Player& p);
+    void movePlayer(Player& p, int fromTick, bool wasOnGroundBefore);
+    void checkCollectibleCollection(Player& p);
+    void checkEnemyCollisions(Player& p);
+    void checkFall(Player& p);
     void updateCamera();
     void resetLevel();
-    void playerTakeDamage();
+    void playerTakeDamage(Player& p);
 
    public:
     Game();
@@ -53,8 +130,64 @@ class Game {
     void handleSpecialUp(int key);
     void processInput();
 
+    // Co-op: a second player shares lives, score and the camera, which frames both
+    void setTwoPlayer(bool enabled);
+    bool isTwoPlayer() const { return twoPlayer; }
+    // Controls for the next update, for player 0 (keyboard player) or 1 (partner). Replaces
+    // keyboard input for that player; used by network sessions.
+    void applyInput(int slot, InputBits input);
+
+    // Save and restore simulation state for rollback. Not supported on streamed levels,
+    // whose record vectors change as chunks load: both return false there and do nothing.
+    bool saveState(GameSnapshot& out) const;
+    bool loadState(const GameSnapshot& in);
+    // While set, updates emit no particles and do not step them
+    void setReplaying(bool enabled) { replaying = enabled; }
+
+    // Use a procedurally generated level from the next resetLevel() on
+    void setGeneratedLevel(const LevelGenParams& params);
+    // Use a .phl level file from the next resetLevel() on. Keeps the current source on failure.
+    bool setLevelFile(const std::string& path);
+    float getLevelWidth() const { return levelWidth; }
+    LevelSource getLevelSource() const { return levelSource; }
+    const LevelGenParams& getLevelParams() const { return levelParams; }
+    const std::string& getLevelPath() const { return levelPath; }
+    // Changes when the level is reset (start, restart), for observers that mirror it
+    int getLevelSerial() const { return levelSerial; }
+    // Coins collected and enemies killed since the level was reset, oldest first
+    const std::vector<LevelChange>& getChanges() const { return changes; }
+    // Worker threads for parallel update phases (0 runs everything on the calling thread)
+    void setWorkerThreads(int count) { jobs.setWorkerCount(count); }
+    // Updates per second. Each update advances BASE_TICK_RATE / hz base ticks, so rates that
+    // do not divide BASE_TICK_RATE round up to one that does.
+    void setTickRate(int hz);
+    int getTickRate() const { return BASE_TICK_RATE / stepTicks; }
+    const LevelStreamer& getStreamer() const { return streamer; }
+    // Where init() loads sprites from
+    void setSpriteSource(SpriteSource source) { spriteSource = source; }
+
+    static bool checkCollision(float x, float y, float width, float height,
+                               const Platform& platform);
+
+    // Re-index the level after editing the vectors below directly
+    void rebuildActivity();
+
+    // Direct level access for tools (benchmarks, level tooling)
+    std::vector<Platform>& getPlatforms() { return platforms; }
+    std::vector<Collectible>& getCollectibles() { return collectibles; }
+    std::vector<Enemy>& getEnemies() { return enemies; }
+    ParticleSystem& getParticleSystem() { return particleSystem; }
+    Renderer& getRenderer() { return renderer; }
+
     Player& getPlayer() { return player; }
+    Player& getPartner() { return partner; }
+    float getCameraX() const { return cameraX; }
     int getScore() const { return score; }
+    int getLives() const { return lives; }
+    int getCoinsCollected() const { return coinsCollected; }
+    int getTotalCoins() const { return totalCoins; }
+    float getGameTime() const { return gameTimer; }
+    int getTick() const { return simTick; }
     GameState getState() const { return state; }
 };
 
@@ -13,8 +13,13 @@ void drawCircleMidpoint(int centerX, int centerY, int radius, Color color, bool
 
 void drawCircleBresenham(int xc, int yc, int r, Color color, bool filled = false);
 // Fill algorithms
-void scanLineFill(std::vector<Point>& vertices, Color fillColor, Color gradientColor = Color(),
-                  bool useGradient = false);
+void scanLineFill(const Point* vertices, size_t count, Color fillColor,
+                  Color gradientColor = Color(), bool useGradient = false);
+template <class Alloc>
+void scanLineFill(const std::vector<Point, Alloc>& vertices, Color fillColor,
+                  Color gradientColor = Color(), bool useGradient = false) {
+    scanLineFill(vertices.data(), vertices.size(), fillColor, gradientColor, useGradient);
+}
 
 // Clipping
 int computeOutCode(float x, float y, float xmin, float ymin, float xmax, float ymax);
@@ -0,0 +1,81 @@
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+typedef std::function<void()> JobFunction;
+typedef std::function<void(size_t begin, size_t end)> RangeFunction;
+
+// Counts outstanding jobs. Submitting against a counter increments it, finishing a job
+// decrements it; JobSystem::wait() blocks (while helping) until it reaches zero. Phases
+// that depend on earlier work wait on that work's counter.
+class JobCounter {
+   private:
+    std::atomic<int> pending;
+    friend class JobSystem;
+
+   public:
+    JobCounter() : pending(0) {}
+    bool done() const { return pending.load(std::memory_order_acquire) == 0; }
+};
+
+// Work-stealing scheduler. Every worker owns a deque: it pushes and pops its own jobs at
+// the back and steals from the front of the others'. Threads that are not workers (the
+// game thread) submit into a shared queue and run jobs themselves while waiting, so with
+// zero workers everything still runs, inline, in submission order.
+class JobSystem {
+   private:
+    struct Job {
+        JobFunction fn;
+        JobCounter* counter;
+    };
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;  // [0] external submitters, [1..] workers
+    std::vector<std::thread> workers;
+    std::atomic<int> queued;
+    std::mutex sleepMutex;
+    std::condition_variable wake;      // Workers: a job was queued, or quit
+    std::condition_variable finished;  // wait(): a counter reached zero, or a job was queued
+    int waiters;                       // Threads asleep in wait() (guarded by sleepMutex)
+    bool quit;
+
+    void workerLoop(int queueIndex);
+    bool findJob(int queueIndex, Job& job);
+    void run(Job& job);
+    void stop();
+
+    JobSystem(const JobSystem&);
+    JobSystem& operator=(const JobSystem&);
+
+   public:
+    explicit JobSystem(int workerCount = 0);
+    ~JobSystem();
+
+    // Restart with a new number of worker threads (0 runs every job on the waiting thread).
+    // Jobs still queued are run on the calling thread first, so no counter is left pending.
+    void setWorkerCount(int workerCount);
+    int getWorkerCount() const { return workers.size(); }
+    // One worker per hardware thread besides the caller's
+    static int defaultWorkerCount();
+
+    void submit(const JobFunction& fn, JobCounter& counter);
+    // Split [0, count) into ranges of at most `grain` items, one job each. A range that
+    // fits in one grain runs immediately on the caller instead.
+    void parallelFor(size_t count, size_t grain, const RangeFunction& fn, JobCounter& counter);
+    // Run jobs until the counter reaches zero, sleeping while there are none to run
+    void wait(JobCounter& counter);
+};
+
+#endif
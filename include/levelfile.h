@@ -0,0 +1,122 @@
+#ifndef LEVELFILE_H
+#define LEVELFILE_H
+
+#include "platform.h"
+#include "collectible.h"
+#include "enemy.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ─────────────────────────────────────────
+// Binary level format (.phl)
+//
+//   LevelFileHeader
+//   LevelSection[sectionCount]
+//   packed record arrays, each 16-byte aligned
+//
+// Little-endian, native float layout. Records are plain PODs so a memory-mapped file can be
+// read in place. Writers sort every section by x (LEVEL_FLAG_SORTED_X).
+// ─────────────────────────────────────────
+
+const uint32_t LEVEL_FILE_MAGIC = 0x564C4850;  // "PHLV"
+const uint32_t LEVEL_FILE_VERSION = 1;
+
+const uint32_t LEVEL_FLAG_SORTED_X = 1;
+
+enum LevelSectionType : uint32_t {
+    LEVEL_SECTION_PLATFORMS = 1,
+    LEVEL_SECTION_COINS = 2,
+    LEVEL_SECTION_ENEMIES = 3,
+};
+
+struct LevelFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t sectionCount;
+    uint32_t flags;
+    float width, height;  // Level bounds
+    uint32_t reserved[2];
+};
+
+struct LevelSection {
+    uint32_t type;
+    uint32_t recordSize;
+    uint64_t offset;  // From start of file
+    uint64_t count;
+};
+
+const uint32_t PLATFORM_RECORD_MOVING = 1;
+
+struct PlatformRecord {
+    float x, y, width, height;
+    float r, g, b;
+    float moveSpeed, moveRange;
+    uint32_t flags;
+};
+
+struct CoinRecord {
+    float x, y;
+};
+
+struct EnemyRecord {
+    float x, y;
+    float patrolLeft, patrolRight;
+    uint32_t type;  // EnemyType
+    uint32_t reserved;
+};
+
+// Read-only view of a memory-mapped level file. Opening validates the header and section
+// table only; record arrays are paged in by the OS as they are touched.
+class LevelFile {
+   private:
+    void* data;
+    size_t size;
+    const LevelFileHeader* header;
+    const PlatformRecord* platformRecords;
+    const CoinRecord* coinRecords;
+    const EnemyRecord* enemyRecords;
+    size_t platformTotal, coinTotal, enemyTotal;
+
+    LevelFile(const LevelFile&);
+    LevelFile& operator=(const LevelFile&);
+
+   public:
+    LevelFile();
+    ~LevelFile();
+
+    // Closes whatever was open first, so a failed open leaves nothing open
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return data != nullptr; }
+    void swap(LevelFile& other);
+
+    float width() const { return header->width; }
+    float height() const { return header->height; }
+    bool sortedByX() const { return (header->flags & LEVEL_FLAG_SORTED_X) != 0; }
+
+    const PlatformRecord* platforms() const { return platformRecords; }
+    const CoinRecord* coins() const { return coinRecords; }
+    const EnemyRecord* enemies() const { return enemyRecords; }
+    size_t platformCount() const { return platformTotal; }
+    size_t coinCount() const { return coinTotal; }
+    size_t enemyCount() const { return enemyTotal; }
+
+    // Build live game objects from the records
+    void instantiate(std::vector<Platform>& platforms, std::vector<Collectible>& collectibles,
+                     std::vector<Enemy>& enemies) const;
+};
+
+// Record conversion, shared by the loader and the writer
+Platform platformFromRecord(const PlatformRecord& r);
+Collectible coinFromRecord(const CoinRecord& r);
+Enemy enemyFromRecord(const EnemyRecord& r);
+
+// Write a level file. Records are sorted by x before writing.
+bool writeLevelFile(const std::string& path, float width, float height,
+                    const std::vector<Platform>& platforms,
+                    const std::vector<Collectible>& collectibles,
+                    const std::vector<Enemy>& enemies);
+
+#endif
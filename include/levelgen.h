@@ -0,0 +1,45 @@
+#ifndef LEVELGEN_H
+#define LEVELGEN_H
+
+#include "platform.h"
+#include "collectible.h"
+#include "enemy.h"
+#include <vector>
+
+// Parameters for a procedurally generated level. The same seed and parameters always
+// produce the same level.
+struct LevelGenParams {
+    unsigned int seed;
+    int platformCount;       // Total platforms, including bonus platforms
+    float coinChance;        // Chance of a coin above each platform
+    float enemyChance;       // Chance of a patrol enemy on each wide, static platform
+    float movingChance;      // Chance a floating path platform moves
+    float bonusChance;       // Chance of a double-jump bonus platform above a path platform
+
+    LevelGenParams(unsigned int s = 1, int count = 1000)
+        : seed(s),
+          platformCount(count),
+          coinChance(0.6f),
+          enemyChance(0.3f),
+          movingChance(0.15f),
+          bonusChance(0.35f) {}
+};
+
+// Horizontal distance a full-speed single jump covers before the player's feet drop below
+// `rise` (relative to take-off height) on the way down. Derived by stepping the same
+// integration as Player::update with JUMP_VELOCITY / GRAVITY. Returns 0 if unreachable.
+float jumpReach(float rise);
+
+// Peak height of a single jump
+float jumpApex();
+
+// Generate a level into the given vectors and return its width. Every path platform is
+// reachable from the previous one with a single jump; bonus platforms need a double jump
+// from the path platform below. Positions are laid out in double and each gap is kept
+// within its bounds as stored, so that holds however long the level. The game itself still
+// simulates in float: past a few million pixels positions are whole pixels apart (16 px by
+// 2e8), so very long levels are meant for scale tests rather than play.
+float generateLevel(const LevelGenParams& params, std::vector<Platform>& platforms,
+                    std::vector<Collectible>& collectibles, std::vector<Enemy>& enemies);
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef NETPLAY_H
+#define NETPLAY_H
+
+#include "game.h"
+#include "transport.h"
+
+// ─────────────────────────────────────────
+// Rollback co-op
+//
+// Both peers run the whole game, each controlling one player. Local input is applied the
+// tick it is read; the remote player's input is predicted (held directions carry on, jumps
+// are not repeated) until it arrives. Every datagram repeats the inputs the peer has not
+// acknowledged yet, so lost datagrams heal without resends. When a remote input differs from
+// what was predicted, the session restores the snapshot taken before that tick and plays the
+// ticks since then again. Prediction never runs more than MAX_ROLLBACK ticks past the last
+// remote input received; beyond that advance() waits for the peer.
+//
+// Both games must start identical: same level and tick rate, two-player, in PLAYING, and
+// not streamed (Game::saveState refuses those). A session whose game cannot save or load
+// its state ends. Checksums of confirmed state are exchanged to catch the peers drifting
+// apart.
+// ─────────────────────────────────────────
+
+// Hash of the gameplay state in a snapshot (players, score, lives, coins, tick), equal on
+// peers that are in sync
+uint32_t stateChecksum(const GameSnapshot& s);
+
+struct SessionStats {
+    int ticks;             // Advanced
+    int stalls;            // advance() calls that waited for the peer
+    int rollbacks;
+    int resimulatedTicks;
+    int maxRollback;       // Deepest rollback, in ticks
+    double maxRollbackMs;  // Longest restore and replay
+    int checksumsCompared;
+    int desyncs;           // Checksums that did not match
+    size_t datagramsSent, bytesSent;
+};
+
+class RollbackSession {
+   public:
+    static const int MAX_ROLLBACK = 8;
+
+   private:
+    static const int HISTORY = 64;            // Ticks of inputs and snapshots kept
+    static const int CHECKSUM_INTERVAL = 16;  // Ticks between checksums
+    static const int CHECKSUM_SLOTS = 4;      // Local checksums kept for late peers
+
+    Game& game;
+    Transport& transport;
+    int localSlot;
+
+    int tick;            // Next tick to simulate
+    int remoteReceived;  // Remote inputs are known for every tick below this
+    int remoteAcked;     // The peer has our inputs for every tick below this
+    int firstMismatch;   // Earliest simulated tick that used a wrong remote input, -1 if none
+    bool ended;          // The game could not save or restore a snapshot
+
+    // Rings indexed by tick % HISTORY
+    InputBits localInputs[HISTORY];
+    InputBits remoteInputs[HISTORY];
+    int remoteTicks[HISTORY];         // Tick the remoteInputs entry is for, -1 if none yet
+    InputBits usedRemote[HISTORY];    // Remote input the tick was last simulated with
+    GameSnapshot snapshots[HISTORY];  // State before the tick
+
+    struct Checksum {
+        int tick;
+        uint32_t value;
+    };
+    int nextChecksumTick;
+    Checksum localChecksums[CHECKSUM_SLOTS];  // By (tick / CHECKSUM_INTERVAL) % slots
+    Checksum latestChecksum;                  // Sent to the peer
+    Checksum pendingRemote;                   // Received before ours was ready
+    int lastCompared;
+
+    SessionStats stats;
+
+    void receive();
+    void readInputs(const uint8_t* data, int firstTick, int count);
+    void compareChecksum(const Checksum& remote);
+    void rollback();
+    bool simulate(int t, InputBits remote);
+    InputBits predictRemote(int t) const;
+    void updateChecksums();
+    void send();
+
+   public:
+    // `localSlot` is the player this peer controls: 0 (Game::getPlayer) or 1 (the partner)
+    RollbackSession(Game& game, Transport& transport, int localSlot);
+
+    // Run the next tick with the local player's input. Returns false without simulating if
+    // the peer is too far behind; call again with the same input on the next frame. Does
+    // nothing once the session has ended.
+    bool advance(InputBits local);
+    // Take in what the peer has sent and correct the current tick, without advancing. For
+    // frames spent waiting, and for letting a finished session settle.
+    void poll();
+
+    // The game could not snapshot its state, so nothing more is simulated; leave the session
+    bool hasEnded() const { return ended; }
+    int getTick() const { return tick; }
+    // Ticks below this were simulated with the peer's real input and will not be replayed
+    int getConfirmedTick() const { return remoteReceived < tick ? remoteReceived : tick; }
+    const SessionStats& getStats() const { return stats; }
+};
+
+#endif
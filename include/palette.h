@@ -0,0 +1,44 @@
+#ifndef PALETTE_H
+#define PALETTE_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// ─────────────────────────────────────────
+// Palette-indexed images
+//
+// The sprites are pixel art with a few dozen colours at most, so TextureManager stores them
+// as one 8-bit index per texel plus a small palette texture, a quarter of the RGBA8 size,
+// and looks the colour up when drawing. A palette swap is another row of the palette
+// texture: recoloured or tinted variants of a sprite cost a few bytes each, not a texture.
+//
+// Colours are RGBA8 packed in memory order (r in the lowest byte on little-endian), so a
+// texel and its palette entry compare as one uint32_t.
+// ─────────────────────────────────────────
+
+// How a variant is made from a sprite's own palette: exact colours replaced first, then
+// every entry multiplied by the tint
+struct PaletteSwap {
+    float r, g, b;
+    std::vector<std::pair<uint32_t, uint32_t>> colors;  // From, to
+
+    PaletteSwap(float r = 1.0f, float g = 1.0f, float b = 1.0f) : r(r), g(g), b(b) {}
+};
+
+uint32_t packColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255);
+
+// Index `count` RGBA8 texels. Fully transparent texels all share one entry. Returns false,
+// leaving the outputs unspecified, if the image has more than 256 colours.
+bool indexColors(const unsigned char* rgba, int count, std::vector<uint32_t>& palette,
+                 std::vector<unsigned char>& indices);
+
+// Look `count` indices up in `palette`, which must have 256 entries, for a GL without shaders
+void expandIndexed(const unsigned char* indices, int count, const uint32_t* palette,
+                   unsigned char* rgba);
+
+// `base` with `swap` applied
+void swapPalette(const std::vector<uint32_t>& base, const PaletteSwap& swap,
+                 std::vector<uint32_t>& out);
+
+#endif
@@ -2,6 +2,7 @@
 #define PARTICLE_H
 
 #include "types.h"
+#include "jobs.h"
 #include <vector>
 
 struct Particle {
@@ -10,7 +11,8 @@ struct Particle {
     float life, maxLife;
 
     Particle(float px, float py, float pvx, float pvy, Color c, float l);
-    void update();
+    // Step `dt` base ticks; `drag` is the air resistance factor for the whole step
+    void update(float dt = 1.0f, float drag = 0.99f);
     bool isDead() const;
 };
 
@@ -18,12 +20,28 @@ class ParticleSystem {
    private:
     std::vector<Particle> particles;
 
+    // Split update state: ranges of `particles` being stepped by jobs, and particles
+    // emitted while they run
+    bool updating;
+    std::vector<size_t> rangeSurvivors;
+    std::vector<Particle> staged;
+    float stepDt, stepDrag;
+
+    void setStep(float dt);
+
    public:
+    ParticleSystem();
+
     void addParticle(float x, float y, float vx, float vy, Color color, float life);
     void createJumpParticles(float x, float y);
     void createLandingParticles(float x, float y);
     void createCollectionParticles(float x, float y);
-    void update();
+    void update(float dt = 1.0f);
+    // Step existing particles on the job system while the rest of the tick runs. Particles
+    // emitted before endUpdate() are staged, then stepped and appended in emission order,
+    // so the result is identical to emitting everything and calling update().
+    void beginUpdate(JobSystem& jobs, JobCounter& done, float dt = 1.0f);
+    void endUpdate();
     void clear() { particles.clear(); }
     const std::vector<Particle>& getParticles() const { return particles; }
 };
@@ -9,11 +9,16 @@ class Platform {
     float x, y, width, height;
     Color color;
     bool isMoving;
-    float moveSpeed, moveRange, originalX, moveTimer;
+    float moveSpeed, moveRange, originalX;
+    int phase;  // Movement offset in ticks
 
     Platform(float px, float py, float w, float h, Color c, bool moving = false, float speed = 0,
              float range = 0);
-    void update();
+
+    // Position at a (possibly fractional) game tick
+    float xAt(float tick) const;
+    // Move to the position at `tick`; x is what collision tests against
+    void advanceTo(int tick);
 };
 
 void initializePlatforms(std::vector<Platform>& platforms);
@@ -8,6 +8,7 @@ class Player {
    public:
     float x, y;
     float vx, vy;
+    float moveX, moveY;  // Displacement for this step, applied by the collision solver
     float targetVx;
     bool onGround;
     bool wasOnGround;
@@ -25,7 +26,8 @@ class Player {
     float wallJumpCooldown;
 
     Player();
-    void update();
+    // Advance velocities by `dt` base ticks and compute this step's displacement
+    void update(float dt = 1.0f);
     void jump();
     void wallJump();
     void moveLeft();
@@ -0,0 +1,117 @@
+#ifndef REACHABILITY_H
+#define REACHABILITY_H
+
+#include "platform.h"
+#include "collectible.h"
+#include "jobs.h"
+#include "activity.h"
+#include <vector>
+
+// ─────────────────────────────────────────
+// Jump envelopes
+//
+// Player physics stepped once per take-off style, at full horizontal speed, branching into
+// every air jump the player has left. The result is a table from height change (player
+// centre, relative to take-off) to the farthest horizontal distance at which the player can
+// be at or above that height. Steering can always shorten a jump, so anything inside the
+// envelope is reachable. Lookups replace per-pair simulation when building the graph.
+// ─────────────────────────────────────────
+
+enum class TakeOff {
+    GROUND,  // Standing (or falling with no jump used): Player::maxJumps jumps
+    WALL     // Wall jump away from a wall, then the jumps it leaves
+};
+
+class JumpEnvelope {
+   private:
+    static const int MIN_RISE = -2000;  // Deepest drop tabulated; lower ones use this
+    std::vector<float> ground, wall;    // Indexed by rise - MIN_RISE; -1 if out of reach
+    int maxRise;
+
+    static void trace(float x, float y, float vx, float vy, int cooldownTicks, int jumpsLeft,
+                      std::vector<float>& table);
+    static void fill(std::vector<float>& table);
+
+   public:
+    JumpEnvelope();
+
+    // Farthest horizontal distance at which the centre can be `rise` px above take-off,
+    // or -1 if that height is out of reach
+    float reach(TakeOff style, float rise) const;
+    float maxReach() const;
+    int apex() const { return maxRise; }
+};
+
+// ─────────────────────────────────────────
+// Reachability graph
+//
+// Nodes are platform tops and side faces (wall slides), plus the player spawn. An edge means
+// one jump (with any air jumps left) can carry the player from anywhere in the source node's
+// span to somewhere in the target's. The check is optimistic: moving platforms count at
+// every position they pass through and arcs ignore obstacles in between.
+// ─────────────────────────────────────────
+
+// Range of player-centre positions from (or into) which a node is entered or left
+struct NodeSpan {
+    float left, right;  // Centre x
+    float y;            // Centre y
+    int away;           // Wall jump direction for faces, 0 for tops and spawn
+};
+
+// Compressed adjacency: edges of node n are targets[offsets[n] .. offsets[n + 1])
+struct NodeGraph {
+    std::vector<size_t> offsets;
+    std::vector<int> targets;
+
+    size_t nodes() const { return offsets.size() - 1; }
+};
+
+class ReachabilityGraph {
+   public:
+    enum { NODE_TOP, NODE_LEFT_FACE, NODE_RIGHT_FACE, NODES_PER_PLATFORM };
+
+   private:
+    std::vector<NodeSpan> spans;  // Per node, spawn last
+    NodeGraph graph;
+    ActivityIndex index;
+    float window;  // Farthest a node's edges can reach past its span
+
+   public:
+    ReachabilityGraph();
+
+    // Build for a level, platforms split across jobs
+    void build(const std::vector<Platform>& platforms, JobSystem& jobs);
+
+    static const JumpEnvelope& envelope();
+    const NodeGraph& edges() const { return graph; }
+    size_t nodes() const { return spans.size(); }
+    int spawnNode() const { return (int)spans.size() - 1; }
+    const NodeSpan& span(int node) const { return spans[node]; }
+    static int platformOf(int node) { return node / NODES_PER_PLATFORM; }
+
+    // Can the player get from `from` to a centre position inside [left, right] at height `y`
+    // or above (from where it can drop onto or through the target)?
+    bool canReach(const NodeSpan& from, float left, float right, float y) const;
+    // Platforms with a node that may reach into [left, right], in ascending order
+    void platformsNear(float left, float right, std::vector<int>& out) const;
+};
+
+// ─────────────────────────────────────────
+// Level validation
+// ─────────────────────────────────────────
+
+struct ReachabilityReport {
+    size_t nodes = 0, edges = 0;
+    std::vector<int> unreachableCoins;      // Indices into the collectibles
+    std::vector<int> unreachablePlatforms;  // Platforms nothing can land on
+    std::vector<int> softLocks;             // Reachable platforms with no way back to spawn
+    double buildSeconds = 0, searchSeconds = 0;
+};
+
+// Build the reachability graph and search it from the player spawn, in parallel on `jobs`.
+// The graph is optimistic, so a reported coin is one no route can collect. Falling to death
+// (which respawns the player) is not counted as a way back.
+ReachabilityReport validateLevel(const std::vector<Platform>& platforms,
+                                 const std::vector<Collectible>& collectibles, JobSystem& jobs);
+
+#endif
@@ -6,33 +6,83 @@
 #include "collectible.h"
 #include "particle.h"
 #include "enemy.h"
+#include "systems.h"
 #include "texture.h"
+#include <chrono>
+#include <map>
 #include <vector>
 #include <string>
 
+// Where Renderer::loadAssets gets sprites from
+enum class SpriteSource {
+    GENERATED,  // Drawn in memory (spritegen.h); nothing is read from disk
+    PACK,       // assets/sprites.pha, with the PNGs for anything missing from it
+    FILES       // The PNGs in assets/sprites/
+};
+
 class Renderer {
    private:
+    // Static platforms whose left edges fall in one PLATFORM_CHUNK_WIDTH of the level
+    struct PlatformChunk {
+        std::vector<int> platforms;  // Indices
+        float left, right;           // World X they cover
+        GLuint geometry;             // Retained, 0 until first drawn
+    };
+
+    // What baked tiles depend on: a tile sprite's texture, size and palette
+    struct TileState {
+        GLuint texture, palette;
+        int width, height, paletteSize, paletteRows;
+        bool topDown;
+
+        bool operator==(const TileState& o) const {
+            return texture == o.texture && palette == o.palette && width == o.width &&
+                   height == o.height && paletteSize == o.paletteSize &&
+                   paletteRows == o.paletteRows && topDown == o.topDown;
+        }
+    };
+
     float gameTime;
+    bool assetsLoading;
+    std::chrono::steady_clock::time_point assetsRequested;
+    int reloadsSeen;  // Hot reloads already reported
+    int playerPalettes[4];  // Palette rows by partner (bit 0) and wall sliding (bit 1)
+    bool instancing;
+    std::vector<DrawInstance> instances;  // Scratch for instanced sets, kept between frames
+    bool retainPlatforms;
+    bool platformChunksBuilt;
+    std::map<int, PlatformChunk> platformChunks;  // By chunk number
+    std::vector<int> movingPlatforms;
+    float chunkReach;         // Furthest a chunk's platforms reach right of its start
+    TileState tileStates[2];  // Of tile_grass and tile_stone when the chunks were baked
 
     // Helper methods
-    void drawText(const std::string& text, float x, float y, void* font);
-    void drawTextCentered(const std::string& text, float y, void* font);
+    void drawText(const char* text, float x, float y, void* font);
+    void drawTextCentered(const char* text, float y, void* font);
     void drawHeart(float x, float y, float size, bool filled);
     void drawCoinIcon(float x, float y, float size);
+    void drawPlatform(const Platform& platform, float x);
+    void buildPlatformChunks(const std::vector<Platform>& platforms);
+    void releasePlatformChunks();
 
    public:
     Renderer();
+    ~Renderer();
 
-    // Load all sprite assets
-    void loadAssets();
+    // Start loading all sprite assets in the background
+    void loadAssets(SpriteSource source = SpriteSource::GENERATED);
+    // Start a texture frame and upload sprites that have finished decoding or reloading;
+    // call once per frame before drawing
+    void pollAssets();
 
     // Game world rendering
     void drawBackground(float cameraX);
-    void drawPlayer(const Player& player, float cameraX);
+    // The co-op partner is drawn tinted green
+    void drawPlayer(const Player& player, float cameraX, bool partner = false);
     void drawPlatforms(const std::vector<Platform>& platforms, float cameraX);
-    void drawCollectibles(const std::vector<Collectible>& collectibles, float cameraX);
+    void drawCollectibles(const std::vector<SpriteInstance>& coins, float cameraX);
     void drawParticles(const std::vector<Particle>& particles, float cameraX);
-    void drawEnemies(const std::vector<Enemy>& enemies, float cameraX);
+    void drawEnemies(const std::vector<SpriteInstance>& enemies, float cameraX);
 
     // UI rendering
     void drawHUD(int score, int lives, float timer, const Player& player);
@@ -42,7 +92,15 @@ class Renderer {
     void drawWinScreen(int score, float timer);
     void drawScreenFlash(float r, float g, float b, float alpha);
 
-    void updateGameTime() { gameTime += 0.016f; }
+    void updateGameTime(float seconds) { gameTime += seconds; }
+    // Draw particles and coins as instanced sets, one draw call each for particles, coin
+    // glows and coin sprites (the default), or one sprite at a time
+    void setInstancing(bool enabled) { instancing = enabled; }
+    // Keep static platforms as retained geometry, baked a chunk of the level at a time, and
+    // draw only moving ones anew each frame. The caller must then call platformsChanged()
+    // whenever the platforms it passes change, other than moving platforms moving.
+    void setRetainedPlatforms(bool enabled);
+    void platformsChanged();
 };
 
 #endif
\ No newline at end of file
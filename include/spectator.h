@@ -0,0 +1,187 @@
+#ifndef SPECTATOR_H
+#define SPECTATOR_H
+
+#include "game.h"
+#include "activity.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ─────────────────────────────────────────
+// Spectator streaming
+//
+// The game publishes what a viewer needs to draw it, one bit-packed diff per tick, over a
+// Unix socket or TCP on localhost. Viewers load the level themselves from the description
+// in the stream's hello message, so only what changes is sent: the players, the camera, the
+// HUD, coins collected, enemies killed and the x of enemies in view. A viewer that joins gets
+// a keyframe (the diff from the level's spawn state) and the shared per-tick diffs after it.
+//
+// Positions are quantized to 1/8 px and sent as the error of a constant-velocity guess, in
+// Elias gamma codes, so steady motion costs a bit or two per axis. Particles, screen flashes
+// and camera shake are not sent. On streamed levels only the players, camera and HUD are
+// (record indices are not stable there).
+// ─────────────────────────────────────────
+
+// A player as drawn: position, squash and the bits the sprite and HUD pick frames from
+struct SpectatorPlayer {
+    int32_t x, y;     // 1/8 px
+    int32_t vx, vy;   // Last change of x and y, the guess for the next one
+    int32_t squash;   // squashScale, 1/64
+    uint8_t pose;     // POSE_* bits, jump count in bits 5-6
+};
+
+const uint8_t POSE_ON_GROUND = 1;
+const uint8_t POSE_WALL_SLIDING = 2;
+const uint8_t POSE_FACING_RIGHT = 4;
+const uint8_t POSE_RUNNING = 8;
+const uint8_t POSE_RUN_FRAME = 16;  // Second run frame
+const int POSE_JUMP_SHIFT = 5;
+
+// Quantized world state shared by the publisher and viewers, apart from the per-enemy
+// tables. Value-initialized it is the state a level starts from.
+struct SpectatorView {
+    int tick;
+    int32_t cameraX, cameraVx;  // 1/8 px
+    SpectatorPlayer players[2];
+    bool twoPlayer;
+    GameState state;
+    int score, lives;
+    int seconds;  // Game timer, whole seconds as the HUD shows it
+};
+
+// Per enemy record, on both ends
+struct SpectatorEnemy {
+    int32_t x, vx;  // 1/8 px; spawn point and 0 at level start
+    bool facingRight;
+};
+
+struct SpectatorStats {
+    size_t frames;         // Per-tick diffs encoded
+    size_t frameBytes;     // Their size on the wire, length prefixes included
+    size_t keyframes;
+    size_t keyframeBytes;
+    double encodeMs;       // Total time capturing and encoding diffs
+    double maxEncodeMs;
+};
+
+// Game -> bytes. One encoder serves every synced viewer: frames are diffs from the state the
+// previous frame left viewers in.
+class SpectatorEncoder {
+   private:
+    struct EnemyUpdate {
+        int record;
+        SpectatorEnemy pose;
+    };
+
+    SpectatorView sent;                    // What synced viewers have
+    std::vector<SpectatorEnemy> sentEnemies;
+    std::vector<LevelChange> sentChanges;  // Coins and enemies viewers have changed
+    int levelSerial;
+    bool streamed;
+    ActivityIndex enemyIndex;
+    std::vector<int> visibleEnemies;
+    std::vector<EnemyUpdate> enemyUpdates;
+    std::vector<uint8_t> payload;
+
+   public:
+    SpectatorEncoder();
+
+    // Level description and tick rate for a new viewer; the keyframe follows it
+    void encodeHello(Game& game, std::vector<uint8_t>& out) const;
+    // Diff from the last frame to now, appended to `out` with its length prefix
+    void encodeFrame(Game& game, std::vector<uint8_t>& out);
+    // Diff from spawn state to what the last frame left viewers in, for a viewer joining
+    void encodeKeyframe(Game& game, std::vector<uint8_t>& out) const;
+};
+
+// Bytes -> view, on the viewer's side. Holds the level loaded from the hello message.
+class SpectatorDecoder {
+   private:
+    bool ready;  // Hello seen
+    std::vector<SpectatorEnemy> enemyPoses;
+
+   public:
+    SpectatorView view;
+    std::vector<Platform> platforms;
+    std::vector<Collectible> collectibles;  // `collected` follows the stream
+    std::vector<Enemy> enemies;             // `alive` follows the stream
+    ActivityIndex platformIndex, coinIndex, enemyIndex;
+    float levelWidth;
+    int tickRate;
+
+    SpectatorDecoder();
+
+    // Split complete messages off the front of `buffer` and apply them. Returns false on a
+    // malformed stream or a level that cannot be loaded.
+    bool consume(std::vector<uint8_t>& buffer);
+    bool isReady() const { return ready; }
+
+    // A Player posed for Renderer::drawPlayer / drawHUD
+    void posePlayer(int slot, Player& out) const;
+    float getCameraX() const;
+
+   private:
+    bool applyHello(const uint8_t* data, size_t size);
+    bool applyFrame(const uint8_t* data, size_t size);
+};
+
+// Listening socket publishing one game. `address` is "unix:PATH" or a TCP port on 127.0.0.1.
+class SpectatorPublisher {
+   private:
+    struct Viewer {
+        int fd;
+        bool synced;                  // Has the hello and keyframe
+        std::vector<uint8_t> outbox;  // Not yet accepted by the socket
+        size_t bytesSent;
+        int joinedTick;
+    };
+
+    int listenFd;
+    std::string unixPath;  // Unlinked on close
+    std::vector<Viewer> viewers;
+    SpectatorEncoder encoder;
+    std::vector<uint8_t> frame, scratch;
+    SpectatorStats stats;
+
+    void accept(int tick);
+    bool flush(Viewer& viewer);
+
+   public:
+    SpectatorPublisher();
+    ~SpectatorPublisher();
+    SpectatorPublisher(const SpectatorPublisher&) = delete;
+    SpectatorPublisher& operator=(const SpectatorPublisher&) = delete;
+
+    bool listen(const std::string& address);
+    void close();
+
+    // Call once per update. Does nothing while no viewer is connected.
+    void publish(Game& game);
+
+    int viewerCount() const { return (int)viewers.size(); }
+    const SpectatorStats& getStats() const { return stats; }
+};
+
+// Viewer end of the socket
+class SpectatorClient {
+   private:
+    int fd;
+    std::vector<uint8_t> buffer;
+    size_t received;
+
+   public:
+    SpectatorDecoder decoder;
+
+    SpectatorClient();
+    ~SpectatorClient();
+    SpectatorClient(const SpectatorClient&) = delete;
+    SpectatorClient& operator=(const SpectatorClient&) = delete;
+
+    bool connect(const std::string& address);
+    // Read whatever has arrived and apply it. Returns false once the stream has ended or
+    // turned out malformed.
+    bool poll();
+    size_t bytesReceived() const { return received; }
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef SPRITEGEN_H
+#define SPRITEGEN_H
+
+#include "jobs.h"
+#include <string>
+#include <vector>
+
+// ─────────────────────────────────────────
+// Procedural sprites
+//
+// The game's pixel art, drawn in code. The game generates it in memory at startup
+// (TextureManager::loadGeneratedSprites); tools/gen_sprites writes the same sheets out as
+// the PNGs in assets/sprites/ for editing and packing.
+// ─────────────────────────────────────────
+
+// One sprite sheet: frames side by side, RGBA8 rows top-down
+struct SpriteImage {
+    std::string name;
+    int width, height;
+    int frameCount;
+    std::vector<unsigned char> rgba;
+};
+
+// Each generator appends the sheets it draws
+typedef void (*SpriteGenerator)(std::vector<SpriteImage>& out);
+
+void generatePlayerSprites(std::vector<SpriteImage>& out);      // player
+void generateCoinSprites(std::vector<SpriteImage>& out);        // coin
+void generateEnemySprites(std::vector<SpriteImage>& out);       // enemy
+void generatePlatformTiles(std::vector<SpriteImage>& out);      // tile_grass, _stone, _moving
+void generateBackgroundSprites(std::vector<SpriteImage>& out);  // cloud
+void generateParticleSprite(std::vector<SpriteImage>& out);     // particle
+
+// All of the above
+extern const SpriteGenerator SPRITE_GENERATORS[];
+extern const int SPRITE_GENERATOR_COUNT;
+
+// Run every generator in parallel on `jobs`. Sheets come out in generator order.
+void generateSprites(JobSystem& jobs, std::vector<SpriteImage>& out);
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef STREAMING_H
+#define STREAMING_H
+
+#include "levelfile.h"
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+// World partitioning along X. Entities belong to the chunk containing their rest x and must
+// not move further than one chunk from it (patrol spans and platform ranges stay well below).
+const float CHUNK_WIDTH = 1024.0f;
+const int ACTIVE_MARGIN_CHUNKS = 1;  // Simulated chunks beyond the ones the camera sees
+const int PREFETCH_CHUNKS = 2;       // Chunks loaded ahead in the direction of travel
+const int KEEP_CHUNKS = 1;           // Inactive chunks kept resident behind before eviction
+
+// Levels at least this wide stream from their level file instead of loading whole
+const float STREAM_MIN_WIDTH = CHUNK_WIDTH * 8;
+
+struct StreamStats {
+    int residentChunks;
+    int activeChunks;
+    int pooledChunks;
+    long asyncLoads;
+    long syncLoads;  // Times an active chunk had to be waited for or decoded on the game thread
+    long evictions;
+    double worstSyncMs;  // Longest sync load
+};
+
+// Streams a sorted level file chunk by chunk. Chunks around the camera are active: their
+// entities are spliced into the Game's platform / coin / enemy vectors. Chunks ahead of the
+// player are decoded on a worker thread, and chunks far away are evicted back to a pool.
+// Collected coins and killed enemies survive eviction.
+class LevelStreamer {
+   private:
+    struct Chunk {
+        int index;
+        size_t coinBase, enemyBase;  // Global record index of the first coin / enemy
+        std::vector<Platform> platforms;
+        std::vector<Collectible> coins;
+        std::vector<Enemy> enemies;
+    };
+
+    const LevelFile* file;
+    int chunkCount;
+
+    // Worker thread state (guarded by mutex)
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable delivered;
+    std::deque<Chunk*> requests;
+    std::vector<Chunk*> completed;
+    int inFlight;  // Chunk index the worker is decoding, -1 if idle
+    bool quit;
+
+    // Main thread state
+    std::map<int, Chunk*> resident;  // Decoded chunks, keyed by index
+    std::set<int> pending;           // Chunk indices queued or in flight
+    std::vector<int> active;         // Chunks currently spliced into the game vectors, in order
+    std::vector<Chunk*> pool;
+    std::vector<bool> coinCollected;
+    std::vector<bool> enemyKilled;
+    StreamStats stats;
+
+    void workerLoop();
+    void decodeChunk(Chunk& chunk) const;
+    Chunk* acquireChunk(int index);
+    void request(int index);
+    void collectCompleted();
+    Chunk* waitForChunk(int index);
+    void writeBack(std::vector<Platform>& platforms, std::vector<Collectible>& collectibles,
+                   std::vector<Enemy>& enemies);
+    void evict(int index);
+    void recycle(Chunk* chunk);
+    void stopWorker();
+
+    LevelStreamer(const LevelStreamer&);
+    LevelStreamer& operator=(const LevelStreamer&);
+
+   public:
+    LevelStreamer();
+    ~LevelStreamer();
+
+    // Begin streaming a level file (must be sorted by x). Discards any previous state.
+    void start(const LevelFile* levelFile);
+    // Evict everything and forget collected coins / killed enemies
+    void reset();
+    // Stop the worker and release every chunk
+    void stop();
+    bool isStreaming() const { return file != nullptr; }
+    // Block until the worker has decoded everything requested so far (tools, benchmarks)
+    void waitIdle();
+
+    // Call once per tick. Activates, prefetches and evicts chunks around the camera and
+    // rebuilds the game vectors when the active set changes. Returns true if it did.
+    bool update(float cameraX, float playerVx, std::vector<Platform>& platforms,
+                std::vector<Collectible>& collectibles, std::vector<Enemy>& enemies);
+
+    const StreamStats& getStats() const { return stats; }
+};
+
+#endif
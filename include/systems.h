@@ -0,0 +1,43 @@
+#ifndef SYSTEMS_H
+#define SYSTEMS_H
+
+#include "ecs.h"
+#include "broadphase.h"
+#include "collectible.h"
+#include "enemy.h"
+#include <vector>
+
+// Render-ready sprite produced by extractSprites()
+struct SpriteInstance {
+    SpriteKind kind;
+    float x, y;
+    float scale;
+    int frame;
+    bool flipX;
+};
+
+const float COIN_SPRITE_SCALE = 2.0f;
+const float ENEMY_SPRITE_SCALE = 1.5f;
+
+// Spawn a live entity for a level record, posed at `tick`
+Entity spawnCoin(Registry& registry, const Collectible& coin, int record);
+Entity spawnEnemy(Registry& registry, const Enemy& enemy, int record, int tick);
+
+// Pose patrolling entities at `tick` (Patrol -> Transform, Velocity). The range form
+// covers patrol slots [begin, end) so disjoint ranges can run as parallel jobs.
+void patrolSystem(Registry& registry, int tick);
+void patrolSystem(Registry& registry, int tick, size_t begin, size_t end);
+
+// Register an entity's trigger volume (Transform, AABB) with the broadphase
+void addTrigger(const Registry& registry, SweepAndPrune& triggers, Entity e);
+// Follow patrolSystem's moves in the broadphase
+void syncTriggers(const Registry& registry, SweepAndPrune& triggers);
+
+// Append world-space sprites of one kind (Drawable, Transform, Animation, Velocity)
+void extractSprites(const Registry& registry, SpriteKind kind, float tick,
+                    std::vector<SpriteInstance>& out);
+// Sprite of a coin or enemy standing at (x, y) with animation clock `clock` (tick + phase)
+SpriteInstance poseSprite(SpriteKind kind, float x, float y, float scale, float clock,
+                          bool facingLeft);
+
+#endif
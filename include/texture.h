@@ -2,35 +2,195 @@
 #define TEXTURE_H
 
 #include <GL/glut.h>
+#include "assetpack.h"
+#include "backend.h"
+#include "jobs.h"
+#include "palette.h"
+#include <atomic>
 #include <string>
 #include <map>
+#include <mutex>
+#include <vector>
 
 struct Sprite {
     GLuint textureID;
     int width, height;
     int frameWidth, frameHeight;
     int frameCount;
+    bool ready;    // Uploaded. Sprites still loading have their size but draw nothing.
+    bool topDown;  // Rows uploaded top-down (unflipped pack entry); drawn with v reversed
+    int lastUsed;         // Frame (TextureManager::nextFrame) it was last drawn in, -1 if never
+    bool evicted;         // Texture dropped to fit the budget; loads back when drawn
+    int reloadRequested;  // Frame an evicted sprite was asked for again, -1 if not yet
+    bool indexed;         // 8-bit palette indices, looked up in paletteID when drawn
+    GLuint paletteID;     // paletteSize colours wide, one row per variant
+    int paletteSize, paletteRows;
+    size_t textureBytes;  // Uploaded, palette included
 };
 
+// Texture memory, counted as the texels uploaded
+struct TextureStats {
+    size_t residentBytes;
+    size_t peakBytes;
+    size_t budgetBytes;  // 0: no budget
+    int evictions;
+    int reloads;         // Evicted sprites drawn again and loaded back
+    int stalledDraws;    // Draws skipped while such a sprite was loading back
+    int maxStallFrames;  // Longest an evicted sprite took to come back
+};
+
+// Sprites are loaded either on the spot (loadSprite) or in the background: loadSpriteAsync
+// registers the sprite at once, sized from the file header, and decodes it on a loader
+// thread; uploadDecoded() then uploads what has been decoded, a few sprites per frame. Map
+// entries never move, so a Sprite* from getSprite stays valid while it loads.
+//
+// Sprites found in an open asset pack skip decoding altogether: their pixels go from the
+// mapped file straight to glTexImage2D, synchronously, whichever load call asked for them.
+//
+// With a watched directory (watchSprites), rewriting NAME.png there reloads sprite NAME,
+// however it was first loaded: the file is decoded on a loader thread and uploadDecoded()
+// replaces the pixels in the existing texture, reallocating it only if the size changed.
+//
+// Under a texture budget (setTextureBudget), nextFrame() evicts the least recently drawn
+// sprites until what is resident fits, sparing those drawn in the last frame. An evicted
+// sprite keeps its entry and size; drawing it queues it to load back the way it first loaded
+// (decoded or generated on a loader thread, or straight from the pack) and it draws nothing
+// until then.
+//
+// Sprites of up to 256 colours are stored palette-indexed (palette.h) when the render
+// backend (backend.h) can look colours up, indexed on the loader threads where they load
+// there. Variants made by definePalette are drawn by passing their row to drawSprite. Without
+// a lookup (GL < 2.0) sprites stay RGBA8 and a variant's tint is applied as a colour instead.
+// Drawing goes through the render backend.
 class TextureManager {
    private:
+    // Decoded or generated on a loader thread, waiting for the GL thread
+    struct Decoded {
+        std::string name;
+        unsigned char* pixels;                 // stbi_load result, null if decoding failed
+        std::vector<unsigned char> generated;  // Or a generated sheet, rows top-down
+        int width, height;
+        int frameCount;  // Of generated sheets; files keep the count they were requested with
+        int reload;      // Serial of a hot reload, 0 for a first load
+        int generator;   // SPRITE_GENERATORS index of a generated sheet
+        std::vector<unsigned char> indices;  // Indexed on the loader thread, if it could be
+        std::vector<uint32_t> palette;
+    };
+
+    // A sprite's variants, in row order from 1
+    typedef std::vector<std::pair<std::string, PaletteSwap>> PaletteVariants;
+
+    // Where a sprite's pixels came from, to load it back after eviction: a PNG, a generator,
+    // or the open pack if neither
+    struct Origin {
+        std::string path;
+        int generator;
+    };
+
     std::map<std::string, Sprite> sprites;
+    std::map<std::string, Origin> origins;
+    JobSystem loaders;
+    int loaderThreads;  // -1: one per hardware thread
+    bool loadersStarted;
+    JobCounter decoding;
+    std::mutex decodedMutex;
+    std::vector<Decoded> decoded;  // Guarded by decodedMutex
+    std::atomic<int> pendingLoads;  // Requested and not yet uploaded
+    AssetPack pack;
+    int watchFd;  // inotify, -1 when not watching
+    std::string watchDirectory;
+    std::map<std::string, int> reloadSerials;  // Latest reload queued per sprite
+    int hotReloads;                             // Uploaded so far
+    int frameNumber;
+    TextureStats stats;
+    bool indexing;  // Index sprites that allow it (and the render backend can draw them)
+    std::map<std::string, PaletteVariants> variants;
+    std::map<std::string, std::vector<uint32_t>> palettes;  // Of indexed sprites
     static TextureManager* instance;
 
+    TextureManager();
+    bool indexSprites();
+    void prepare(Sprite& sprite, int width, int height, bool indexed);
+    void finish(Sprite& sprite, size_t texelBytes);
+    void upload(Sprite& sprite, const std::string& name, const unsigned char* pixels, int width,
+                int height);
+    void uploadIndexed(Sprite& sprite, const std::string& name, const unsigned char* indices,
+                       const std::vector<uint32_t>& palette, int width, int height);
+    void uploadPalette(const std::string& name, Sprite& sprite);
+    void uploadDecodedImage(Sprite& sprite, const Decoded& d, const unsigned char* pixels);
+    void uploadPacked(Sprite& sprite, const std::string& name, const AssetPackEntry& entry);
+    void decodeAsync(const std::string& name, const std::string& path, int reload);
+    void generateAsync(int generator);
+    Sprite* use(const std::string& name);
+    void evict(Sprite& sprite);
+    void restore(const std::string& name, Sprite& sprite);
+    void bind(const std::string& name, const Sprite& sprite, int palette, float r, float g,
+              float b, float a);
+    bool loadFromPack(const std::string& name, int frameCount);
+    void startLoaders();
+
    public:
     static TextureManager& getInstance();
 
+    // Map an asset pack (.pha) to load sprites from. Returns false, quietly if the file
+    // does not exist, when there is no usable pack; loads then decode image files.
+    bool openPack(const std::string& path);
+
     // Load a sprite sheet. frameCount=1 for single images.
     bool loadSprite(const std::string& name, const std::string& path, int frameCount = 1);
+    // Queue a sprite sheet for decoding on the loader threads. Returns false if the file is
+    // not a readable image. Names already loaded or loading are left alone.
+    bool loadSpriteAsync(const std::string& name, const std::string& path, int frameCount = 1);
+    // Draw the built-in sprites (spritegen.h) on the loader threads, one job per generator,
+    // without touching the disk. They upload through uploadDecoded like decoded files; names
+    // already loaded some other way are kept.
+    void loadGeneratedSprites();
+    // Upload up to `maxUploads` decoded sprites (all of them if negative); GL thread only.
+    // Returns the number of sprites still loading.
+    int uploadDecoded(int maxUploads = -1);
+    // Wait for every queued sprite and upload it
+    void finishLoading();
+    bool isLoading() const { return pendingLoads > 0; }
+    // Loader thread count, by default one per hardware thread (the GL thread keeps drawing)
+    void setLoaderThreads(int count);
+
+    // Start watching `directory` for rewritten sprite PNGs
+    bool watchSprites(const std::string& directory);
+    // Queue reloads for files changed since the last call; GL thread, once per frame. Costs
+    // one non-blocking read when nothing changed.
+    void checkWatched();
+    int getHotReloadCount() const { return hotReloads; }
+
+    // Keep resident textures within `bytes` (0 for no limit) from the next frame on
+    void setTextureBudget(size_t bytes);
+    // Start a frame: sprites drawn from now on count as used in it. Evicts down to the
+    // budget; GL thread, once per frame before drawing.
+    void nextFrame();
+    const TextureStats& getStats() const { return stats; }
 
-    // Draw a sprite frame at position, with optional scaling and flip
+    // Store sprites loaded from now on palette-indexed where they allow it (the default)
+    void setIndexedSprites(bool enabled);
+    // Define (or redefine) `variant` of `sprite` and return its palette row for drawSprite.
+    // May be called before the sprite loads; the variant is made whenever it uploads.
+    int definePalette(const std::string& sprite, const std::string& variant,
+                      const PaletteSwap& swap);
+
+    // Draw a sprite frame at position, with optional scaling, flip, tint and palette row
     void drawSprite(const std::string& name, float x, float y, float scaleX = 1.0f,
                     float scaleY = 1.0f, int frame = 0, bool flipX = false, float r = 1.0f,
-                    float g = 1.0f, float b = 1.0f, float a = 1.0f);
+                    float g = 1.0f, float b = 1.0f, float a = 1.0f, int palette = 0);
+
+    // Draw frames of a sprite at each of `count` instances with one call (see
+    // RenderBackend::drawSprites), tinted by their colours
+    void drawSprites(const std::string& name, const DrawInstance* instances, size_t count);
 
     // Draw a tiled sprite across a rectangular area
     void drawTiled(const std::string& name, float x, float y, float width, float height);
 
+    // Count a sprite as drawn this frame, loading it back if it was evicted, for geometry
+    // that holds on to its texture (RenderBackend::beginRetained). Null until drawable.
+    const Sprite* touch(const std::string& name) { return use(name); }
+
     const Sprite* getSprite(const std::string& name) const;
 
     void cleanup();
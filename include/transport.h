@@ -0,0 +1,109 @@
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Unreliable datagram link to one peer. Datagrams may be dropped, duplicated or arrive out of
+// order; anything built on top has to cope with all three.
+class Transport {
+   public:
+    virtual ~Transport() {}
+    virtual void send(const uint8_t* data, size_t size) = 0;
+    // Copy the next waiting datagram into `buffer` and return its size, or 0 if none is
+    // waiting. Datagrams longer than `capacity` are truncated.
+    virtual size_t receive(uint8_t* buffer, size_t capacity) = 0;
+};
+
+// ─────────────────────────────────────────
+// UDP
+// ─────────────────────────────────────────
+
+class UdpTransport : public Transport {
+   private:
+    int fd;
+    uint32_t peerAddress;  // Network byte order
+    uint16_t peerPort;
+
+   public:
+    UdpTransport();
+    ~UdpTransport();
+
+    // Bind `localPort` and talk to host:remotePort (IPv4). Non-blocking.
+    bool open(uint16_t localPort, const std::string& host, uint16_t remotePort);
+    void close();
+    bool isOpen() const { return fd >= 0; }
+
+    void send(const uint8_t* data, size_t size) override;
+    // Datagrams from anyone but the peer are dropped
+    size_t receive(uint8_t* buffer, size_t capacity) override;
+};
+
+// ─────────────────────────────────────────
+// In-process link simulator
+//
+// Two endpoints joined by a simulated network, for running sessions offline and
+// reproducibly. Each direction delays, drops and duplicates datagrams independently; jitter
+// reorders them. Time only moves when advance() is called.
+// ─────────────────────────────────────────
+
+struct LinkConditions {
+    float latencyMs;  // One way
+    float jitterMs;   // Extra delay, uniform in [0, jitterMs)
+    float loss;       // Share of datagrams dropped
+    float duplicate;  // Share of datagrams delivered twice
+
+    LinkConditions(float latency = 0, float jitter = 0, float lossRate = 0, float dup = 0)
+        : latencyMs(latency), jitterMs(jitter), loss(lossRate), duplicate(dup) {}
+};
+
+struct LinkStats {
+    size_t datagrams, bytes;  // Sent, both directions
+    size_t dropped, duplicated;
+};
+
+class LoopbackLink {
+   private:
+    struct Datagram {
+        double deliverAt;
+        std::vector<uint8_t> data;
+    };
+
+    class Endpoint : public Transport {
+       private:
+        LoopbackLink* link;
+        int side;
+
+       public:
+        Endpoint() : link(nullptr), side(0) {}
+        void attach(LoopbackLink* l, int s) {
+            link = l;
+            side = s;
+        }
+        void send(const uint8_t* data, size_t size) override;
+        size_t receive(uint8_t* buffer, size_t capacity) override;
+    };
+
+    LinkConditions conditions;
+    uint32_t rng;
+    double now;
+    std::vector<Datagram> inbox[2];  // Per receiving side, in delivery order
+    Endpoint endpoints[2];
+    LinkStats stats;
+
+    float uniform();
+    void post(int to, const uint8_t* data, size_t size);
+
+   public:
+    explicit LoopbackLink(const LinkConditions& c = LinkConditions(), uint32_t seed = 1);
+    LoopbackLink(const LoopbackLink&) = delete;
+    LoopbackLink& operator=(const LoopbackLink&) = delete;
+
+    Transport& endpoint(int side) { return endpoints[side]; }
+    void advance(double ms) { now += ms; }
+    const LinkStats& getStats() const { return stats; }
+};
+
+#endif
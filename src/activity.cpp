@@ -0,0 +1,56 @@
+#include "activity.h"
+#include <algorithm>
+#include <cmath>
+
+ActivityIndex::ActivityIndex() : maxWidth(0) {}
+
+void ActivityIndex::sortSpans() {
+    std::sort(spans.begin(), spans.end(),
+              [](const Span& a, const Span& b) { return a.left < b.left; });
+    maxWidth = 0;
+    for (const Span& s : spans) maxWidth = std::max(maxWidth, s.right - s.left);
+}
+
+void ActivityIndex::build(const std::vector<Platform>& platforms) {
+    spans.clear();
+    for (size_t i = 0; i < platforms.size(); i++) {
+        const Platform& p = platforms[i];
+        float range = p.isMoving ? fabs(p.moveRange) : 0;
+        Span s = {p.originalX - range, p.originalX + range + p.width, (int)i};
+        spans.push_back(s);
+    }
+    sortSpans();
+}
+
+void ActivityIndex::build(const std::vector<Collectible>& collectibles) {
+    spans.clear();
+    for (size_t i = 0; i < collectibles.size(); i++) {
+        Span s = {collectibles[i].x, collectibles[i].x, (int)i};
+        spans.push_back(s);
+    }
+    sortSpans();
+}
+
+void ActivityIndex::build(const std::vector<Enemy>& enemies) {
+    spans.clear();
+    for (size_t i = 0; i < enemies.size(); i++) {
+        const Enemy& e = enemies[i];
+        float left = e.type == EnemyType::PATROL ? std::min(e.spawnX, e.patrolLeft) : e.spawnX;
+        float right = e.type == EnemyType::PATROL ? std::max(e.spawnX, e.patrolRight) : e.spawnX;
+        Span s = {left - e.width / 2, right + e.width / 2, (int)i};
+        spans.push_back(s);
+    }
+    sortSpans();
+}
+
+void ActivityIndex::query(float left, float right, std::vector<int>& out) const {
+    out.clear();
+
+    // Any span reaching `left` starts at most maxWidth before it
+    auto it = std::lower_bound(spans.begin(), spans.end(), left - maxWidth,
+                               [](const Span& s, float x) { return s.left < x; });
+    for (; it != spans.end() && it->left <= right; ++it) {
+        if (it->right >= left) out.push_back(it->index);
+    }
+    std::sort(out.begin(), out.end());
+}
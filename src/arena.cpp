@@ -0,0 +1,82 @@
+#include "arena.h"
+#include "constants.h"
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+FrameArena frameArena(FRAME_ARENA_BYTES);
+
+#ifndef NDEBUG
+static const unsigned char POISON = 0xDD;
+#endif
+
+FrameArena::FrameArena(size_t capacity)
+    : block(static_cast<char*>(malloc(capacity))),
+      capacity(block ? capacity : 0),
+      used(0),
+      overflowBytes(0),
+      stats() {
+    stats.capacity = this->capacity;
+#ifndef NDEBUG
+    if (block) memset(block, POISON, capacity);
+#endif
+}
+
+FrameArena::~FrameArena() {
+    release(0, 0);
+    free(block);
+}
+
+void* FrameArena::allocate(size_t bytes, size_t align) {
+    size_t start = (used + align - 1) & ~(align - 1);
+    void* p;
+    if (start + bytes <= capacity) {
+        p = block + start;
+        used = start + bytes;
+    } else {
+        // malloc's alignment covers everything but over-aligned types
+        p = malloc(bytes ? bytes : 1);
+        if (!p) {
+            fprintf(stderr, "Frame arena: out of memory allocating %zu bytes\n", bytes);
+            abort();
+        }
+        overflow.push_back(p);
+        overflowBytes += bytes;
+        stats.overflows++;
+    }
+    if (used + overflowBytes > stats.highWater) stats.highWater = used + overflowBytes;
+    return p;
+}
+
+const char* FrameArena::format(const char* fmt, ...) {
+    va_list args, measure;
+    va_start(args, fmt);
+    va_copy(measure, args);
+    int length = vsnprintf(nullptr, 0, fmt, measure);
+    va_end(measure);
+    if (length < 0) length = 0;
+    char* text = static_cast<char*>(allocate(length + 1, 1));
+    vsnprintf(text, length + 1, fmt, args);
+    va_end(args);
+    return text;
+}
+
+void FrameArena::release(size_t toUsed, size_t toOverflow) {
+#ifndef NDEBUG
+    if (used > toUsed) memset(block + toUsed, POISON, used - toUsed);
+#endif
+    used = toUsed;
+    for (size_t i = toOverflow; i < overflow.size(); i++) free(overflow[i]);
+    overflow.resize(toOverflow);
+}
+
+void FrameArena::reset() {
+    release(0, 0);
+    overflowBytes = 0;
+}
+
+void FrameArena::rewind(const Mark& mark) {
+    release(mark.used, mark.overflowCount);
+    overflowBytes = mark.overflowBytes;
+}
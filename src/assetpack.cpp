@@ -0,0 +1,162 @@
+#include "assetpack.h"
+#include "palette.h"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+AssetPack::AssetPack() : data(nullptr), size(0), header(nullptr), entries(nullptr) {}
+
+AssetPack::~AssetPack() {
+    close();
+}
+
+bool AssetPack::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;  // No pack is not an error; callers fall back to PNGs
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(AssetPackHeader)) {
+        fprintf(stderr, "Asset pack too small: %s\n", path.c_str());
+        ::close(fd);
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // The mapping keeps the file alive
+    if (mapped == MAP_FAILED) {
+        fprintf(stderr, "Failed to map asset pack: %s\n", path.c_str());
+        return false;
+    }
+    data = mapped;
+    size = st.st_size;
+
+    const unsigned char* base = (const unsigned char*)data;
+    header = (const AssetPackHeader*)base;
+    if (header->magic != ASSET_PACK_MAGIC || header->version < 1 ||
+        header->version > ASSET_PACK_VERSION) {
+        fprintf(stderr, "Not a version %u asset pack: %s\n", ASSET_PACK_VERSION, path.c_str());
+        close();
+        return false;
+    }
+
+    size_t tableEnd = sizeof(AssetPackHeader) + (size_t)header->entryCount * sizeof(AssetPackEntry);
+    if (header->entryCount > 4096 || tableEnd > size) {
+        fprintf(stderr, "Corrupt asset table: %s\n", path.c_str());
+        close();
+        return false;
+    }
+
+    entries = (const AssetPackEntry*)(base + sizeof(AssetPackHeader));
+    for (uint32_t i = 0; i < header->entryCount; i++) {
+        const AssetPackEntry& e = entries[i];
+        uint64_t texels = (uint64_t)e.width * e.height;
+        uint64_t paletteBytes = e.size - texels;  // Of indexed entries
+        bool sized = (e.flags & ASSET_FLAG_INDEXED) ? e.size > texels && paletteBytes <= 256 * 4 &&
+                                                          paletteBytes % 4 == 0
+                                                    : e.size == texels * 4;
+        bool ok = memchr(e.name, 0, sizeof(e.name)) != nullptr && e.frameCount > 0 &&
+                  e.offset % ASSET_PACK_ALIGN == 0 && sized && e.offset <= size &&
+                  e.size <= size - e.offset;
+        if (!ok) {
+            fprintf(stderr, "Corrupt asset %u in %s\n", i, path.c_str());
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void AssetPack::close() {
+    if (data) munmap(data, size);
+    data = nullptr;
+    size = 0;
+    header = nullptr;
+    entries = nullptr;
+}
+
+const AssetPackEntry* AssetPack::find(const std::string& name) const {
+    for (size_t i = 0; i < entryCount(); i++) {
+        if (name == entries[i].name) return &entries[i];
+    }
+    return nullptr;
+}
+
+static uint64_t alignUp(uint64_t value) {
+    return (value + ASSET_PACK_ALIGN - 1) / ASSET_PACK_ALIGN * ASSET_PACK_ALIGN;
+}
+
+bool writeAssetPack(const std::string& path, const std::vector<AssetPackImage>& images,
+                    bool flip, bool indexed) {
+    AssetPackHeader header = {};
+    header.magic = ASSET_PACK_MAGIC;
+    header.version = ASSET_PACK_VERSION;
+    header.entryCount = images.size();
+
+    // Index images that allow it; the rest stay RGBA8
+    std::vector<std::vector<uint32_t>> palettes(images.size());
+    std::vector<std::vector<unsigned char>> indices(images.size());
+    for (size_t i = 0; indexed && i < images.size(); i++) {
+        const AssetPackImage& image = images[i];
+        if (!indexColors(image.rgba.data(), image.width * image.height, palettes[i], indices[i])) {
+            palettes[i].clear();
+            indices[i].clear();
+        }
+    }
+
+    std::vector<AssetPackEntry> table(images.size());
+    uint64_t offset = alignUp(sizeof(header) + table.size() * sizeof(AssetPackEntry));
+    for (size_t i = 0; i < images.size(); i++) {
+        const AssetPackImage& image = images[i];
+        AssetPackEntry& e = table[i];
+        memset(&e, 0, sizeof(e));
+        if (image.name.size() >= sizeof(e.name)) {
+            fprintf(stderr, "Asset name too long: %s\n", image.name.c_str());
+            return false;
+        }
+        strcpy(e.name, image.name.c_str());
+        e.width = image.width;
+        e.height = image.height;
+        e.frameCount = image.frameCount;
+        e.flags = flip ? ASSET_FLAG_FLIPPED : 0;
+        e.offset = offset;
+        e.size = image.rgba.size();
+        if (!indices[i].empty()) {
+            e.flags |= ASSET_FLAG_INDEXED;
+            e.size = palettes[i].size() * 4 + indices[i].size();
+        }
+        offset = alignUp(offset + e.size);
+    }
+
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) {
+        fprintf(stderr, "Failed to write asset pack: %s\n", path.c_str());
+        return false;
+    }
+
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+              (table.empty() || fwrite(table.data(), sizeof(AssetPackEntry), table.size(), f) ==
+                                    table.size());
+    for (size_t i = 0; ok && i < images.size(); i++) {
+        const AssetPackImage& image = images[i];
+        bool isIndexed = !indices[i].empty();
+        const unsigned char* texels = isIndexed ? indices[i].data() : image.rgba.data();
+        size_t row = (size_t)image.width * (isIndexed ? 1 : 4);
+        ok = fseek(f, (long)table[i].offset, SEEK_SET) == 0;
+        if (ok && isIndexed) {
+            ok = fwrite(palettes[i].data(), 4, palettes[i].size(), f) == palettes[i].size();
+        }
+        for (int y = 0; ok && y < image.height; y++) {
+            int source = flip ? image.height - 1 - y : y;
+            ok = fwrite(texels + source * row, 1, row, f) == row;
+        }
+    }
+    ok = (fclose(f) == 0) && ok;
+
+    if (!ok) fprintf(stderr, "Failed to write asset pack: %s\n", path.c_str());
+    return ok;
+}
@@ -0,0 +1,315 @@
+#define GL_GLEXT_PROTOTYPES  // Shader and multitexture entry points (GL 2.0)
+#include "backend.h"
+#include "glut_fonts.h"
+#include <GL/glut.h>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <memory>
+
+// ─────────────────────────────────────────
+// Fixed function
+// ─────────────────────────────────────────
+
+// Index texels are 0-255 as fractions of 1; each row of the palette is one variant
+static const char* const PALETTE_SHADER =
+    "uniform sampler2D indices;\n"
+    "uniform sampler2D palette;\n"
+    "uniform float paletteSize;\n"
+    "uniform float paletteRow;\n"
+    "void main() {\n"
+    "    float index = texture2D(indices, gl_TexCoord[0].st).r * 255.0;\n"
+    "    vec2 entry = vec2((index + 0.5) / paletteSize, paletteRow);\n"
+    "    gl_FragColor = texture2D(palette, entry) * gl_Color;\n"
+    "}\n";
+
+static bool glutText = true;  // setGlutText()
+
+class FixedFunctionBackend : public RenderBackend {
+   private:
+    bool textured;
+    bool paletteShaderTried;
+    GLuint paletteShader;  // 0 if the GL has none
+    GLint paletteSizeLocation, paletteRowLocation;
+    bool paletteBound;
+    GLuint recording;                     // Display list being compiled, 0 if none
+    RenderStats unretained;               // Frame stats while it is
+    std::map<GLuint, long> listVertices;  // Of each retained list
+
+    static GLenum mode(Primitive primitive) {
+        switch (primitive) {
+            case Primitive::POINTS:
+                return GL_POINTS;
+            case Primitive::LINES:
+                return GL_LINES;
+            default:
+                return GL_QUADS;
+        }
+    }
+
+   protected:
+    void submit(Primitive primitive, const Vertex* vertices, size_t count) override {
+        glBegin(mode(primitive));
+        for (size_t i = 0; i < count; i++) {
+            if (textured) glTexCoord2f(vertices[i].u, vertices[i].v);
+            glVertex2f(vertices[i].x, vertices[i].y);
+        }
+        glEnd();
+        frameStats.drawCalls++;
+        frameStats.vertices += count;
+    }
+
+   public:
+    FixedFunctionBackend()
+        : textured(false),
+          paletteShaderTried(false),
+          paletteShader(0),
+          paletteSizeLocation(-1),
+          paletteRowLocation(-1),
+          paletteBound(false),
+          recording(0),
+          unretained() {}
+
+    const char* getName() const override { return "fixed function"; }
+
+    bool init() override {
+        glPointSize(1.0f);
+        glLineWidth(1.0f);
+        glEnable(GL_POINT_SMOOTH);
+        glEnable(GL_LINE_SMOOTH);
+        glHint(GL_POINT_SMOOTH_HINT, GL_NICEST);
+        glHint(GL_LINE_SMOOTH_HINT, GL_NICEST);
+        return true;
+    }
+
+    void beginFrame(int width, int height) override {
+        frameStats = RenderStats();
+        glClear(GL_COLOR_BUFFER_BIT);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        glMatrixMode(GL_PROJECTION);
+        glLoadIdentity();
+        glOrtho(0, width, 0, height, -1, 1);
+        glMatrixMode(GL_MODELVIEW);
+        glLoadIdentity();
+    }
+
+    void endFrame() override {
+        glDisable(GL_BLEND);
+        stats = frameStats;
+    }
+
+    void translate(float x, float y) override { glTranslatef(x, y, 0); }
+    void color(float r, float g, float b, float a) override { glColor4f(r, g, b, a); }
+    void pointSize(float size) override { glPointSize(size); }
+
+    // Compile the lookup shader the first time a sprite could use it
+    bool hasPaletteLookup() override {
+        if (paletteShaderTried) return paletteShader != 0;
+        paletteShaderTried = true;
+
+        const char* version = (const char*)glGetString(GL_VERSION);
+        int major = 0;
+        if (!version || sscanf(version, "%d", &major) != 1 || major < 2) return false;
+
+        GLuint shader = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(shader, 1, &PALETTE_SHADER, nullptr);
+        glCompileShader(shader);
+        GLint ok = GL_FALSE;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+        GLuint program = glCreateProgram();
+        if (ok) {
+            // Fragment stage only; vertices still go through the fixed pipeline
+            glAttachShader(program, shader);
+            glLinkProgram(program);
+            glGetProgramiv(program, GL_LINK_STATUS, &ok);
+        }
+        glDeleteShader(shader);
+        if (!ok) {
+            fprintf(stderr, "Palette shader unavailable; sprites stay RGBA\n");
+            glDeleteProgram(program);
+            return false;
+        }
+
+        glUseProgram(program);
+        glUniform1i(glGetUniformLocation(program, "indices"), 0);
+        glUniform1i(glGetUniformLocation(program, "palette"), 1);
+        glUseProgram(0);
+        paletteSizeLocation = glGetUniformLocation(program, "paletteSize");
+        paletteRowLocation = glGetUniformLocation(program, "paletteRow");
+        paletteShader = program;
+        return true;
+    }
+
+    bool isCoreProfile() const override { return false; }
+
+    void bindTexture(GLuint texture, GLuint palette, int paletteSize,
+                     float paletteRow) override {
+        glEnable(GL_TEXTURE_2D);
+        paletteBound = palette != 0;
+        if (paletteBound) {
+            glUseProgram(paletteShader);
+            glUniform1f(paletteSizeLocation, (float)paletteSize);
+            glUniform1f(paletteRowLocation, paletteRow);
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, palette);
+            glActiveTexture(GL_TEXTURE0);
+        }
+        glBindTexture(GL_TEXTURE_2D, texture);
+        textured = true;
+    }
+
+    void unbindTexture() override {
+        if (paletteBound) glUseProgram(0);
+        paletteBound = false;
+        glDisable(GL_TEXTURE_2D);
+        textured = false;
+    }
+
+    // Every quad between one glBegin/glEnd, the tint changing per quad
+    void drawSprites(const InstanceSet& set, const DrawInstance* instances,
+                     size_t count) override {
+        glBegin(GL_QUADS);
+        for (size_t i = 0; i < count; i++) {
+            const DrawInstance& d = instances[i];
+            float halfW = set.halfWidth * d.scale, halfH = set.halfHeight * d.scale;
+            float u0 = ((int)d.frame % set.frameCount) * set.frameWidth;
+            float u1 = u0 + set.frameWidth;
+            glColor4ub(d.color[0], d.color[1], d.color[2], d.color[3]);
+            glTexCoord2f(u0, set.vBottom);
+            glVertex2f(d.x - halfW, d.y - halfH);
+            glTexCoord2f(u1, set.vBottom);
+            glVertex2f(d.x + halfW, d.y - halfH);
+            glTexCoord2f(u1, set.vTop);
+            glVertex2f(d.x + halfW, d.y + halfH);
+            glTexCoord2f(u0, set.vTop);
+            glVertex2f(d.x - halfW, d.y + halfH);
+        }
+        glEnd();
+        frameStats.drawCalls++;
+        frameStats.vertices += (long)count * 4;
+    }
+
+    // drawCircleMidpoint's filled scan lines, every circle's between one glBegin/glEnd
+    void drawDiscs(int radius, const DrawInstance* instances, size_t count) override {
+        glBegin(GL_LINES);
+        for (size_t i = 0; i < count; i++) {
+            const DrawInstance& d = instances[i];
+            int xc = (int)d.x, yc = (int)d.y, r = (int)(radius * d.scale);
+            glColor4ub(d.color[0], d.color[1], d.color[2], d.color[3]);
+            for (int y = -r; y <= r; y++) {
+                int x = (int)sqrt(r * r - y * y);
+                glVertex2f(xc - x, yc + y);
+                glVertex2f(xc + x, yc + y);
+            }
+            frameStats.vertices += (2 * r + 1) * 2;
+        }
+        glEnd();
+        frameStats.drawCalls++;
+    }
+
+    // Retained geometry is a display list; what it was compiled from is not drawn
+    void beginRetained() override {
+        recording = glGenLists(1);
+        glNewList(recording, GL_COMPILE);
+        unretained = frameStats;
+        frameStats = RenderStats();
+    }
+
+    GLuint endRetained() override {
+        glEndList();
+        listVertices[recording] = frameStats.vertices;
+        frameStats = unretained;
+        GLuint list = recording;
+        recording = 0;
+        return list;
+    }
+
+    // The list leaves its own colour behind; the caller's is put back
+    void drawRetained(GLuint handle, float x, float y) override {
+        glPushAttrib(GL_CURRENT_BIT);
+        glPushMatrix();
+        glTranslatef(x, y, 0);
+        glCallList(handle);
+        glPopMatrix();
+        glPopAttrib();
+        frameStats.drawCalls++;
+        frameStats.vertices += listVertices[handle];
+    }
+
+    void deleteRetained(GLuint handle) override {
+        glDeleteLists(handle, 1);
+        listVertices.erase(handle);
+    }
+
+    // glutBitmapCharacter, or without GLUT what it does with the same glyphs, minus the
+    // client state push it needs no more than the unpack alignment for
+    void drawText(const char* text, float x, float y, void* font) override {
+        glRasterPos2f(x, y);
+        if (glutText) {
+            for (const char* c = text; *c; c++) {
+                glutBitmapCharacter(font, *c);
+                frameStats.drawCalls++;
+            }
+            return;
+        }
+        const BitmapFont* glyphs = bitmapFont(font);
+        if (!glyphs) return;
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        for (const unsigned char* c = (const unsigned char*)text; *c; c++) {
+            if (*c >= glyphs->quantity) continue;
+            const unsigned char* face = glyphs->glyph(*c);
+            glBitmap(face[0], glyphs->height, glyphs->xorig, glyphs->yorig, (float)face[0], 0.0f,
+                     face + 1);
+            frameStats.drawCalls++;
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    }
+};
+
+// ─────────────────────────────────────────
+// Selection
+// ─────────────────────────────────────────
+
+RenderBackend* createCoreBackend();  // corebackend.cpp
+
+static FixedFunctionBackend fixedFunction;
+static std::unique_ptr<RenderBackend> selected;
+static RenderBackend* active = &fixedFunction;
+
+RenderBackend& renderBackend() {
+    return *active;
+}
+
+bool selectRenderBackend(RendererKind kind) {
+    if (kind == RendererKind::FIXED_FUNCTION) {
+        active = &fixedFunction;
+        selected.reset();
+        return fixedFunction.init();
+    }
+    std::unique_ptr<RenderBackend> backend(createCoreBackend());
+    if (!backend->init()) return false;
+    selected = std::move(backend);
+    active = selected.get();
+    return true;
+}
+
+// ─────────────────────────────────────────
+// Fonts
+// ─────────────────────────────────────────
+
+static const BitmapFont fixed9x15 = {256, 16, fixed9x15Glyphs, fixed9x15Offsets, 0, 4};
+static const BitmapFont helvetica12 = {256, 16, helvetica12Glyphs, helvetica12Offsets, 0, 4};
+static const BitmapFont helvetica18 = {256, 23, helvetica18Glyphs, helvetica18Offsets, 0, 5};
+
+const BitmapFont* bitmapFont(void* glutFont) {
+    if (glutFont == GLUT_BITMAP_HELVETICA_18) return &helvetica18;
+    if (glutFont == GLUT_BITMAP_HELVETICA_12) return &helvetica12;
+    if (glutFont == GLUT_BITMAP_9_BY_15) return &fixed9x15;
+    return nullptr;
+}
+
+void setGlutText(bool enabled) {
+    glutText = enabled;
+}
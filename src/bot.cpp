@@ -0,0 +1,557 @@
+#include "bot.h"
+#include "constants.h"
+#include <algorithm>
+#include <cmath>
+
+static const int GIVE_UP_TICKS = 30 * BASE_TICK_RATE;  // Time allowed to get the target coin
+static const int SKIP_TICKS = 60 * BASE_TICK_RATE;     // How long a failed coin is set aside
+static const int HOP_TICKS = 5 * BASE_TICK_RATE;       // Time allowed to get going on a hop
+static const int BAN_TICKS = 30 * BASE_TICK_RATE;      // How long a hop that failed is avoided
+static const int IDLE_REPLAN_TICKS = BASE_TICK_RATE;   // Retry interval with nothing in reach
+static const size_t MAX_PLAN_NODES = 50000;            // Search budget per plan
+
+static const float COIN_REACH = 0.5f;     // Share of the jump envelope used for coins, which
+                                          // leave nowhere to land if reached at its limit
+static const float LANDING_INSET = 6.0f;  // Steer this far inside platform ends
+
+// Maneuver candidates, in updates: the first jump is tried at every JUMP_SPACING steps up to
+// MAX_FIRST_JUMP (running or waiting until then), the second at each of SECOND_JUMPS after it
+static const int MAX_FIRST_JUMP = 36;
+static const int JUMP_SPACING = 3;
+static const int SECOND_JUMPS[] = {-1, 6, 10, 14, 18, 22, 28};
+static const int MAX_MANEUVER_STEPS = 150;
+static const int WALK_STEPS = 8;  // Walked towards a goal that is too far to maneuver to
+static const int EVADE_STEPS = 30;  // Look-ahead for enemies while waiting
+
+// ─────────────────────────────────────────
+// Bot
+// ─────────────────────────────────────────
+
+Bot::Bot(int playerSlot)
+    : slot(playerSlot),
+      builtFor(nullptr),
+      builtCount(0),
+      fromNode(-1),
+      hopNode(-1),
+      targetCoin(-1),
+      planTick(0),
+      hopTick(0),
+      idleUntil(0),
+      lastTick(0),
+      lastLives(0),
+      flying(false),
+      maneuverStep(0),
+      heldDirection(0) {}
+
+void Bot::buildGraph(Game& game) {
+    const std::vector<Platform>& platforms = game.getPlatforms();
+    const std::vector<Collectible>& collectibles = game.getCollectibles();
+    graph.build(platforms, jobs);
+    enemyIndex.build(game.getEnemies());
+    builtFor = platforms.data();
+    builtCount = platforms.size();
+
+    nodeCoins.assign(graph.nodes(), std::vector<int>());
+    std::vector<int> candidates;
+    for (size_t c = 0; c < collectibles.size(); c++) {
+        const Collectible& coin = collectibles[c];
+        float y = coin.y - COIN_PICKUP_RADIUS;
+        graph.platformsNear(coin.x, coin.x, candidates);
+        for (int j : candidates) {
+            int node = j * ReachabilityGraph::NODES_PER_PLATFORM + ReachabilityGraph::NODE_TOP;
+            const NodeSpan& top = graph.span(node);
+            float reach = ReachabilityGraph::envelope().reach(TakeOff::GROUND, y - top.y);
+            if (reach < 0 || coin.x < top.left - reach * COIN_REACH ||
+                coin.x > top.right + reach * COIN_REACH) {
+                continue;
+            }
+
+            // A platform in the way (the coin usually sits on it) has to be landed on first
+            bool blocked = false;
+            for (int k : candidates) {
+                const NodeSpan& other = graph.span(k * ReachabilityGraph::NODES_PER_PLATFORM +
+                                                   ReachabilityGraph::NODE_TOP);
+                blocked |= other.y > top.y + 1.0f && other.y - PLAYER_HALF_HEIGHT < coin.y &&
+                           coin.x > other.left && coin.x < other.right;
+            }
+            if (!blocked) nodeCoins[node].push_back(c);
+        }
+    }
+
+    skipUntil.assign(collectibles.size(), 0);
+    parent.assign(graph.nodes(), -1);
+    bannedHops.clear();
+    fromNode = hopNode = targetCoin = -1;
+    flying = false;
+}
+
+// Node the player is on: a platform top it stands on or a face it slides down. -1 in the air.
+int Bot::currentNode(Game& game) const {
+    const Player& player = self(game);
+    const std::vector<Platform>& platforms = game.getPlatforms();
+    if (!player.onGround && !player.wallSliding) return -1;
+
+    std::vector<int> candidates;
+    graph.platformsNear(player.x, player.x, candidates);
+    float feet = player.y - PLAYER_HALF_HEIGHT;
+    int tick = game.getTick();
+    for (int j : candidates) {
+        const Platform& p = platforms[j];
+        float px = p.xAt(tick);
+        int base = j * ReachabilityGraph::NODES_PER_PLATFORM;
+        if (player.onGround) {
+            if (player.x + PLAYER_HALF_WIDTH > px && player.x - PLAYER_HALF_WIDTH < px + p.width &&
+                fabs(feet - (p.y + p.height)) <= 1.0f) {
+                return base + ReachabilityGraph::NODE_TOP;
+            }
+        } else if (player.y > p.y - PLAYER_HALF_HEIGHT &&
+                   player.y < p.y + p.height + PLAYER_HALF_HEIGHT) {
+            // Wall on the right is the platform's left face, and the other way round
+            float side = player.x + player.wallDirection * PLAYER_HALF_WIDTH;
+            if (player.wallDirection > 0 && fabs(side - px) <= 1.0f) {
+                return base + ReachabilityGraph::NODE_LEFT_FACE;
+            }
+            if (player.wallDirection < 0 && fabs(side - (px + p.width)) <= 1.0f) {
+                return base + ReachabilityGraph::NODE_RIGHT_FACE;
+            }
+        }
+    }
+    return -1;
+}
+
+bool Bot::banned(int from, int to, int tick) const {
+    for (const BannedHop& b : bannedHops) {
+        if (b.from == from && b.to == to && b.until > tick) return true;
+    }
+    return false;
+}
+
+// Fewest-hops search from `node` to a top that can collect a coin still worth trying
+void Bot::plan(Game& game, int node) {
+    const std::vector<Collectible>& collectibles = game.getCollectibles();
+    const Player& player = self(game);
+    int tick = game.getTick();
+    const NodeGraph& edges = graph.edges();
+
+    bannedHops.erase(std::remove_if(bannedHops.begin(), bannedHops.end(),
+                                    [tick](const BannedHop& b) { return b.until <= tick; }),
+                     bannedHops.end());
+
+    int previousCoin = targetCoin, previousHop = hopNode, previousFrom = fromNode;
+    fromNode = node;
+    hopNode = -1;
+    targetCoin = -1;
+
+    queue.clear();
+    queue.push_back(node);
+    parent[node] = node;
+    int goal = -1;
+    for (size_t head = 0; head < queue.size() && queue.size() < MAX_PLAN_NODES; head++) {
+        int n = queue[head];
+        float best = 1e30f;
+        for (int c : nodeCoins[n]) {
+            if (collectibles[c].collected || skipUntil[c] > tick) continue;
+            float distance = fabs(collectibles[c].x - player.x);
+            if (distance < best) {
+                best = distance;
+                targetCoin = c;
+            }
+        }
+        if (targetCoin >= 0) {
+            goal = n;
+            break;
+        }
+        for (size_t e = edges.offsets[n]; e < edges.offsets[n + 1]; e++) {
+            int next = edges.targets[e];
+            if (parent[next] >= 0 || banned(n, next, tick)) continue;
+            parent[next] = n;
+            queue.push_back(next);
+        }
+    }
+
+    // First hop on the way to the goal
+    for (int n = goal; n >= 0 && n != node; n = parent[n]) {
+        if (parent[n] == node) hopNode = n;
+    }
+    for (int n : queue) parent[n] = -1;
+
+    if (targetCoin != previousCoin || targetCoin < 0) planTick = tick;
+    if (hopNode != previousHop || fromNode != previousFrom) hopTick = tick;
+}
+
+// Has the player got where the current hop goes? Coins count once the player is down again.
+bool Bot::reached(Game& game, const Player& player, int tick, bool collected) const {
+    if (hopNode < 0) return collected && player.onGround;
+
+    const Platform& p = game.getPlatforms()[ReachabilityGraph::platformOf(hopNode)];
+    float px = p.xAt(tick);
+    // A face only counts with the player level with it, not grazing its corner on the way down
+    bool level = player.y > p.y && player.y < p.y + p.height + PLAYER_HALF_HEIGHT;
+    switch (hopNode % ReachabilityGraph::NODES_PER_PLATFORM) {
+        case ReachabilityGraph::NODE_TOP:
+            return player.onGround &&
+                   fabs(player.y - PLAYER_HALF_HEIGHT - (p.y + p.height)) <= 1.0f &&
+                   player.x + PLAYER_HALF_WIDTH > px && player.x - PLAYER_HALF_WIDTH < px + p.width;
+        case ReachabilityGraph::NODE_LEFT_FACE:
+            return player.wallSliding && level && player.wallDirection > 0 &&
+                   fabs(player.x + PLAYER_HALF_WIDTH - px) <= 1.0f;
+        default:
+            return player.wallSliding && level && player.wallDirection < 0 &&
+                   fabs(player.x - PLAYER_HALF_WIDTH - (px + p.width)) <= 1.0f;
+    }
+}
+
+// Direction to hold and whether to jump at `step` of a maneuver. Shared by the simulation
+// and the real run, so both see the same inputs.
+int Bot::input(Game& game, const Maneuver& m, int step, const Player& player, int tick,
+               bool& jump) const {
+    jump = step == m.firstJump ||
+           (m.firstJump >= 0 && m.secondJump >= 0 && step == m.firstJump + m.secondJump);
+
+    // Once in the air above the goal, steer onto it
+    int kind = hopNode % ReachabilityGraph::NODES_PER_PLATFORM;
+    if (player.onGround || targetCoin < 0 ||
+        (hopNode >= 0 && kind != ReachabilityGraph::NODE_TOP)) {
+        return m.direction;
+    }
+    float lo, hi, y;
+    if (hopNode >= 0) {
+        const Platform& p = game.getPlatforms()[ReachabilityGraph::platformOf(hopNode)];
+        float px = p.xAt(tick), inset = std::min(LANDING_INSET, p.width / 2);
+        lo = px + inset;
+        hi = px + p.width - inset;
+        y = p.y + p.height + PLAYER_HALF_HEIGHT;
+    } else {
+        const Collectible& coin = game.getCollectibles()[targetCoin];
+        lo = hi = coin.x;
+        y = coin.y - COIN_PICKUP_RADIUS;
+    }
+    if (player.y < y) return m.direction;
+    return player.x < lo - 1.0f ? 1 : (player.x > hi + 1.0f ? -1 : 0);
+}
+
+// Fly a maneuver on a copy of the player, stepping it exactly as Game::update does. For a
+// HOP, returns the steps until the hop's goal is reached, or -1 if the player dies, is hurt
+// or comes down anywhere else first. Otherwise returns maxSteps if the player meets `goal`
+// for that long, or -1.
+int Bot::simulate(Game& game, const Maneuver& m, int maxSteps, SimGoal goal) {
+    const std::vector<Platform>& platforms = game.getPlatforms();
+    const std::vector<Enemy>& enemies = game.getEnemies();
+    int step = BASE_TICK_RATE / game.getTickRate();
+    int tick = game.getTick();
+    Player player = self(game);
+    bool airborne = !player.onGround, collected = false;
+    stomped.assign(localEnemies.size(), 0);
+
+    for (int s = 0; s < maxSteps; s++) {
+        bool jump;
+        int direction = input(game, m, s, player, tick, jump);
+        if (jump) {
+            if (player.wallSliding) {
+                player.wallJump();
+            } else if (player.jumpCount < Player::maxJumps) {
+                player.jump();
+            }
+        }
+        if (direction < 0) {
+            player.moveLeft();
+        } else if (direction > 0) {
+            player.moveRight();
+        } else {
+            player.stopMoving();
+        }
+
+        player.update(step);
+        int fromTick = tick;
+        tick += step;
+        reachScratch.clear();
+        platformsInReach(player, platforms, localPlatforms, reachScratch);
+        sweepPlayer(player, platforms, reachScratch, fromTick, tick);
+
+        // Enemy contact, as Game::checkEnemyCollisions resolves it
+        Box box = playerBox(player);
+        for (size_t k = 0; k < localEnemies.size(); k++) {
+            const Enemy& e = enemies[localEnemies[k]];
+            if (!e.alive || stomped[k]) continue;
+            bool facingRight;
+            float ex = e.type == EnemyType::PATROL
+                           ? patrolX(e.spawnX, e.patrolLeft, e.patrolRight, tick + e.phase,
+                                     facingRight)
+                           : e.spawnX;
+            float halfWidth = e.width / 2, halfHeight = e.height / 2;
+            if (box.right > ex - halfWidth && box.left < ex + halfWidth &&
+                box.top > e.y - halfHeight && box.bottom < e.y + halfHeight) {
+                if (player.vy < 0 && box.bottom > e.y - halfHeight + halfHeight * 0.6f) {
+                    player.vy = 12.0f;
+                    player.jumpCount = 0;
+                    stomped[k] = 1;
+                } else {
+                    return -1;
+                }
+            }
+        }
+
+        if (goal == SimGoal::HOP && hopNode < 0) {
+            const Collectible& coin = game.getCollectibles()[targetCoin];
+            float dx = player.x - coin.x, dy = player.y - coin.y;
+            collected |= dx * dx + dy * dy < COIN_PICKUP_RADIUS * COIN_PICKUP_RADIUS;
+        }
+        if (player.y < FALL_DEATH_Y) return -1;
+        if (!player.onGround) airborne = true;
+
+        if (goal == SimGoal::WALK) {
+            if (airborne) return -1;
+        } else if (goal == SimGoal::HOP) {
+            if (reached(game, player, tick, collected)) return s + 1;
+            if (airborne && player.onGround) return -1;
+        }
+    }
+    return goal == SimGoal::HOP ? -1 : maxSteps;
+}
+
+// Platforms and enemies a maneuver from here can meet
+void Bot::gatherNearby(Game& game) {
+    const Player& player = self(game);
+    float travel = PLAYER_SPEED * MAX_MANEUVER_STEPS * (BASE_TICK_RATE / game.getTickRate());
+    graph.platformsNear(player.x - travel, player.x + travel, localPlatforms);
+    enemyIndex.query(player.x - travel, player.x + travel, localEnemies);
+}
+
+// Search the maneuver candidates for the hop, earliest take-off first
+bool Bot::findManeuver(Game& game) {
+    const Player& player = self(game);
+    int step = BASE_TICK_RATE / game.getTickRate();
+    gatherNearby(game);
+
+    float goalLeft, goalRight, goalY;
+    if (hopNode >= 0) {
+        const Platform& p = game.getPlatforms()[ReachabilityGraph::platformOf(hopNode)];
+        goalLeft = p.xAt(game.getTick());
+        goalRight = goalLeft + p.width;
+        goalY = graph.span(hopNode).y;
+    } else {
+        goalLeft = goalRight = game.getCollectibles()[targetCoin].x;
+        goalY = game.getCollectibles()[targetCoin].y - COIN_PICKUP_RADIUS;
+    }
+    int toward = (goalLeft + goalRight) / 2 < player.x ? -1 : 1;
+
+    // Out of range even after running up: walk closer first
+    float reach = ReachabilityGraph::envelope().reach(TakeOff::GROUND, goalY - player.y);
+    float gap = std::max(goalLeft - player.x, player.x - goalRight);
+    if (gap > std::max(reach, 0.0f) + PLAYER_SPEED * MAX_FIRST_JUMP * step) {
+        maneuver = {toward, -1, -1, WALK_STEPS};
+        return simulate(game, maneuver, WALK_STEPS, SimGoal::WALK) > 0;
+    }
+
+    const int directions[] = {toward, 0, -toward};
+    for (int d : directions) {
+        Maneuver m = {d, -1, -1, 0};
+        int steps = simulate(game, m, MAX_MANEUVER_STEPS, SimGoal::HOP);
+        if (steps > 0) {
+            maneuver = m;
+            maneuver.steps = steps;
+            return true;
+        }
+    }
+    for (int first = 0; first <= MAX_FIRST_JUMP; first += JUMP_SPACING) {
+        for (int d : directions) {
+            for (int second : SECOND_JUMPS) {
+                Maneuver m = {d, first, second, 0};
+                int steps = simulate(game, m, MAX_MANEUVER_STEPS, SimGoal::HOP);
+                if (steps > 0) {
+                    maneuver = m;
+                    maneuver.steps = steps;
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+// Waiting with nothing to do: stay put unless an enemy is about to walk in, then get out of
+// its way or jump on it. False if nothing keeps the player safe.
+bool Bot::evade(Game& game) {
+    gatherNearby(game);
+    const Maneuver candidates[] = {{0, -1, -1, 0}, {-1, -1, -1, 0}, {1, -1, -1, 0},
+                                   {0, 0, -1, 0},  {-1, 0, -1, 0},  {1, 0, -1, 0},
+                                   {-1, 0, 10, 0}, {1, 0, 10, 0}};
+    for (const Maneuver& m : candidates) {
+        if (simulate(game, m, EVADE_STEPS, SimGoal::SURVIVE) > 0) {
+            maneuver = m;
+            maneuver.steps = m.firstJump < 0 ? 1 : EVADE_STEPS;
+            return true;
+        }
+    }
+    return false;
+}
+
+void Bot::hold(Game& game, int direction) {
+    if (direction == heldDirection) return;
+    if (heldDirection < 0) game.handleKeyUp('a');
+    if (heldDirection > 0) game.handleKeyUp('d');
+    if (direction < 0) game.handleKeyDown('a');
+    if (direction > 0) game.handleKeyDown('d');
+    heldDirection = direction;
+}
+
+void Bot::act(Game& game) {
+    switch (game.getState()) {
+        case GameState::MENU:
+            game.handleKeyDown(13);
+            game.handleKeyUp(13);
+            return;
+        case GameState::GAME_OVER:
+        case GameState::WIN:
+            game.handleKeyDown('r');
+            game.handleKeyUp('r');
+            return;
+        case GameState::PAUSED:
+            return;
+        case GameState::PLAYING:
+            break;
+    }
+
+    InputBits input = decide(game);
+    hold(game, (input & INPUT_LEFT) ? -1 : (input & INPUT_RIGHT) ? 1 : 0);
+    if (input & INPUT_JUMP) {
+        game.handleKeyDown(' ');
+        game.handleKeyUp(' ');
+    }
+    game.processInput();
+}
+
+InputBits Bot::decide(Game& game) {
+    if (game.getState() != GameState::PLAYING) return 0;
+
+    const std::vector<Platform>& platforms = game.getPlatforms();
+    const std::vector<Collectible>& collectibles = game.getCollectibles();
+    if (platforms.data() != builtFor || platforms.size() != builtCount ||
+        collectibles.size() != skipUntil.size()) {
+        buildGraph(game);
+    }
+
+    int tick = game.getTick();
+    if (tick < lastTick) {
+        // Restarted: every coin is back
+        std::fill(skipUntil.begin(), skipUntil.end(), 0);
+        bannedHops.clear();
+        fromNode = hopNode = targetCoin = -1;
+        flying = false;
+        idleUntil = 0;
+    } else if (game.getLives() < lastLives) {
+        // Hurt on the way: try something else first
+        if (targetCoin >= 0) skipUntil[targetCoin] = tick + SKIP_TICKS;
+        fromNode = hopNode = targetCoin = -1;
+        flying = false;
+    }
+    lastTick = tick;
+    lastLives = game.getLives();
+
+    const Player& player = self(game);
+    if (!flying) {
+        int node = currentNode(game);
+        bool waiting = node < 0 || tick < idleUntil;
+        if (!waiting) {
+            if (targetCoin >= 0 && tick - planTick > GIVE_UP_TICKS) {
+                skipUntil[targetCoin] = tick + SKIP_TICKS;
+            }
+            plan(game, node);
+            if (targetCoin < 0) {
+                idleUntil = tick + IDLE_REPLAN_TICKS;
+                waiting = true;
+            } else if (tick - hopTick > HOP_TICKS || !findManeuver(game)) {
+                // This hop does not work out from here: route around it for a while
+                if (hopNode >= 0) {
+                    bannedHops.push_back({fromNode, hopNode, tick + BAN_TICKS});
+                } else {
+                    skipUntil[targetCoin] = tick + SKIP_TICKS;
+                }
+                fromNode = hopNode = targetCoin = -1;
+                waiting = true;
+            }
+        }
+
+        // Airborne off-plan (respawning, knocked back) or nothing to do for now
+        if (waiting && (node < 0 || !evade(game))) return 0;
+        flying = true;
+        maneuverStep = 0;
+    }
+
+    bool jump;
+    int direction = input(game, maneuver, maneuverStep, player, tick, jump);
+    if (++maneuverStep >= maneuver.steps) flying = false;
+    return (direction < 0 ? INPUT_LEFT : direction > 0 ? INPUT_RIGHT : 0) | (jump ? INPUT_JUMP : 0);
+}
+
+// ─────────────────────────────────────────
+// Physics checks
+// ─────────────────────────────────────────
+
+static const float PENETRATION_SLOP = 1.0f;  // Overlap below this is rounding, not a fault
+
+PhysicsMonitor::PhysicsMonitor()
+    : builtFor(nullptr), builtCount(0), tracking(false), lastTick(0), lastLives(0) {}
+
+void PhysicsMonitor::check(Game& game, std::vector<Anomaly>& out) {
+    if (game.getState() != GameState::PLAYING) {
+        tracking = false;
+        return;
+    }
+
+    const std::vector<Platform>& platforms = game.getPlatforms();
+    if (platforms.data() != builtFor || platforms.size() != builtCount) {
+        index.build(platforms);
+        builtFor = platforms.data();
+        builtCount = platforms.size();
+        tracking = false;
+    }
+
+    const Player& player = game.getPlayer();
+    int tick = game.getTick();
+    if (!std::isfinite(player.x) || !std::isfinite(player.y) || !std::isfinite(player.vx) ||
+        !std::isfinite(player.vy)) {
+        out.push_back({tick, "non-finite player state", player.x, player.y});
+        tracking = false;
+        return;
+    }
+
+    Box box = playerBox(player);
+    // Positions are only comparable between consecutive ticks of one life
+    bool comparable = tracking && tick > lastTick && game.getLives() == lastLives;
+
+    float left = box.left, right = box.right;
+    if (comparable) {
+        left = std::min(left, lastBox.left);
+        right = std::max(right, lastBox.right);
+    }
+    index.query(left, right, nearby);
+    for (int i : nearby) {
+        const Platform& p = platforms[i];
+        Box platform = {p.xAt(tick), p.y, p.xAt(tick) + p.width, p.y + p.height};
+
+        float depthX = std::min(box.right, platform.right) - std::max(box.left, platform.left);
+        float depthY = std::min(box.top, platform.top) - std::max(box.bottom, platform.bottom);
+        if (depthX > PENETRATION_SLOP && depthY > PENETRATION_SLOP) {
+            out.push_back({tick, "inside platform", player.x, player.y});
+            continue;
+        }
+
+        // Crossing a static platform in one step while over it the whole way
+        if (!comparable || p.isMoving) continue;
+        bool spanned = std::max(box.left, lastBox.left) < platform.right &&
+                       std::min(box.right, lastBox.right) > platform.left;
+        if (!spanned) continue;
+        if (lastBox.bottom >= platform.top - PENETRATION_SLOP && box.top <= platform.bottom) {
+            out.push_back({tick, "fell through platform", player.x, player.y});
+        } else if (lastBox.top <= platform.bottom + PENETRATION_SLOP &&
+                   box.bottom >= platform.top) {
+            out.push_back({tick, "passed up through platform", player.x, player.y});
+        }
+    }
+
+    tracking = true;
+    lastBox = box;
+    lastTick = tick;
+    lastLives = game.getLives();
+}
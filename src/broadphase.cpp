@@ -0,0 +1,114 @@
+#include "broadphase.h"
+#include <algorithm>
+
+SweepAndPrune::SweepAndPrune() : removed(0), maxWidth(0), widthStale(false) {}
+
+void SweepAndPrune::setSlot(Entity e, uint32_t slot) {
+    if (!e.valid()) return;
+    if (e.index >= slots.size()) slots.resize(e.index + 1, NO_ENTITY);
+    slots[e.index] = slot;
+}
+
+bool SweepAndPrune::contains(Entity e) const {
+    return e.index < slots.size() && slots[e.index] != NO_ENTITY &&
+           proxies[slots[e.index]].entity == e;
+}
+
+void SweepAndPrune::insert(Entity e, float minX, float maxX) {
+    Proxy p = {minX, maxX, e};
+    added.push_back(p);
+    maxWidth = std::max(maxWidth, maxX - minX);
+}
+
+void SweepAndPrune::remove(Entity e) {
+    if (contains(e)) {
+        Proxy& p = proxies[slots[e.index]];
+        if (p.maxX - p.minX >= maxWidth) widthStale = true;
+        p.entity = Entity();
+        slots[e.index] = NO_ENTITY;
+        removed++;
+        return;
+    }
+    for (size_t i = 0; i < added.size(); i++) {
+        if (added[i].entity == e) {
+            if (added[i].maxX - added[i].minX >= maxWidth) widthStale = true;
+            added[i] = added.back();
+            added.pop_back();
+            return;
+        }
+    }
+}
+
+// Drop removed proxies and merge in the inserted ones. Only runs after spawns and
+// despawns, which arrive in batches as the activity region slides.
+void SweepAndPrune::flush() {
+    if (widthStale) {
+        maxWidth = 0;
+        for (const Proxy& p : proxies) {
+            if (p.entity.valid()) maxWidth = std::max(maxWidth, p.maxX - p.minX);
+        }
+        for (const Proxy& p : added) maxWidth = std::max(maxWidth, p.maxX - p.minX);
+        widthStale = false;
+    }
+    if (added.empty() && removed == 0) return;
+
+    if (removed > 0) {
+        proxies.erase(std::remove_if(proxies.begin(), proxies.end(),
+                                     [](const Proxy& p) { return !p.entity.valid(); }),
+                      proxies.end());
+        removed = 0;
+    }
+
+    auto less = [](const Proxy& a, const Proxy& b) { return a.minX < b.minX; };
+    std::sort(added.begin(), added.end(), less);
+    size_t middle = proxies.size();
+    proxies.insert(proxies.end(), added.begin(), added.end());
+    std::inplace_merge(proxies.begin(), proxies.begin() + middle, proxies.end(), less);
+    added.clear();
+
+    for (uint32_t i = 0; i < proxies.size(); i++) setSlot(proxies[i].entity, i);
+}
+
+void SweepAndPrune::move(Entity e, float minX, float maxX) {
+    flush();
+    if (!contains(e)) return;
+
+    uint32_t slot = slots[e.index];
+    proxies[slot].minX = minX;
+    proxies[slot].maxX = maxX;
+    maxWidth = std::max(maxWidth, maxX - minX);
+
+    // Insertion sort step: swap toward the new position, fixing the neighbours' slots
+    while (slot > 0 && minX < proxies[slot - 1].minX) {
+        std::swap(proxies[slot], proxies[slot - 1]);
+        setSlot(proxies[slot].entity, slot);
+        slot--;
+    }
+    while (slot + 1 < proxies.size() && proxies[slot + 1].minX < minX) {
+        std::swap(proxies[slot], proxies[slot + 1]);
+        setSlot(proxies[slot].entity, slot);
+        slot++;
+    }
+    slots[e.index] = slot;
+}
+
+void SweepAndPrune::clear() {
+    proxies.clear();
+    added.clear();
+    slots.clear();
+    removed = 0;
+    maxWidth = 0;
+    widthStale = false;
+}
+
+void SweepAndPrune::query(float minX, float maxX, std::vector<Entity>& out) {
+    flush();
+    out.clear();
+
+    // Any proxy reaching minX starts at most maxWidth before it
+    auto it = std::lower_bound(proxies.begin(), proxies.end(), minX - maxWidth,
+                               [](const Proxy& p, float x) { return p.minX < x; });
+    for (; it != proxies.end() && it->minX <= maxX; ++it) {
+        if (it->maxX >= minX) out.push_back(it->entity);
+    }
+}
@@ -0,0 +1,249 @@
+#define GL_GLEXT_PROTOTYPES  // Buffer object entry points (GL 1.5/2.1)
+#include "capture.h"
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <sys/stat.h>
+#include <thread>
+
+FrameCapture::FrameCapture()
+    : format(CaptureFormat::PNG),
+      width(0),
+      height(0),
+      fps(60),
+      active(false),
+      usePbo(false),
+      frameNumber(0),
+      video(nullptr),
+      nextSequence(0),
+      nextToWrite(0),
+      stats() {
+    for (int i = 0; i < RING; i++) {
+        pbos[i] = 0;
+        ringFrame[i] = -1;
+    }
+}
+
+FrameCapture::~FrameCapture() {
+    stop();
+}
+
+// Pixel pack buffers are core in 2.1 and otherwise ARB_pixel_buffer_object
+static bool hasPixelBuffers() {
+    const char* version = (const char*)glGetString(GL_VERSION);
+    const char* extensions = (const char*)glGetString(GL_EXTENSIONS);
+    int major = 0, minor = 0;
+    if (version) sscanf(version, "%d.%d", &major, &minor);
+    if (major > 2 || (major == 2 && minor >= 1)) return true;
+    return extensions && strstr(extensions, "GL_ARB_pixel_buffer_object");
+}
+
+bool FrameCapture::start(const std::string& outputPath, CaptureFormat outputFormat, int w, int h,
+                         int framesPerSecond, int workers) {
+    stop();
+    path = outputPath;
+    format = outputFormat;
+    width = w;
+    height = h;
+    fps = framesPerSecond;
+
+    if (format == CaptureFormat::Y4M) {
+        if (width % 2 || height % 2) {
+            fprintf(stderr, "Y4M capture needs an even window size, not %dx%d\n", width, height);
+            return false;
+        }
+        video = fopen(path.c_str(), "wb");
+        if (!video) {
+            fprintf(stderr, "Cannot write %s\n", path.c_str());
+            return false;
+        }
+        // 4:2:0 with chroma sited like JPEG, full-range BT.601 (what the conversion produces)
+        fprintf(video, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg XCOLORRANGE=FULL\n", width,
+                height, fps);
+    } else {
+        mkdir(path.c_str(), 0755);
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) {
+            fprintf(stderr, "Cannot create capture directory %s\n", path.c_str());
+            return false;
+        }
+        stbi_flip_vertically_on_write(1);  // GL rows are bottom-up
+        stbi_write_png_compression_level = 2;  // Size matters less than keeping up
+    }
+
+    usePbo = hasPixelBuffers();
+    if (usePbo) {
+        size_t bytes = (size_t)width * height * 4;
+        glGenBuffers(RING, pbos);
+        for (int i = 0; i < RING; i++) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[i]);
+            glBufferData(GL_PIXEL_PACK_BUFFER, bytes, nullptr, GL_STREAM_READ);
+            ringFrame[i] = -1;
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+
+    encoders.setWorkerCount(std::max(1, workers));
+    frameNumber = 0;
+    nextSequence = nextToWrite = 0;
+    stats = CaptureStats();
+    active = true;
+    return true;
+}
+
+FrameCapture::Frame* FrameCapture::takeFrame() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (idle.empty()) {
+        if ((int)frames.size() >= MAX_PENDING) return nullptr;
+        frames.emplace_back(new Frame());
+        frames.back()->rgba.resize((size_t)width * height * 4);
+        return frames.back().get();
+    }
+    Frame* frame = idle.back();
+    idle.pop_back();
+    return frame;
+}
+
+void FrameCapture::dispatch(Frame* frame) {
+    frame->sequence = nextSequence++;
+    stats.frames++;
+    encoders.submit([this, frame]() { encode(frame); }, encoding);
+}
+
+// Map the buffer holding an earlier frame and hand its pixels to an encoder
+void FrameCapture::collect(int slot) {
+    int number = ringFrame[slot];
+    ringFrame[slot] = -1;
+    if (number < 0) return;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[slot]);
+    const void* pixels = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+    Frame* frame = pixels ? takeFrame() : nullptr;
+    if (frame) {
+        memcpy(frame->rgba.data(), pixels, frame->rgba.size());
+        frame->number = number;
+        dispatch(frame);
+    } else {
+        stats.dropped++;
+    }
+    if (pixels) glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+}
+
+void FrameCapture::captureFrame() {
+    if (!active) return;
+    auto start = std::chrono::steady_clock::now();
+
+    int number = frameNumber++;
+    if (usePbo) {
+        // The buffer about to be reused holds the frame from RING frames ago
+        int slot = number % RING;
+        collect(slot);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[slot]);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        ringFrame[slot] = number;
+    } else if (Frame* frame = takeFrame()) {
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, frame->rgba.data());
+        frame->number = number;
+        dispatch(frame);
+    } else {
+        stats.dropped++;
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+                    .count();
+    stats.gameMs += ms;
+    stats.maxGameMs = std::max(stats.maxGameMs, ms);
+}
+
+// Full-range BT.601, 8.8 fixed point. Chroma is the average of each 2x2 block.
+static void rgbaToYuv420(const uint8_t* rgba, int width, int height, uint8_t* yuv) {
+    uint8_t* yPlane = yuv;
+    uint8_t* uPlane = yuv + width * height;
+    uint8_t* vPlane = uPlane + (width / 2) * (height / 2);
+
+    for (int y = 0; y < height; y += 2) {
+        // Y4M rows run top-down, GL rows bottom-up
+        const uint8_t* rows[2] = {rgba + (size_t)(height - 1 - y) * width * 4,
+                                  rgba + (size_t)(height - 2 - y) * width * 4};
+        for (int x = 0; x < width; x += 2) {
+            int r = 0, g = 0, b = 0;
+            for (int dy = 0; dy < 2; dy++) {
+                for (int dx = 0; dx < 2; dx++) {
+                    const uint8_t* p = rows[dy] + (x + dx) * 4;
+                    yPlane[(size_t)(y + dy) * width + x + dx] =
+                        (77 * p[0] + 150 * p[1] + 29 * p[2] + 128) >> 8;
+                    r += p[0];
+                    g += p[1];
+                    b += p[2];
+                }
+            }
+            // Sums of four pixels: shift by 2 more than the 8.8 scale
+            size_t c = (size_t)(y / 2) * (width / 2) + x / 2;
+            int u = (-43 * r - 85 * g + 128 * b + 512) / 1024 + 128;
+            int v = (128 * r - 107 * g - 21 * b + 512) / 1024 + 128;
+            uPlane[c] = (uint8_t)std::min(255, std::max(0, u));
+            vPlane[c] = (uint8_t)std::min(255, std::max(0, v));
+        }
+    }
+}
+
+void FrameCapture::encode(Frame* frame) {
+    if (format == CaptureFormat::PNG) {
+        // The window's alpha is whatever blending left behind
+        for (size_t i = 3; i < frame->rgba.size(); i += 4) frame->rgba[i] = 255;
+        char name[32];
+        snprintf(name, sizeof(name), "/frame_%06d.png", frame->number);
+        bool ok = stbi_write_png((path + name).c_str(), width, height, 4, frame->rgba.data(),
+                                 width * 4) != 0;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (ok) {
+            stats.written++;
+        } else {
+            fprintf(stderr, "Failed to write %s%s\n", path.c_str(), name);
+        }
+        idle.push_back(frame);
+        return;
+    }
+
+    frame->yuv.resize((size_t)width * height * 3 / 2);
+    rgbaToYuv420(frame->rgba.data(), width, height, frame->yuv.data());
+
+    // Frames finish out of order; write every one whose predecessors are written
+    std::lock_guard<std::mutex> lock(mutex);
+    finished[frame->sequence] = frame;
+    for (auto it = finished.find(nextToWrite); it != finished.end();
+         it = finished.find(nextToWrite)) {
+        Frame* next = it->second;
+        fputs("FRAME\n", video);
+        fwrite(next->yuv.data(), 1, next->yuv.size(), video);
+        stats.written++;
+        finished.erase(it);
+        idle.push_back(next);
+        nextToWrite++;
+    }
+}
+
+// Sleeps rather than helping, so the encoding stays on the encoder threads
+void FrameCapture::waitIdle() {
+    while (!encoding.done()) std::this_thread::sleep_for(std::chrono::microseconds(200));
+}
+
+void FrameCapture::stop() {
+    if (!active) return;
+    if (usePbo) {
+        // Oldest first
+        for (int i = 0; i < RING; i++) collect((frameNumber + i) % RING);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        glDeleteBuffers(RING, pbos);
+    }
+    encoders.wait(encoding);
+    encoders.setWorkerCount(0);
+    if (video) fclose(video);
+    video = nullptr;
+    active = false;
+    frames.clear();
+    idle.clear();
+}
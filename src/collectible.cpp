@@ -1,12 +1,7 @@
 #include "collectible.h"
 
 Collectible::Collectible(float px, float py)
-    : x(px), y(py), rotation(0), bobOffset(0), collected(false), color(1.0f, 0.9f, 0.0f) {}
-
-void Collectible::update() {
-    rotation += COIN_ROTATION_SPEED;
-    bobOffset += 0.1f;
-}
+    : x(px), y(py), collected(false), color(1.0f, 0.9f, 0.0f), phase(0) {}
 
 void initializeCollectibles(std::vector<Collectible>& collectibles) {
     collectibles.clear();
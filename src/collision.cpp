@@ -0,0 +1,203 @@
+#include "collision.h"
+#include <cmath>
+#include <limits>
+
+// When the interval [aMin, aMax], moving by d, starts and stops overlapping [bMin, bMax].
+// Returns false if it never does. Already-overlapping intervals enter at -infinity.
+static bool sweepAxis(float aMin, float aMax, float bMin, float bMax, float d, float& enter,
+                      float& leave) {
+    const float inf = std::numeric_limits<float>::infinity();
+    if (aMax <= bMin + CONTACT_SKIN) {
+        if (d <= 0) return false;
+        enter = bMin - aMax > 0 ? (bMin - aMax) / d : 0;
+        leave = (bMax - aMin) / d;
+    } else if (aMin >= bMax - CONTACT_SKIN) {
+        if (d >= 0) return false;
+        enter = aMin - bMax > 0 ? (aMin - bMax) / -d : 0;
+        leave = (aMax - bMin) / -d;
+    } else {
+        enter = -inf;
+        leave = d > 0 ? (bMax - aMin) / d : (d < 0 ? (aMax - bMin) / -d : inf);
+    }
+    return true;
+}
+
+bool sweepBox(const Box& moving, float dx, float dy, const Box& target, SweepHit& hit) {
+    float enterX, leaveX, enterY, leaveY;
+    if (!sweepAxis(moving.left, moving.right, target.left, target.right, dx, enterX, leaveX)) {
+        return false;
+    }
+    if (!sweepAxis(moving.bottom, moving.top, target.bottom, target.top, dy, enterY, leaveY)) {
+        return false;
+    }
+
+    float enter = enterX > enterY ? enterX : enterY;
+    float leave = leaveX < leaveY ? leaveX : leaveY;
+    if (enter < 0 || enter > 1 || enter >= leave) return false;  // Overlapping, late or missed
+
+    hit.time = enter;
+    // Ties (exact corners) resolve vertically so running over seams never snags
+    if (enterY >= enterX) {
+        hit.normalX = 0;
+        hit.normalY = dy < 0 ? 1.0f : -1.0f;
+    } else {
+        hit.normalX = dx < 0 ? 1.0f : -1.0f;
+        hit.normalY = 0;
+    }
+    return true;
+}
+
+bool overlaps(const Box& a, const Box& b) {
+    return a.left < b.right - CONTACT_SKIN && a.right > b.left + CONTACT_SKIN &&
+           a.bottom < b.top - CONTACT_SKIN && a.top > b.bottom + CONTACT_SKIN;
+}
+
+// ─────────────────────────────────────────
+// Player against platforms
+// ─────────────────────────────────────────
+
+static Box platformBox(const Platform& platform, float x) {
+    Box box = {x, platform.y, x + platform.width, platform.y + platform.height};
+    return box;
+}
+
+Box playerBox(const Player& player) {
+    Box box = {player.x - PLAYER_HALF_WIDTH, player.y - PLAYER_HALF_HEIGHT,
+               player.x + PLAYER_HALF_WIDTH, player.y + PLAYER_HALF_HEIGHT};
+    return box;
+}
+
+void platformsInReach(const Player& player, const std::vector<Platform>& platforms,
+                      const std::vector<int>& candidates, std::vector<int>& out) {
+    Box reach = playerBox(player);
+    reach.left += fmin(player.moveX, 0);
+    reach.right += fmax(player.moveX, 0);
+    reach.bottom += fmin(player.moveY, 0);
+    reach.top += fmax(player.moveY, 0);
+    for (int i : candidates) {
+        const Platform& p = platforms[i];
+        float range = p.isMoving ? fabs(p.moveRange) : 0;
+        if (p.originalX - range <= reach.right + 1 &&
+            p.originalX + range + p.width >= reach.left - 1 && p.y <= reach.top + 1 &&
+            p.y + p.height >= reach.bottom - 1) {
+            out.push_back(i);
+        }
+    }
+}
+
+// Push the player out of platforms it overlaps at the start of a step (after a respawn or a
+// level rebuild), along the axis of least penetration
+static void separatePlayer(Player& player, const std::vector<Platform>& platforms,
+                           const std::vector<int>& nearby, int fromTick) {
+    for (int i : nearby) {
+        Box platform = platformBox(platforms[i], platforms[i].xAt(fromTick));
+        Box box = playerBox(player);
+        if (!overlaps(box, platform)) continue;
+
+        float up = platform.top - box.bottom, down = box.top - platform.bottom;
+        float left = box.right - platform.left, right = platform.right - box.left;
+        float least = fmin(fmin(up, down), fmin(left, right));
+        if (least == up) {
+            player.y += up;
+        } else if (least == down) {
+            player.y -= down;
+        } else if (least == left) {
+            player.x -= left;
+        } else {
+            player.x += right;
+        }
+    }
+}
+
+Touchdown sweepPlayer(Player& player, const std::vector<Platform>& platforms,
+                      const std::vector<int>& nearby, int fromTick, int toTick) {
+    const int MAX_CONTACTS = 4;
+
+    separatePlayer(player, platforms, nearby, fromTick);
+    player.onGround = false;
+
+    Touchdown touchdown = {false, 0, 0, 0};
+    float dx = player.moveX, dy = player.moveY;  // Displacement still to travel
+    float elapsed = 0;                           // Fraction of the step done
+    for (int contact = 0; contact < MAX_CONTACTS; contact++) {
+        Box box = playerBox(player);
+        SweepHit first = {2, 0, 0};
+        int hitPlatform = -1;
+        float hitCarryX = 0;
+        float hitEndX = 0;
+        for (int i : nearby) {
+            const Platform& platform = platforms[i];
+            float startX = platform.xAt(fromTick), endX = platform.xAt(toTick);
+            float nowX = startX + (endX - startX) * elapsed;
+            float carryX = endX - nowX;  // Platform motion over the rest of the step
+
+            SweepHit hit;
+            if (sweepBox(box, dx - carryX, dy, platformBox(platform, nowX), hit) &&
+                hit.time < first.time) {
+                first = hit;
+                hitPlatform = i;
+                hitCarryX = carryX;
+                hitEndX = endX;
+            }
+        }
+
+        if (hitPlatform < 0) {
+            player.x += dx;
+            player.y += dy;
+            break;
+        }
+
+        // Travel to the contact in the platform's frame
+        const Platform& platform = platforms[hitPlatform];
+        float platformX = hitEndX - hitCarryX * (1 - first.time);
+        player.x += dx * first.time;
+        player.y += dy * first.time;
+        elapsed += (1 - elapsed) * first.time;
+        dx *= 1 - first.time;
+        dy *= 1 - first.time;
+
+        if (first.normalY > 0) {
+            // Landing on top
+            player.y = platform.y + platform.height + PLAYER_HALF_HEIGHT;
+            if (!touchdown.landed) touchdown = {true, player.x, player.y, player.vy};
+            player.vy = 0;
+            player.onGround = true;
+            dy = 0;
+        } else if (first.normalY < 0) {
+            // Hit from below
+            player.y = platform.y - PLAYER_HALF_HEIGHT;
+            if (player.vy > 0) player.vy = 0;
+            dy = 0;
+        } else {
+            // Side collision: stay flush with the wall for the rest of the step
+            bool wallOnRight = first.normalX < 0;
+            player.x = wallOnRight ? platformX - PLAYER_HALF_WIDTH
+                                   : platformX + platform.width + PLAYER_HALF_WIDTH;
+            dx = hitCarryX * (1 - first.time);
+            player.vx = 0;
+
+            // Wall slide detection (pressing into wall while in air)
+            if (!player.onGround && player.vy < 0 && player.wallJumpCooldown <= 0) {
+                player.onWall = true;
+                player.wallSliding = true;
+                player.wallDirection = wallOnRight ? 1 : -1;
+                player.jumpCount = 0;
+            }
+        }
+    }
+
+    // Standing still on a surface is a contact too, though no motion ran into it
+    if (!player.onGround && player.vy <= 0) {
+        Box feet = playerBox(player);
+        for (int i : nearby) {
+            Box platform = platformBox(platforms[i], platforms[i].xAt(toTick));
+            if (feet.right > platform.left && feet.left < platform.right &&
+                fabs(feet.bottom - platform.top) <= CONTACT_SKIN) {
+                player.onGround = true;
+                player.vy = 0;
+                break;
+            }
+        }
+    }
+    return touchdown;
+}
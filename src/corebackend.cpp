@@ -0,0 +1,798 @@
+#define GL_GLEXT_PROTOTYPES  // GL 3.3 entry points
+#include "backend.h"
+#include <GL/glext.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+
+// ─────────────────────────────────────────
+// Core profile
+//
+// One vertex shader takes what arrives immediate-mode style, a second instanced sets; each
+// is linked with the fragment shader built three ways. Points and lines arrive as quads
+// whose `shape` carries each corner's offset from the point centre or line axis and the
+// radius or half width, and the smooth build turns that into coverage, as GL_POINT_SMOOTH /
+// GL_LINE_SMOOTH did. Filled quads skip that: the flat build passes their colour through and
+// the textured build samples `image` as RGBA, as palette indices, or as glyph coverage, per
+// batch. A batch is drawn by one build, so each is no dearer per fragment than it must be
+// (llvmpipe pays for every branch it cannot rule out). Retained geometry is batches kept in a
+// static buffer of their own, each with the build and texture it was batched under.
+// ─────────────────────────────────────────
+
+static const char* const VERTEX_SHADER =
+    "#version 330 core\n"
+    "layout(std140) uniform Camera {\n"
+    "    mat4 projection;\n"
+    "    vec4 offset;\n"
+    "};\n"
+    "layout(location = 0) in vec2 position;\n"
+    "layout(location = 1) in vec2 texCoord;\n"
+    "layout(location = 2) in vec4 color;\n"
+    "layout(location = 3) in vec4 shape;\n"
+    "out vec2 vTexCoord;\n"
+    "out vec4 vColor;\n"
+    "out vec4 vShape;\n"
+    "void main() {\n"
+    "    gl_Position = projection * vec4(position + offset.xy, 0.0, 1.0);\n"
+    "    vTexCoord = texCoord;\n"
+    "    vColor = color;\n"
+    "    vShape = shape;\n"
+    "}\n";
+
+// The same outputs for instanced sets (drawSprites, drawDiscs): four vertices per instance,
+// the corner taken from gl_VertexID, placed by the instance's position, scale and frame.
+// Sprites span `halfSize` and sample their frame; discs of radius halfSize.x get coverage.
+// Square sprites can instead be one point sprite each: a quarter of the vertices and half
+// the primitives, the frame's texture coordinates finished from gl_PointCoord.
+static const char* const INSTANCE_VERTEX_SHADER =
+    "#version 330 core\n"
+    "layout(std140) uniform Camera {\n"
+    "    mat4 projection;\n"
+    "    vec4 offset;\n"
+    "};\n"
+    "layout(location = 0) in vec4 placement;\n"
+    "layout(location = 1) in vec4 color;\n"
+    "uniform vec2 halfSize;\n"
+    "uniform float frameWidth;\n"
+    "uniform float frameCount;\n"
+    "uniform vec2 vRange;\n"
+    "uniform float fringe;\n"
+    "uniform bool pointSprites;\n"
+    "out vec2 vTexCoord;\n"
+    "out vec4 vColor;\n"
+    "out vec4 vShape;\n"
+    "void main() {\n"
+    "    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);\n"
+    "    vec2 side = corner * 2.0 - 1.0;\n"
+    "    vec2 position;\n"
+    "    if (pointSprites) {\n"
+    "        position = placement.xy;\n"
+    "        gl_PointSize = 2.0 * halfSize.x * placement.z;\n"
+    "        vTexCoord = vec2(mod(placement.w, frameCount) * frameWidth, vRange.y);\n"
+    "        vShape = vec4(frameWidth, vRange.x - vRange.y, 1.0e4, 1.0);\n"
+    "    } else if (frameWidth > 0.0) {\n"
+    "        position = placement.xy + side * halfSize * placement.z;\n"
+    "        float frame = mod(placement.w, frameCount);\n"
+    "        float u = (frame + corner.x) * frameWidth;\n"
+    "        vTexCoord = vec2(u, mix(vRange.x, vRange.y, corner.y));\n"
+    "        vShape = vec4(0.0, 0.0, 1.0e4, 1.0);\n"
+    "    } else {\n"
+    "        float radius = trunc(halfSize.x * placement.z);\n"
+    "        float reach = radius + fringe;\n"
+    "        position = trunc(placement.xy) + side * reach;\n"
+    "        vTexCoord = vec2(0.0);\n"
+    "        vShape = vec4(side * reach, radius, 0.0);\n"
+    "    }\n"
+    "    gl_Position = projection * vec4(position + offset.xy, 0.0, 1.0);\n"
+    "    vColor = color;\n"
+    "}\n";
+
+// shape: xy offset from the centre or axis in pixels, z radius, w 1 if textured. For point
+// sprites xy is the frame's extent in texture coordinates instead (top-left origin). Built
+// after a #version line defining TEXTURED, SMOOTH or neither.
+static const char* const FRAGMENT_SHADER =
+    "uniform sampler2D image;\n"
+    "uniform sampler2D palette;\n"
+    "uniform int mode;\n"
+    "uniform float paletteSize;\n"
+    "uniform float paletteRow;\n"
+    "uniform bool pointSprites;\n"
+    "in vec2 vTexCoord;\n"
+    "in vec4 vColor;\n"
+    "in vec4 vShape;\n"
+    "out vec4 fragColor;\n"
+    "void main() {\n"
+    "    vec4 color = vColor;\n"
+    "#ifdef TEXTURED\n"
+    "    vec2 texCoord = vTexCoord;\n"
+    "    if (pointSprites) texCoord += gl_PointCoord * vShape.xy;\n"
+    "    vec4 texel = texture(image, texCoord);\n"
+    "    if (mode == 1) {\n"
+    "        float index = texel.r * 255.0;\n"
+    "        color *= texture(palette, vec2((index + 0.5) / paletteSize, paletteRow));\n"
+    "    } else if (mode == 2) {\n"
+    "        color.a *= texel.r;\n"
+    "    } else {\n"
+    "        color *= texel;\n"
+    "    }\n"
+    "#endif\n"
+    "#ifdef SMOOTH\n"
+    "    color.a *= clamp(vShape.z + 0.5 - length(vShape.xy), 0.0, 1.0);\n"
+    "#endif\n"
+    "    fragColor = color;\n"
+    "}\n";
+
+// Streaming vertex buffer; orphaned when full
+static const size_t STREAM_BYTES = 4 * 1024 * 1024;
+// Quads per draw call, so 16-bit indices reach every vertex
+static const size_t BATCH_QUADS = 16384;
+// Instance buffer to start with; grows to the largest set drawn
+static const size_t INSTANCE_BYTES = 1024 * 1024;
+static const float SOLID = 1.0e4f;  // Radius of filled shapes
+// Coverage reaches zero half a pixel past the edge
+static const float FRINGE = 0.5f;
+
+class CoreBackend : public RenderBackend {
+   private:
+    struct CoreVertex {
+        float x, y, u, v;
+        uint8_t color[4];
+        float shape[4];
+    };
+
+    enum TextureMode { RGBA = 0, PALETTE = 1, COVERAGE = 2 };
+    // Fragment shader builds: filled quads flat or textured, points and lines smooth
+    enum Shading { FLAT = 0, TEXTURED = 1, SMOOTH = 2 };
+
+    struct TextureState {
+        GLuint texture, palette;
+        int mode;
+        float paletteSize, paletteRow;
+
+        bool operator==(const TextureState& o) const {
+            return texture == o.texture && palette == o.palette && mode == o.mode &&
+                   paletteSize == o.paletteSize && paletteRow == o.paletteRow;
+        }
+    };
+
+    // A linked program and its uniforms; -1 for those its build leaves out
+    struct Program {
+        GLuint id;
+        GLint modeLocation, paletteSizeLocation, paletteRowLocation;
+        GLint halfSizeLocation, frameWidthLocation, frameCountLocation, vRangeLocation;
+        GLint pointSpritesLocation;
+    };
+
+    // Glyphs of one font side by side in a coverage texture
+    struct FontAtlas {
+        GLuint texture;
+        int width, height;
+        std::vector<int> x, y;  // Of each character's bottom-left texel
+    };
+
+    // Quads of retained geometry batched under one build and texture
+    struct Segment {
+        GLint first;  // Vertex
+        GLsizei quads;
+        Shading shading;
+        TextureState texture;  // If TEXTURED
+    };
+
+    // Retained geometry: a static buffer and the vertex array reading it
+    struct Retained {
+        GLuint vao, vbo;
+        std::vector<Segment> segments;
+        long vertices;  // As submitted
+    };
+
+    Program programs[3];     // By Shading
+    Program sprites, discs;  // Instanced, TEXTURED and SMOOTH
+    float maxPointSize;
+    GLuint vao, vbo, ibo, camera;
+    GLuint instanceVao, instanceVbo;
+    size_t streamOffset;
+    size_t instanceCapacity, instanceOffset;
+    std::vector<CoreVertex> batch;
+    Shading batchShading;       // Of the vertices in `batch`
+    TextureState batchTexture;  // If TEXTURED
+    bool textured;
+    TextureState texture;       // Bound now
+    uint8_t rgba[4];
+    float size;
+    float offsetX, offsetY;
+    float projection[16];
+    std::map<void*, FontAtlas> fonts;
+    std::map<GLuint, Retained> retained;
+    GLuint nextRetained;
+    bool recording;
+    std::vector<CoreVertex> recorded;  // Batches flushed while recording
+    std::vector<Segment> segments;     // And where each starts
+    RenderStats unretained;            // Frame stats while recording
+
+    static uint8_t unorm(float value) {
+        return (uint8_t)(std::min(1.0f, std::max(0.0f, value)) * 255.0f + 0.5f);
+    }
+
+    // The quad a b c d (counter-clockwise), drawn as two triangles through the index buffer
+    void quad(const CoreVertex& a, const CoreVertex& b, const CoreVertex& c,
+              const CoreVertex& d) {
+        if (batch.size() == BATCH_QUADS * 4) flush();
+        batch.push_back(a);
+        batch.push_back(b);
+        batch.push_back(c);
+        batch.push_back(d);
+    }
+
+    CoreVertex make(float x, float y, float u, float v, float dx, float dy, float radius) const {
+        CoreVertex vertex = {x, y, u, v, {rgba[0], rgba[1], rgba[2], rgba[3]},
+                             {dx, dy, radius, textured ? 1.0f : 0.0f}};
+        return vertex;
+    }
+
+    // Before vertices drawn by `shading` are added, under the bound texture if TEXTURED
+    void use(Shading shading) {
+        bool same = shading == batchShading && (shading != TEXTURED || batchTexture == texture);
+        if (!same) flush();
+        batchShading = shading;
+        if (shading == TEXTURED) batchTexture = texture;
+    }
+
+    // Attributes of the vertex array being set up, read from the bound array buffer
+    static void pointAttributes() {
+        GLsizei stride = sizeof(CoreVertex);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(CoreVertex, x));
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(CoreVertex, u));
+        glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride,
+                              (void*)offsetof(CoreVertex, color));
+        glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, stride,
+                              (void*)offsetof(CoreVertex, shape));
+        for (int i = 0; i < 4; i++) glEnableVertexAttribArray(i);
+    }
+
+    void uploadCamera() {
+        float block[20];
+        memcpy(block, projection, sizeof(projection));
+        block[16] = offsetX;
+        block[17] = offsetY;
+        block[18] = block[19] = 0.0f;
+        glBindBuffer(GL_UNIFORM_BUFFER, camera);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(block), block);
+    }
+
+    // Texture units and uniforms for drawing with `state` through `p`, which is in use
+    static void applyTexture(const Program& p, const TextureState& state) {
+        glUniform1i(p.modeLocation, state.mode);
+        glUniform1f(p.paletteSizeLocation, state.paletteSize);
+        glUniform1f(p.paletteRowLocation, state.paletteRow);
+        if (state.palette) {
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, state.palette);
+            glActiveTexture(GL_TEXTURE0);
+        }
+        glBindTexture(GL_TEXTURE_2D, state.texture);
+    }
+
+    static bool link(Program& p, const char* vertexSource, Shading shading) {
+        static const char* const BUILDS[3] = {
+            "#version 330 core\n",
+            "#version 330 core\n#define TEXTURED\n",
+            "#version 330 core\n#define SMOOTH\n",
+        };
+        const char* sources[2][2] = {{vertexSource, ""}, {BUILDS[shading], FRAGMENT_SHADER}};
+        GLenum stages[2] = {GL_VERTEX_SHADER, GL_FRAGMENT_SHADER};
+        p.id = glCreateProgram();
+        for (int i = 0; i < 2; i++) {
+            GLuint shader = glCreateShader(stages[i]);
+            glShaderSource(shader, 2, sources[i], nullptr);
+            glCompileShader(shader);
+            GLint ok = GL_FALSE;
+            glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+            if (!ok) {
+                char log[1024] = "";
+                glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+                fprintf(stderr, "Core renderer shader failed to compile:\n%s\n", log);
+                glDeleteShader(shader);
+                return false;
+            }
+            glAttachShader(p.id, shader);
+            glDeleteShader(shader);
+        }
+        glLinkProgram(p.id);
+        GLint linked = GL_FALSE;
+        glGetProgramiv(p.id, GL_LINK_STATUS, &linked);
+        if (!linked) {
+            fprintf(stderr, "Core renderer shaders failed to link\n");
+            return false;
+        }
+        glUseProgram(p.id);
+        glUniform1i(glGetUniformLocation(p.id, "image"), 0);
+        glUniform1i(glGetUniformLocation(p.id, "palette"), 1);
+        p.modeLocation = glGetUniformLocation(p.id, "mode");
+        p.paletteSizeLocation = glGetUniformLocation(p.id, "paletteSize");
+        p.paletteRowLocation = glGetUniformLocation(p.id, "paletteRow");
+        p.halfSizeLocation = glGetUniformLocation(p.id, "halfSize");
+        p.frameWidthLocation = glGetUniformLocation(p.id, "frameWidth");
+        p.frameCountLocation = glGetUniformLocation(p.id, "frameCount");
+        p.vRangeLocation = glGetUniformLocation(p.id, "vRange");
+        p.pointSpritesLocation = glGetUniformLocation(p.id, "pointSprites");
+        glUniform1f(glGetUniformLocation(p.id, "fringe"), FRINGE);
+        glUniformBlockBinding(p.id, glGetUniformBlockIndex(p.id, "Camera"), 0);
+        return true;
+    }
+
+    // Stream `count` instances and draw them with instanced program `p`, in use with its
+    // shape uniforms set, as quads or as points; the batch must be flushed
+    void drawInstanced(const Program& p, const DrawInstance* instances, size_t count,
+                       bool points) {
+        glBindVertexArray(instanceVao);
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+        size_t bytes = count * sizeof(DrawInstance);
+        if (instanceOffset + bytes > instanceCapacity) {
+            instanceCapacity = std::max(instanceCapacity, bytes);
+            glBufferData(GL_ARRAY_BUFFER, instanceCapacity, nullptr, GL_STREAM_DRAW);
+            instanceOffset = 0;
+            frameStats.bufferOrphans++;
+        }
+        void* target = glMapBufferRange(GL_ARRAY_BUFFER, instanceOffset, bytes,
+                                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT |
+                                            GL_MAP_UNSYNCHRONIZED_BIT);
+        if (target) {
+            memcpy(target, instances, bytes);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            // No base instance before GL 4.2, so the attributes point at this set
+            GLsizei stride = sizeof(DrawInstance);
+            glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, stride,
+                                  (void*)(instanceOffset + offsetof(DrawInstance, x)));
+            glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride,
+                                  (void*)(instanceOffset + offsetof(DrawInstance, color)));
+            glUniform1i(p.pointSpritesLocation, points);
+            if (points) {
+                glDrawArraysInstanced(GL_POINTS, 0, 1, (GLsizei)count);
+            } else {
+                glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)count);
+            }
+            frameStats.drawCalls++;
+            frameStats.vertices += (long)count * (points ? 1 : 4);
+        }
+        instanceOffset += bytes;
+
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    }
+
+    void flush() {
+        if (batch.empty()) return;
+        if (recording) {
+            segments.push_back(Segment{(GLint)recorded.size(), (GLsizei)(batch.size() / 4),
+                                       batchShading, batchTexture});
+            recorded.insert(recorded.end(), batch.begin(), batch.end());
+            batch.clear();
+            return;
+        }
+        size_t bytes = batch.size() * sizeof(CoreVertex);
+        if (streamOffset + bytes > STREAM_BYTES) {
+            // Orphan: the driver hands back fresh storage while draws still read the old
+            glBufferData(GL_ARRAY_BUFFER, STREAM_BYTES, nullptr, GL_STREAM_DRAW);
+            streamOffset = 0;
+            frameStats.bufferOrphans++;
+        }
+        void* target = glMapBufferRange(GL_ARRAY_BUFFER, streamOffset, bytes,
+                                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT |
+                                            GL_MAP_UNSYNCHRONIZED_BIT);
+        if (target) {
+            memcpy(target, batch.data(), bytes);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            const Program& p = programs[batchShading];
+            glUseProgram(p.id);
+            if (batchShading == TEXTURED) applyTexture(p, batchTexture);
+            glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)(batch.size() / 4 * 6),
+                                     GL_UNSIGNED_SHORT, nullptr,
+                                     (GLint)(streamOffset / sizeof(CoreVertex)));
+            frameStats.drawCalls++;
+        }
+        streamOffset += bytes;
+        batch.clear();
+    }
+
+    // Points and lines are smooth, never textured
+    void submitPoints(const Vertex* vertices, size_t count) {
+        use(SMOOTH);
+        float radius = size * 0.5f, reach = radius + FRINGE;
+        for (size_t i = 0; i < count; i++) {
+            float x = vertices[i].x, y = vertices[i].y;
+            quad(make(x - reach, y - reach, 0, 0, -reach, -reach, radius),
+                 make(x + reach, y - reach, 0, 0, reach, -reach, radius),
+                 make(x + reach, y + reach, 0, 0, reach, reach, radius),
+                 make(x - reach, y + reach, 0, 0, -reach, reach, radius));
+        }
+    }
+
+    void submitLines(const Vertex* vertices, size_t count) {
+        use(SMOOTH);
+        const float halfWidth = 0.5f, reach = halfWidth + FRINGE;
+        for (size_t i = 0; i + 1 < count; i += 2) {
+            float x0 = vertices[i].x, y0 = vertices[i].y;
+            float x1 = vertices[i + 1].x, y1 = vertices[i + 1].y;
+            float length = sqrtf((x1 - x0) * (x1 - x0) + (y1 - y0) * (y1 - y0));
+            if (length == 0) continue;
+            float nx = -(y1 - y0) / length * reach, ny = (x1 - x0) / length * reach;
+            quad(make(x0 - nx, y0 - ny, 0, 0, 0, -reach, halfWidth),
+                 make(x1 - nx, y1 - ny, 0, 0, 0, -reach, halfWidth),
+                 make(x1 + nx, y1 + ny, 0, 0, 0, reach, halfWidth),
+                 make(x0 + nx, y0 + ny, 0, 0, 0, reach, halfWidth));
+        }
+    }
+
+    void submitQuads(const Vertex* vertices, size_t count) {
+        use(textured ? TEXTURED : FLAT);
+        for (size_t i = 0; i + 3 < count; i += 4) {
+            const Vertex* q = vertices + i;
+            quad(make(q[0].x, q[0].y, q[0].u, q[0].v, 0, 0, SOLID),
+                 make(q[1].x, q[1].y, q[1].u, q[1].v, 0, 0, SOLID),
+                 make(q[2].x, q[2].y, q[2].u, q[2].v, 0, 0, SOLID),
+                 make(q[3].x, q[3].y, q[3].u, q[3].v, 0, 0, SOLID));
+        }
+    }
+
+    const FontAtlas* atlas(void* font) {
+        auto found = fonts.find(font);
+        if (found != fonts.end()) return &found->second;
+        const BitmapFont* glyphs = bitmapFont(font);
+        if (!glyphs) return nullptr;
+
+        // Rows of glyphs up to 1024 texels wide, a texel apart
+        const int MAX_WIDTH = 1024;
+        FontAtlas a;
+        a.x.resize(glyphs->quantity);
+        a.y.resize(glyphs->quantity);
+        int x = 0, y = 0, width = 0;
+        for (int c = 0; c < glyphs->quantity; c++) {
+            int w = glyphs->glyph(c)[0];
+            if (x + w > MAX_WIDTH) {
+                x = 0;
+                y += glyphs->height + 1;
+            }
+            a.x[c] = x;
+            a.y[c] = y;
+            x += w + 1;
+            width = std::max(width, x);
+        }
+        a.width = width;
+        a.height = y + glyphs->height;
+
+        std::vector<unsigned char> texels((size_t)a.width * a.height, 0);
+        for (int c = 0; c < glyphs->quantity; c++) {
+            const unsigned char* face = glyphs->glyph(c);
+            int w = face[0], stride = (w + 7) / 8;
+            for (int row = 0; row < glyphs->height; row++) {
+                for (int col = 0; col < w; col++) {
+                    bool set = face[1 + row * stride + col / 8] & (0x80 >> (col % 8));
+                    if (set) texels[(size_t)(a.y[c] + row) * a.width + a.x[c] + col] = 255;
+                }
+            }
+        }
+
+        glGenTextures(1, &a.texture);
+        glBindTexture(GL_TEXTURE_2D, a.texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, a.width, a.height, 0, GL_RED, GL_UNSIGNED_BYTE,
+                     texels.data());
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        return &(fonts[font] = a);
+    }
+
+   protected:
+    void submit(Primitive primitive, const Vertex* vertices, size_t count) override {
+        frameStats.vertices += count;
+        switch (primitive) {
+            case Primitive::POINTS:
+                submitPoints(vertices, count);
+                break;
+            case Primitive::LINES:
+                submitLines(vertices, count);
+                break;
+            case Primitive::QUADS:
+                submitQuads(vertices, count);
+                break;
+        }
+    }
+
+   public:
+    CoreBackend()
+        : programs(),
+          sprites(),
+          discs(),
+          maxPointSize(1.0f),
+          vao(0),
+          vbo(0),
+          ibo(0),
+          camera(0),
+          instanceVao(0),
+          instanceVbo(0),
+          streamOffset(0),
+          instanceCapacity(0),
+          instanceOffset(0),
+          batchShading(FLAT),
+          batchTexture(),
+          textured(false),
+          texture(),
+          rgba{255, 255, 255, 255},
+          size(1.0f),
+          offsetX(0),
+          offsetY(0),
+          projection(),
+          nextRetained(1),
+          recording(false),
+          unretained() {}
+
+    ~CoreBackend() {
+        for (auto& pair : fonts) glDeleteTextures(1, &pair.second.texture);
+        while (!retained.empty()) deleteRetained(retained.begin()->first);
+        for (const Program& p : programs) {
+            if (p.id) glDeleteProgram(p.id);
+        }
+        if (sprites.id) glDeleteProgram(sprites.id);
+        if (discs.id) glDeleteProgram(discs.id);
+        if (vbo) glDeleteBuffers(1, &vbo);
+        if (instanceVbo) glDeleteBuffers(1, &instanceVbo);
+        if (ibo) glDeleteBuffers(1, &ibo);
+        if (camera) glDeleteBuffers(1, &camera);
+        if (vao) glDeleteVertexArrays(1, &vao);
+        if (instanceVao) glDeleteVertexArrays(1, &instanceVao);
+    }
+
+    const char* getName() const override { return "core profile"; }
+
+    bool init() override {
+        const char* version = (const char*)glGetString(GL_VERSION);
+        int major = 0, minor = 0;
+        if (!version || sscanf(version, "%d.%d", &major, &minor) != 2 ||
+            major * 10 + minor < 33) {
+            fprintf(stderr, "The core renderer needs GL 3.3, not %s\n",
+                    version ? version : "none");
+            return false;
+        }
+
+        for (int s = FLAT; s <= SMOOTH; s++) {
+            if (!link(programs[s], VERTEX_SHADER, (Shading)s)) return false;
+        }
+        if (!link(sprites, INSTANCE_VERTEX_SHADER, TEXTURED) ||
+            !link(discs, INSTANCE_VERTEX_SHADER, SMOOTH)) {
+            return false;
+        }
+
+        glGenBuffers(1, &camera);
+        glBindBuffer(GL_UNIFORM_BUFFER, camera);
+        glBufferData(GL_UNIFORM_BUFFER, 20 * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+        glBindBufferBase(GL_UNIFORM_BUFFER, 0, camera);
+
+        glGenVertexArrays(1, &vao);
+        glBindVertexArray(vao);
+        glGenBuffers(1, &vbo);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, STREAM_BYTES, nullptr, GL_STREAM_DRAW);
+        pointAttributes();
+
+        // 0 1 2, 0 2 3 for every quad a batch can hold; part of the vertex array's state
+        std::vector<GLushort> indices(BATCH_QUADS * 6);
+        for (size_t q = 0; q < BATCH_QUADS; q++) {
+            const GLushort corners[6] = {0, 1, 2, 0, 2, 3};
+            for (int i = 0; i < 6; i++) indices[q * 6 + i] = (GLushort)(q * 4 + corners[i]);
+        }
+        glGenBuffers(1, &ibo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLushort), indices.data(),
+                     GL_STATIC_DRAW);
+
+        // Instanced sets: placement and tint advance per instance; pointed at each set as
+        // it is drawn
+        glGenVertexArrays(1, &instanceVao);
+        glBindVertexArray(instanceVao);
+        glGenBuffers(1, &instanceVbo);
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+        instanceCapacity = INSTANCE_BYTES;
+        glBufferData(GL_ARRAY_BUFFER, instanceCapacity, nullptr, GL_STREAM_DRAW);
+        for (int i = 0; i < 2; i++) {
+            glEnableVertexAttribArray(i);
+            glVertexAttribDivisor(i, 1);
+        }
+        GLfloat pointSizes[2] = {1.0f, 1.0f};
+        glGetFloatv(GL_POINT_SIZE_RANGE, pointSizes);
+        maxPointSize = pointSizes[1];
+        glEnable(GL_PROGRAM_POINT_SIZE);
+        glBindVertexArray(vao);
+        return true;
+    }
+
+    void beginFrame(int width, int height) override {
+        frameStats = RenderStats();
+        glClear(GL_COLOR_BUFFER_BIT);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        // glOrtho(0, width, 0, height, -1, 1), column-major
+        memset(projection, 0, sizeof(projection));
+        projection[0] = 2.0f / width;
+        projection[5] = 2.0f / height;
+        projection[10] = -1.0f;
+        projection[12] = -1.0f;
+        projection[13] = -1.0f;
+        projection[15] = 1.0f;
+        offsetX = offsetY = 0;
+        uploadCamera();
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    }
+
+    void endFrame() override {
+        flush();
+        glDisable(GL_BLEND);
+        stats = frameStats;
+    }
+
+    void translate(float x, float y) override {
+        flush();
+        offsetX += x;
+        offsetY += y;
+        uploadCamera();
+    }
+
+    void color(float r, float g, float b, float a) override {
+        rgba[0] = unorm(r);
+        rgba[1] = unorm(g);
+        rgba[2] = unorm(b);
+        rgba[3] = unorm(a);
+    }
+
+    void pointSize(float s) override { size = s; }
+
+    bool hasPaletteLookup() override { return programs[TEXTURED].id != 0; }
+    bool isCoreProfile() const override { return true; }
+
+    void bindTexture(GLuint id, GLuint palette, int paletteSize, float paletteRow) override {
+        texture.texture = id;
+        texture.palette = palette;
+        texture.mode = palette ? PALETTE : RGBA;
+        texture.paletteSize = (float)paletteSize;
+        texture.paletteRow = paletteRow;
+        textured = true;
+    }
+
+    void unbindTexture() override { textured = false; }
+
+    // glBitmap semantics: each glyph's pixels start at the whole pixel below and left of
+    // the raster position less the font's origin, and the raster position advances
+    void drawText(const char* text, float x, float y, void* font) override {
+        const BitmapFont* glyphs = bitmapFont(font);
+        const FontAtlas* a = atlas(font);
+        if (!glyphs || !a) return;
+
+        bool wasTextured = textured;
+        TextureState previous = texture;
+        texture = TextureState{a->texture, 0, COVERAGE, 0, 0};
+        textured = true;
+        use(TEXTURED);
+        float su = 1.0f / a->width, sv = 1.0f / a->height;
+        for (const unsigned char* c = (const unsigned char*)text; *c; c++) {
+            if (*c >= glyphs->quantity) continue;
+            int w = glyphs->glyph(*c)[0], h = glyphs->height;
+            float left = floorf(x + offsetX - glyphs->xorig) - offsetX;
+            float bottom = floorf(y + offsetY - glyphs->yorig) - offsetY;
+            float u0 = a->x[*c] * su, v0 = a->y[*c] * sv;
+            float u1 = (a->x[*c] + w) * su, v1 = (a->y[*c] + h) * sv;
+            quad(make(left, bottom, u0, v0, 0, 0, SOLID),
+                 make(left + w, bottom, u1, v0, 0, 0, SOLID),
+                 make(left + w, bottom + h, u1, v1, 0, 0, SOLID),
+                 make(left, bottom + h, u0, v1, 0, 0, SOLID));
+            x += w;
+        }
+        texture = previous;
+        textured = wasTextured;
+    }
+
+    void drawSprites(const InstanceSet& set, const DrawInstance* instances,
+                     size_t count) override {
+        if (count == 0) return;
+        flush();
+        glUseProgram(sprites.id);
+        applyTexture(sprites, texture);
+        glUniform2f(sprites.halfSizeLocation, set.halfWidth, set.halfHeight);
+        glUniform1f(sprites.frameWidthLocation, set.frameWidth);
+        glUniform1f(sprites.frameCountLocation, (float)set.frameCount);
+        glUniform2f(sprites.vRangeLocation, set.vBottom, set.vTop);
+
+        // Points are clipped by their centre, so one just past the edge vanishes instead of
+        // showing its inner half; fine for the small sprites drawn in numbers
+        bool points = set.halfWidth == set.halfHeight;
+        for (size_t i = 0; points && i < count; i++) {
+            points = 2.0f * set.halfWidth * instances[i].scale <= maxPointSize;
+        }
+        drawInstanced(sprites, instances, count, points);
+    }
+
+    void drawDiscs(int radius, const DrawInstance* instances, size_t count) override {
+        if (count == 0) return;
+        flush();
+        glUseProgram(discs.id);
+        glUniform2f(discs.halfSizeLocation, (float)radius, (float)radius);
+        glUniform1f(discs.frameWidthLocation, 0.0f);
+        drawInstanced(discs, instances, count, false);
+    }
+
+    void beginRetained() override {
+        flush();
+        recording = true;
+        recorded.clear();
+        segments.clear();
+        unretained = frameStats;
+        frameStats = RenderStats();
+    }
+
+    // Uploaded once; the vertex array shares the quad index buffer
+    GLuint endRetained() override {
+        flush();
+        recording = false;
+        Retained r;
+        r.segments = segments;
+        r.vertices = frameStats.vertices;
+        frameStats = unretained;
+
+        glGenVertexArrays(1, &r.vao);
+        glBindVertexArray(r.vao);
+        glGenBuffers(1, &r.vbo);
+        glBindBuffer(GL_ARRAY_BUFFER, r.vbo);
+        glBufferData(GL_ARRAY_BUFFER, recorded.size() * sizeof(CoreVertex), recorded.data(),
+                     GL_STATIC_DRAW);
+        pointAttributes();
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+
+        GLuint handle = nextRetained++;
+        retained[handle] = r;
+        return handle;
+    }
+
+    void drawRetained(GLuint handle, float x, float y) override {
+        auto found = retained.find(handle);
+        if (found == retained.end()) return;
+        const Retained& r = found->second;
+        flush();
+        offsetX += x;
+        offsetY += y;
+        uploadCamera();
+        glBindVertexArray(r.vao);
+        for (const Segment& segment : r.segments) {
+            const Program& p = programs[segment.shading];
+            glUseProgram(p.id);
+            if (segment.shading == TEXTURED) applyTexture(p, segment.texture);
+            glDrawElementsBaseVertex(GL_TRIANGLES, segment.quads * 6, GL_UNSIGNED_SHORT,
+                                     nullptr, segment.first);
+            frameStats.drawCalls++;
+        }
+        frameStats.vertices += r.vertices;
+        glBindVertexArray(vao);
+        offsetX -= x;
+        offsetY -= y;
+        uploadCamera();
+    }
+
+    void deleteRetained(GLuint handle) override {
+        auto found = retained.find(handle);
+        if (found == retained.end()) return;
+        glDeleteBuffers(1, &found->second.vbo);
+        glDeleteVertexArrays(1, &found->second.vao);
+        retained.erase(found);
+    }
+};
+
+RenderBackend* createCoreBackend() {
+    return new CoreBackend();
+}
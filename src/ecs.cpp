@@ -0,0 +1,52 @@
+#include "ecs.h"
+
+Registry::Registry() : liveCount(0) {}
+
+Entity Registry::create() {
+    uint32_t index;
+    if (freeSlots.empty()) {
+        index = generations.size();
+        generations.push_back(0);
+    } else {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    liveCount++;
+    return Entity(index, generations[index]);
+}
+
+void Registry::destroy(Entity e) {
+    if (!alive(e)) return;
+
+    transforms.remove(e);
+    velocities.remove(e);
+    boxes.remove(e);
+    patrols.remove(e);
+    animations.remove(e);
+    drawables.remove(e);
+    pickups.remove(e);
+    hazards.remove(e);
+
+    generations[e.index]++;
+    freeSlots.push_back(e.index);
+    liveCount--;
+}
+
+void Registry::clear() {
+    transforms.clear();
+    velocities.clear();
+    boxes.clear();
+    patrols.clear();
+    animations.clear();
+    drawables.clear();
+    pickups.clear();
+    hazards.clear();
+
+    // Bump every generation so handles from before the clear stay stale
+    freeSlots.clear();
+    for (uint32_t i = 0; i < generations.size(); i++) {
+        generations[i]++;
+        freeSlots.push_back(i);
+    }
+    liveCount = 0;
+}
@@ -1,10 +1,11 @@
 #include "enemy.h"
+#include <algorithm>
 #include <cmath>
 
 Enemy::Enemy(float px, float py, float left, float right, EnemyType t)
     : x(px),
       y(py),
-      vx(1.5f),
+      vx(ENEMY_PATROL_SPEED),
       width(20),
       height(20),
       patrolLeft(left),
@@ -12,33 +13,48 @@ Enemy::Enemy(float px, float py, float left, float right, EnemyType t)
       color(0.9f, 0.2f, 0.2f),
       alive(true),
       facingRight(true),
-      animationTimer(0),
-      type(t) {
+      type(t),
+      spawnX(px),
+      phase(0) {
     if (t == EnemyType::STATIC) {
         vx = 0;
         color = Color(0.6f, 0.6f, 0.6f);
     }
 }
 
-void Enemy::update() {
-    if (!alive) return;
+void Enemy::advanceTo(int tick) {
+    if (!alive || type != EnemyType::PATROL) return;
+    x = patrolX(spawnX, patrolLeft, patrolRight, tick + phase, facingRight);
+    vx = facingRight ? ENEMY_PATROL_SPEED : -ENEMY_PATROL_SPEED;
+}
 
-    animationTimer += 0.1f;
+// Patrol is a discrete triangle wave: walk right from the spawn point, then bounce between
+// the bounds, snapping onto a bound on the tick it is reached or passed. A spawn point so far
+// left of the patrol that the first step does not reach it snaps onto the left bound on that
+// step and walks on from there. This is stepping x += vx in exact arithmetic: the stepper's
+// accumulated rounding could put a bounce a tick early or late, a step apart from here.
+float patrolX(float spawnX, float left, float right, int tick, bool& facingRight) {
+    float from = spawnX;
+    int delay = 0;  // Ticks before walking right from `from`
+    if (tick > 0 && spawnX + ENEMY_PATROL_SPEED <= left) {
+        from = left;
+        delay = 1;
+    }
+    int toRight = delay + std::max(1, (int)ceil((right - from) / ENEMY_PATROL_SPEED));
+    int leg = std::max(1, (int)ceil((right - left) / ENEMY_PATROL_SPEED));
 
-    if (type == EnemyType::PATROL) {
-        x += vx;
+    if (tick < toRight) {
+        facingRight = true;
+        return from + ENEMY_PATROL_SPEED * (tick - delay);
+    }
 
-        // Reverse at patrol bounds
-        if (x >= patrolRight) {
-            x = patrolRight;
-            vx = -fabs(vx);
-            facingRight = false;
-        } else if (x <= patrolLeft) {
-            x = patrolLeft;
-            vx = fabs(vx);
-            facingRight = true;
-        }
+    int step = (tick - toRight) % (2 * leg);
+    if (step < leg) {
+        facingRight = false;
+        return step == 0 ? right : right - ENEMY_PATROL_SPEED * step;
     }
+    facingRight = true;
+    return step == leg ? left : left + ENEMY_PATROL_SPEED * (step - leg);
 }
 
 void Enemy::kill() {
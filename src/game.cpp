@@ -1,39 +1,107 @@
 #include "game.h"
+#include "backend.h"
 #include "constants.h"
 #include <GL/glut.h>
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <ctime>
+#include <iterator>
+
+// Entities per job when an update phase is split across the job system
+static const size_t ENTITY_GRAIN = 256;
 
 Game::Game()
-    : cameraX(0),
+    : twoPlayer(false),
+      replaying(false),
+      cameraX(0),
       cameraTargetX(0),
       score(0),
       lives(3),
       gameTimer(0),
       totalCoins(0),
+      coinsCollected(0),
       state(GameState::MENU),
       stateTransitionTimer(0),
       damageFlashTimer(0),
       cameraShakeTimer(0),
-      cameraShakeIntensity(0) {
+      cameraShakeIntensity(0),
+      levelSource(LevelSource::BUILTIN),
+      levelWidth(DEFAULT_LEVEL_WIDTH),
+      levelSerial(0),
+      simTick(0),
+      stepTicks(1),
+      spriteSource(SpriteSource::GENERATED) {
     for (int i = 0; i < 256; i++) {
         keys[i] = false;
     }
+    renderer.setRetainedPlatforms(true);
 }
 
 void Game::init() {
     srand(time(nullptr));
-    renderer.loadAssets();
+    renderer.loadAssets(spriteSource);
     resetLevel();
 }
 
+void Game::setGeneratedLevel(const LevelGenParams& params) {
+    levelSource = LevelSource::GENERATED;
+    levelParams = params;
+}
+
+bool Game::setLevelFile(const std::string& path) {
+    // Opened aside, so the current level stays mapped if this one is no good
+    LevelFile opened;
+    if (!opened.open(path)) return false;
+    streamer.stop();  // The worker reads the mapping we are about to replace
+    levelFile.swap(opened);
+    levelSource = LevelSource::FILE;
+    levelPath = path;
+    return true;
+}
+
+void Game::setTickRate(int hz) {
+    if (hz < 1) hz = 1;
+    stepTicks = std::max(1, BASE_TICK_RATE / hz);
+}
+
 void Game::resetLevel() {
-    initializePlatforms(platforms);
-    initializeCollectibles(collectibles);
-    initializeEnemies(enemies);
-    totalCoins = collectibles.size();
+    if (levelSource != LevelSource::FILE) streamer.stop();
+
+    switch (levelSource) {
+        case LevelSource::BUILTIN:
+            initializePlatforms(platforms);
+            initializeCollectibles(collectibles);
+            initializeEnemies(enemies);
+            levelWidth = DEFAULT_LEVEL_WIDTH;
+            break;
+
+        case LevelSource::GENERATED:
+            levelWidth = generateLevel(levelParams, platforms, collectibles, enemies);
+            break;
+
+        case LevelSource::FILE:
+            levelWidth = levelFile.width();
+            if (levelWidth >= STREAM_MIN_WIDTH && levelFile.sortedByX()) {
+                if (streamer.isStreaming()) {
+                    streamer.reset();
+                } else {
+                    streamer.start(&levelFile);
+                }
+                streamer.update(0, 0, platforms, collectibles, enemies);
+            } else {
+                levelFile.instantiate(platforms, collectibles, enemies);
+            }
+            break;
+    }
+    // Streamed levels only hold the coins near the camera
+    totalCoins = streamer.isStreaming() ? (int)levelFile.coinCount() : (int)collectibles.size();
+    coinsCollected = 0;
+    simTick = 0;
+    changes.clear();
+    levelSerial++;
     player.reset();
+    partner.reset();
     particleSystem.clear();
     cameraX = 0;
     cameraTargetX = 0;
@@ -41,77 +109,244 @@ void Game::resetLevel() {
     gameTimer = 0;
     damageFlashTimer = 0;
     cameraShakeTimer = 0;
+    rebuildActivity();
 }
 
-bool Game::checkCollision(float x, float y, float width, float height, const Platform& platform) {
-    return x < platform.x + platform.width && x + width > platform.x &&
-           y < platform.y + platform.height && y + height > platform.y;
+void Game::rebuildActivity() {
+    renderer.platformsChanged();
+    platformActivity.build(platforms);
+    coinActivity.build(collectibles);
+    enemyActivity.build(enemies);
+
+    activeCoins.clear();
+    activeEnemies.clear();
+    coinEntities.assign(collectibles.size(), Entity());
+    enemyEntities.assign(enemies.size(), Entity());
+    respawnActive();
+}
+
+// Drop every live coin and enemy and wake the region again from the level records
+void Game::respawnActive() {
+    for (int i : activeCoins) coinEntities[i] = Entity();
+    for (int i : activeEnemies) enemyEntities[i] = Entity();
+    registry.clear();
+    triggers.clear();
+    activeCoins.clear();
+    activeEnemies.clear();
+    updateActivity();
+}
+
+void Game::setTwoPlayer(bool enabled) {
+    twoPlayer = enabled;
+    partner.reset();
 }
 
-void Game::checkCollectibleCollection() {
-    int collectedCount = 0;
-    for (auto& coin : collectibles) {
-        if (coin.collected) {
-            collectedCount++;
-            continue;
+bool Game::saveState(GameSnapshot& out) const {
+    if (streamer.isStreaming()) return false;
+    out.player = player;
+    out.partner = partner;
+    out.cameraX = cameraX;
+    out.cameraTargetX = cameraTargetX;
+    out.score = score;
+    out.lives = lives;
+    out.gameTimer = gameTimer;
+    out.coinsCollected = coinsCollected;
+    out.state = state;
+    out.stateTransitionTimer = stateTransitionTimer;
+    out.damageFlashTimer = damageFlashTimer;
+    out.cameraShakeTimer = cameraShakeTimer;
+    out.cameraShakeIntensity = cameraShakeIntensity;
+    out.simTick = simTick;
+    out.changeCount = changes.size();
+    return true;
+}
+
+bool Game::loadState(const GameSnapshot& in) {
+    if (streamer.isStreaming()) return false;
+
+    // Undo coins and enemies taken since the snapshot, latest first
+    while (changes.size() > in.changeCount) {
+        const LevelChange& change = changes.back();
+        if (change.coin) {
+            collectibles[change.record].collected = false;
+        } else {
+            enemies[change.record].alive = true;
+        }
+        changes.pop_back();
+    }
+
+    player = in.player;
+    partner = in.partner;
+    cameraX = in.cameraX;
+    cameraTargetX = in.cameraTargetX;
+    score = in.score;
+    lives = in.lives;
+    gameTimer = in.gameTimer;
+    coinsCollected = in.coinsCollected;
+    state = in.state;
+    stateTransitionTimer = in.stateTransitionTimer;
+    damageFlashTimer = in.damageFlashTimer;
+    cameraShakeTimer = in.cameraShakeTimer;
+    cameraShakeIntensity = in.cameraShakeIntensity;
+    simTick = in.simTick;
+    respawnActive();
+    return true;
+}
+
+// Wake everything the player can touch or the camera can show by the end of this tick: the
+// camera only moves between its current position and a target within a screen of the
+// player. Coins and enemies entering the region are spawned into the registry, those
+// leaving it are despawned.
+void Game::updateActivity() {
+    float left = player.x, right = player.x;
+    if (twoPlayer) {
+        left = fmin(left, partner.x);
+        right = fmax(right, partner.x);
+    }
+    float activeLeft = fmin(cameraX, left - WINDOW_WIDTH) - ACTIVITY_MARGIN;
+    float activeRight = fmax(cameraX, right) + WINDOW_WIDTH + ACTIVITY_MARGIN;
+    platformActivity.query(activeLeft, activeRight, activePlatforms);
+
+    coinActivity.query(activeLeft, activeRight, wakeScratch);
+    if (wakeScratch != activeCoins) {
+        changeScratch.clear();
+        std::set_difference(activeCoins.begin(), activeCoins.end(), wakeScratch.begin(),
+                            wakeScratch.end(), std::back_inserter(changeScratch));
+        for (int i : changeScratch) {
+            despawn(coinEntities[i]);
+            coinEntities[i] = Entity();
+        }
+        changeScratch.clear();
+        std::set_difference(wakeScratch.begin(), wakeScratch.end(), activeCoins.begin(),
+                            activeCoins.end(), std::back_inserter(changeScratch));
+        for (int i : changeScratch) {
+            if (!collectibles[i].collected) {
+                coinEntities[i] = spawnCoin(registry, collectibles[i], i);
+                addTrigger(registry, triggers, coinEntities[i]);
+            }
         }
+        activeCoins.swap(wakeScratch);
+    }
+
+    enemyActivity.query(activeLeft, activeRight, wakeScratch);
+    if (wakeScratch != activeEnemies) {
+        changeScratch.clear();
+        std::set_difference(activeEnemies.begin(), activeEnemies.end(), wakeScratch.begin(),
+                            wakeScratch.end(), std::back_inserter(changeScratch));
+        for (int i : changeScratch) {
+            despawn(enemyEntities[i]);
+            enemyEntities[i] = Entity();
+        }
+        changeScratch.clear();
+        std::set_difference(wakeScratch.begin(), wakeScratch.end(), activeEnemies.begin(),
+                            activeEnemies.end(), std::back_inserter(changeScratch));
+        for (int i : changeScratch) {
+            if (enemies[i].alive) {
+                enemyEntities[i] = spawnEnemy(registry, enemies[i], i, simTick);
+                addTrigger(registry, triggers, enemyEntities[i]);
+            }
+        }
+        activeEnemies.swap(wakeScratch);
+    }
+}
 
-        float dx = player.x - coin.x;
-        float dy = player.y - coin.y;
-        float distance = sqrt(dx * dx + dy * dy);
+void Game::despawn(Entity e) {
+    triggers.remove(e);
+    registry.destroy(e);
+}
 
-        if (distance < 25) {
-            coin.collected = true;
-            score += 100;
-            collectedCount++;
-            particleSystem.createCollectionParticles(coin.x, coin.y);
+bool Game::checkCollision(float x, float y, float width, float height, const Platform& platform) {
+    return x < platform.x + platform.width && x + width > platform.x &&
+           y < platform.y + platform.height && y + height > platform.y;
+}
+
+void Game::checkCollectibleCollection(Player& p) {
+    triggers.query(p.x, p.x, contactScratch);
+    for (Entity e : contactScratch) {
+        if (!registry.pickups.has(e)) continue;
+        const Transform& coin = registry.transforms.get(e);
+
+        float dx = p.x - coin.x;
+        float dy = p.y - coin.y;
+        if (dx * dx + dy * dy < COIN_PICKUP_RADIUS * COIN_PICKUP_RADIUS) {
+            const Pickup& pickup = registry.pickups.get(e);
+            score += pickup.value;
+            coinsCollected++;
+            if (!replaying) particleSystem.createCollectionParticles(coin.x, coin.y);
             stateTransitionTimer = 0.3f;  // Brief flash
+
+            collectibles[pickup.record].collected = true;
+            changes.push_back({true, pickup.record});
+            coinEntities[pickup.record] = Entity();
+            despawn(e);
         }
     }
 
     // Win condition: all coins collected
-    if (collectedCount >= totalCoins && totalCoins > 0) {
+    if (coinsCollected >= totalCoins && totalCoins > 0) {
         state = GameState::WIN;
         stateTransitionTimer = 1.0f;
     }
 }
 
-void Game::checkEnemyCollisions() {
-    for (auto& enemy : enemies) {
-        if (!enemy.alive) continue;
+void Game::checkEnemyCollisions(Player& p) {
+    float playerLeft = p.x - PLAYER_HALF_WIDTH;
+    float playerRight = p.x + PLAYER_HALF_WIDTH;
+    float playerBottom = p.y - PLAYER_HALF_HEIGHT;
+    float playerTop = p.y + PLAYER_HALF_HEIGHT;
 
-        // Simple AABB collision between player and enemy
-        float playerLeft = player.x - 12;
-        float playerRight = player.x + 12;
-        float playerBottom = player.y - 18;
-        float playerTop = player.y + 18;
+    triggers.query(playerLeft, playerRight, contactScratch);
+    for (Entity e : contactScratch) {
+        if (!registry.hazards.has(e)) continue;
+        const Transform& enemy = registry.transforms.get(e);
+        const AABB& box = registry.boxes.get(e);
 
-        float enemyLeft = enemy.x - enemy.width / 2;
-        float enemyRight = enemy.x + enemy.width / 2;
-        float enemyBottom = enemy.y - enemy.height / 2;
-        float enemyTop = enemy.y + enemy.height / 2;
+        // Simple AABB collision between player and enemy
+        float enemyLeft = enemy.x - box.halfWidth;
+        float enemyRight = enemy.x + box.halfWidth;
+        float enemyBottom = enemy.y - box.halfHeight;
+        float enemyTop = enemy.y + box.halfHeight;
 
         if (playerRight > enemyLeft && playerLeft < enemyRight && playerTop > enemyBottom &&
             playerBottom < enemyTop) {
             // Check if player is stomping (falling onto enemy from above)
-            if (player.vy < 0 && playerBottom > enemyBottom + enemy.height * 0.3f) {
+            if (p.vy < 0 && playerBottom > enemyBottom + box.halfHeight * 0.6f) {
                 // Stomp kill!
-                enemy.kill();
-                score += 200;
-                player.vy = 12.0f;     // Bounce up
-                player.jumpCount = 0;  // Reset jumps after stomp
-                particleSystem.createCollectionParticles(enemy.x, enemy.y);
+                const Hazard& hazard = registry.hazards.get(e);
+                int record = hazard.record;
+                score += hazard.stompValue;
+                p.vy = 12.0f;     // Bounce up
+                p.jumpCount = 0;  // Reset jumps after stomp
+                if (!replaying) particleSystem.createCollectionParticles(enemy.x, enemy.y);
                 cameraShakeTimer = 0.15f;
                 cameraShakeIntensity = 3.0f;
+
+                enemies[record].kill();
+                changes.push_back({false, record});
+                enemyEntities[record] = Entity();
+                despawn(e);
             } else {
                 // Player takes damage
-                playerTakeDamage();
+                playerTakeDamage(p);
             }
         }
     }
 }
 
-void Game::playerTakeDamage() {
+// Cull to platforms that can be touched this step, then sweep the player against them
+void Game::movePlayer(Player& p, int fromTick, bool wasOnGroundBefore) {
+    nearPlatforms.clear();
+    platformsInReach(p, platforms, activePlatforms, nearPlatforms);
+
+    Touchdown touchdown = sweepPlayer(p, platforms, nearPlatforms, fromTick, simTick);
+    if (touchdown.landed && !wasOnGroundBefore && touchdown.vy < -5) {
+        if (!replaying) particleSystem.createLandingParticles(touchdown.x, touchdown.y);
+        cameraShakeTimer = 0.1f;
+        cameraShakeIntensity = fmin(fabs(touchdown.vy) * 0.3f, 4.0f);
+    }
+}
+
+void Game::playerTakeDamage(Player& p) {
     lives--;
     damageFlashTimer = 0.5f;
     cameraShakeTimer = 0.3f;
@@ -122,112 +357,95 @@ void Game::playerTakeDamage() {
         stateTransitionTimer = 1.0f;
     } else {
         // Knock player back
-        player.vy = 10.0f;
-        player.vx = player.facingRight ? -8.0f : 8.0f;
+        p.vy = 10.0f;
+        p.vx = p.facingRight ? -8.0f : 8.0f;
     }
 }
 
 void Game::updateCamera() {
-    // Camera look-ahead based on movement direction
-    float lookAhead = player.vx * 15;
-    cameraTargetX = player.x - WINDOW_WIDTH / 2 + lookAhead;
+    // Camera look-ahead based on movement direction; co-op frames the midpoint
+    float x = player.x, vx = player.vx;
+    if (twoPlayer) {
+        x = (player.x + partner.x) / 2;
+        vx = (player.vx + partner.vx) / 2;
+    }
+    float lookAhead = vx * 15;
+    cameraTargetX = x - WINDOW_WIDTH / 2 + lookAhead;
     if (cameraTargetX < 0) cameraTargetX = 0;
 
     // Level right bound (don't show past the end)
-    float maxCameraX = 3250 - WINDOW_WIDTH;
+    float maxCameraX = levelWidth - WINDOW_WIDTH;
     if (maxCameraX > 0 && cameraTargetX > maxCameraX) {
         cameraTargetX = maxCameraX;
     }
 
-    cameraX += (cameraTargetX - cameraX) * 0.08f;
+    cameraX += (cameraTargetX - cameraX) * (1.0f - powf(0.92f, stepTicks));
 }
 
 void Game::update() {
+    float stepSeconds = BASE_TICK_SECONDS * stepTicks;
+
     // Handle timers
-    if (stateTransitionTimer > 0) stateTransitionTimer -= 0.016f;
-    if (damageFlashTimer > 0) damageFlashTimer -= 0.016f;
-    if (cameraShakeTimer > 0) cameraShakeTimer -= 0.016f;
+    if (stateTransitionTimer > 0) stateTransitionTimer -= stepSeconds;
+    if (damageFlashTimer > 0) damageFlashTimer -= stepSeconds;
+    if (cameraShakeTimer > 0) cameraShakeTimer -= stepSeconds;
 
     if (state != GameState::PLAYING) return;
 
-    gameTimer += 0.016f;
+    gameTimer += stepSeconds;
+    int previousTick = simTick;
+    simTick += stepTicks;
 
     bool wasOnGroundBefore = player.onGround;
-    float fallVelocity = player.vy;
+    bool partnerWasOnGround = partner.onGround;
 
     // Update player physics
-    player.update();
+    player.update(stepTicks);
+    if (twoPlayer) partner.update(stepTicks);
+
+    updateActivity();
+
+    // Phase graph for the rest of the tick:
+    //   platform motion ──▶ player vs platforms ──┐
+    //   enemy patrol ─────────────────────────────┴▶ enemy contact, pickups ──┐
+    //   particle step (existing particles) ───────────────────────────────────┴▶ merge
+    // Particles emitted before the merge are staged and stepped in emission order.
+    JobCounter platformsMoved, enemiesMoved, particlesStepped;
+    jobs.parallelFor(activePlatforms.size(), ENTITY_GRAIN, [this](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) platforms[activePlatforms[i]].advanceTo(simTick);
+    }, platformsMoved);
+    jobs.parallelFor(registry.patrols.size(), ENTITY_GRAIN, [this](size_t begin, size_t end) {
+        patrolSystem(registry, simTick, begin, end);
+    }, enemiesMoved);
+    if (!replaying) particleSystem.beginUpdate(jobs, particlesStepped, stepTicks);
 
     // Collision detection with platforms
-    player.onGround = false;
-    for (auto& platform : platforms) {
-        platform.update();
-
-        if (checkCollision(player.x - 12, player.y - 18, 24, 36, platform)) {
-            // Landing on top
-            if (player.vy <= 0 && player.y - 18 < platform.y + platform.height &&
-                player.y > platform.y + platform.height - 10) {
-                player.y = platform.y + platform.height + 18;
-                player.vy = 0;
-                player.onGround = true;
-
-                if (!wasOnGroundBefore && fallVelocity < -5) {
-                    particleSystem.createLandingParticles(player.x, player.y);
-                    cameraShakeTimer = 0.1f;
-                    cameraShakeIntensity = fmin(fabs(fallVelocity) * 0.3f, 4.0f);
-                }
-            }
-            // Hit from below
-            else if (player.vy > 0 && player.y + 18 > platform.y && player.y < platform.y + 5) {
-                player.y = platform.y - 18;
-                player.vy = 0;
-            }
-            // Side collision
-            else if (player.y - 18 < platform.y + platform.height && player.y + 18 > platform.y) {
-                if (player.x < platform.x) {
-                    player.x = platform.x - 12;
-                    // Wall slide detection (pressing into wall while in air)
-                    if (!player.onGround && player.vy < 0 && player.wallJumpCooldown <= 0) {
-                        player.onWall = true;
-                        player.wallSliding = true;
-                        player.wallDirection = 1;  // Wall is on the right
-                        player.jumpCount = 0;
-                    }
-                } else {
-                    player.x = platform.x + platform.width + 12;
-                    if (!player.onGround && player.vy < 0 && player.wallJumpCooldown <= 0) {
-                        player.onWall = true;
-                        player.wallSliding = true;
-                        player.wallDirection = -1;  // Wall is on the left
-                        player.jumpCount = 0;
-                    }
-                }
-                player.vx = 0;
-            }
-        }
-    }
-
-    // Update enemies
-    for (auto& enemy : enemies) {
-        enemy.update();
-    }
+    jobs.wait(platformsMoved);
+    movePlayer(player, previousTick, wasOnGroundBefore);
+    if (twoPlayer) movePlayer(partner, previousTick, partnerWasOnGround);
 
     // Check enemy collisions
-    checkEnemyCollisions();
+    jobs.wait(enemiesMoved);
+    syncTriggers(registry, triggers);
+    checkEnemyCollisions(player);
+    if (twoPlayer) checkEnemyCollisions(partner);
 
     // Update other systems
-    checkCollectibleCollection();
+    checkCollectibleCollection(player);
+    if (twoPlayer) checkCollectibleCollection(partner);
     updateCamera();
-    particleSystem.update();
+    if (!replaying) {
+        jobs.wait(particlesStepped);
+        particleSystem.endUpdate();
+    }
 
-    for (auto& coin : collectibles) {
-        if (!coin.collected) {
-            coin.update();
-        }
+    if (streamer.isStreaming() &&
+        streamer.update(cameraX, player.vx, platforms, collectibles, enemies)) {
+        rebuildActivity();
     }
 
     // Dust particles when running
-    if (player.onGround && fabs(player.vx) > 2.0f) {
+    if (!replaying && player.onGround && fabs(player.vx) > 2.0f) {
         if (rand() % 5 == 0) {
             particleSystem.addParticle(player.x + (rand() % 10 - 5), player.y - 16,
                                        -player.vx * 0.2f, (rand() % 30) / 10.0f,
@@ -235,28 +453,34 @@ void Game::update() {
         }
     }
 
-    renderer.updateGameTime();
+    renderer.updateGameTime(stepSeconds);
 
-    // Lose a life if fallen
-    if (player.y < -100) {
-        lives--;
-        damageFlashTimer = 0.3f;
-        if (lives <= 0) {
-            state = GameState::GAME_OVER;
-            stateTransitionTimer = 1.0f;
-        } else {
-            player.reset();
-        }
+    checkFall(player);
+    if (twoPlayer) checkFall(partner);
+}
+
+// Lose a life if fallen
+void Game::checkFall(Player& p) {
+    if (p.y >= FALL_DEATH_Y) return;
+    lives--;
+    damageFlashTimer = 0.3f;
+    if (lives <= 0) {
+        state = GameState::GAME_OVER;
+        stateTransitionTimer = 1.0f;
+    } else {
+        p.reset();
     }
 }
 
 void Game::render() {
+    renderer.pollAssets();
+
     // Apply camera shake
     float shakeX = 0, shakeY = 0;
     if (cameraShakeTimer > 0) {
         shakeX = (rand() % 100 - 50) / 50.0f * cameraShakeIntensity * (cameraShakeTimer / 0.3f);
         shakeY = (rand() % 100 - 50) / 50.0f * cameraShakeIntensity * (cameraShakeTimer / 0.3f);
-        glTranslatef(shakeX, shakeY, 0);
+        renderBackend().translate(shakeX, shakeY);
     }
 
     switch (state) {
@@ -268,10 +492,15 @@ void Game::render() {
         case GameState::PAUSED:
             renderer.drawBackground(cameraX);
             renderer.drawPlatforms(platforms, cameraX);
-            renderer.drawCollectibles(collectibles, cameraX);
-            renderer.drawEnemies(enemies, cameraX);
+            coinSprites.clear();
+            enemySprites.clear();
+            extractSprites(registry, SpriteKind::COIN, simTick, coinSprites);
+            extractSprites(registry, SpriteKind::ENEMY, simTick, enemySprites);
+            renderer.drawCollectibles(coinSprites, cameraX);
+            renderer.drawEnemies(enemySprites, cameraX);
             renderer.drawParticles(particleSystem.getParticles(), cameraX);
             renderer.drawPlayer(player, cameraX);
+            if (twoPlayer) renderer.drawPlayer(partner, cameraX, true);
             renderer.drawHUD(score, lives, gameTimer, player);
 
             if (state == GameState::PAUSED) {
@@ -298,7 +527,9 @@ void Game::render() {
         case GameState::WIN:
             renderer.drawBackground(cameraX);
             renderer.drawPlatforms(platforms, cameraX);
-            renderer.drawCollectibles(collectibles, cameraX);
+            coinSprites.clear();
+            extractSprites(registry, SpriteKind::COIN, simTick, coinSprites);
+            renderer.drawCollectibles(coinSprites, cameraX);
             renderer.drawPlayer(player, cameraX);
             renderer.drawWinScreen(score, gameTimer);
             break;
@@ -306,7 +537,7 @@ void Game::render() {
 
     // Reset shake
     if (cameraShakeTimer > 0) {
-        glTranslatef(-shakeX, -shakeY, 0);
+        renderBackend().translate(-shakeX, -shakeY);
     }
 }
 
@@ -324,15 +555,7 @@ void Game::handleKeyDown(unsigned char key) {
             break;
 
         case GameState::PLAYING:
-            if (key == 'w' || key == 'W' || key == ' ') {
-                if (player.wallSliding) {
-                    player.wallJump();
-                    particleSystem.createJumpParticles(player.x, player.y);
-                } else if (player.jumpCount < player.maxJumps) {
-                    player.jump();
-                    particleSystem.createJumpParticles(player.x, player.y);
-                }
-            }
+            if (key == 'w' || key == 'W' || key == ' ') tryJump(player);
             if (key == 'p' || key == 'P' || key == 27) {
                 state = GameState::PAUSED;
             }
@@ -376,13 +599,7 @@ void Game::handleSpecialDown(int key) {
             keys['d'] = true;
             break;
         case GLUT_KEY_UP:
-            if (player.wallSliding) {
-                player.wallJump();
-                particleSystem.createJumpParticles(player.x, player.y);
-            } else if (player.jumpCount < player.maxJumps) {
-                player.jump();
-                particleSystem.createJumpParticles(player.x, player.y);
-            }
+            tryJump(player);
             break;
     }
 }
@@ -410,4 +627,30 @@ void Game::processInput() {
     } else {
         player.stopMoving();
     }
-}
\ No newline at end of file
+}
+
+void Game::applyInput(int slot, InputBits input) {
+    if (state != GameState::PLAYING) return;
+
+    Player& p = slot == 0 ? player : partner;
+    if (input & INPUT_JUMP) tryJump(p);
+    if (input & INPUT_LEFT) {
+        p.moveLeft();
+    } else if (input & INPUT_RIGHT) {
+        p.moveRight();
+    } else {
+        p.stopMoving();
+    }
+}
+
+// Wall jump off a wall being slid down, else a ground or double jump if one is left
+void Game::tryJump(Player& p) {
+    if (p.wallSliding) {
+        p.wallJump();
+    } else if (p.jumpCount < p.maxJumps) {
+        p.jump();
+    } else {
+        return;
+    }
+    if (!replaying) particleSystem.createJumpParticles(p.x, p.y);
+}
@@ -1,4 +1,6 @@
 #include "graphics.h"
+#include "arena.h"
+#include "backend.h"
 #include "constants.h"
 #include <GL/glut.h>
 #include <cmath>
@@ -7,7 +9,8 @@
 #include <list>
 
 void drawLineDDA(float x1, float y1, float x2, float y2, Color color) {
-    glColor4f(color.r, color.g, color.b, color.a);
+    RenderBackend& gfx = renderBackend();
+    gfx.color(color.r, color.g, color.b, color.a);
 
     float dx = x2 - x1;
     float dy = y2 - y1;
@@ -20,27 +23,28 @@ void drawLineDDA(float x1, float y1, float x2, float y2, Color color) {
 
     float x = x1, y = y1;
 
-    glPointSize(2.0f);
-    glBegin(GL_POINTS);
+    gfx.pointSize(2.0f);
+    gfx.begin(Primitive::POINTS);
     for (int i = 0; i <= steps; i++) {
-        glVertex2f(x, y);
+        gfx.vertex(x, y);
         x += xIncrement;
         y += yIncrement;
     }
-    glEnd();
-    glPointSize(1.0f);
+    gfx.end();
+    gfx.pointSize(1.0f);
 }
 
 void drawLineBresenham(int x1, int y1, int x2, int y2, Color color, int thickness) {
-    glColor4f(color.r, color.g, color.b, color.a);
-    glPointSize(thickness);
+    RenderBackend& gfx = renderBackend();
+    gfx.color(color.r, color.g, color.b, color.a);
+    gfx.pointSize(thickness);
 
     int dx = abs(x2 - x1);
     int dy = abs(y2 - y1);
     int xi = (x2 > x1) ? 1 : -1;
     int yi = (y2 > y1) ? 1 : -1;
 
-    glBegin(GL_POINTS);
+    gfx.begin(Primitive::POINTS);
 
     // Check which slope region we’re in
     if (dy <= dx) {
@@ -49,7 +53,7 @@ void drawLineBresenham(int x1, int y1, int x2, int y2, Color color, int thicknes
         int y = y1;
 
         for (int x = x1; x != x2 + xi; x += xi) {
-            glVertex2i(x, y);
+            gfx.vertex(x, y);
             if (D > 0) {
                 y += yi;
                 D += 2 * (dy - dx);
@@ -63,7 +67,7 @@ void drawLineBresenham(int x1, int y1, int x2, int y2, Color color, int thicknes
         int x = x1;
 
         for (int y = y1; y != y2 + yi; y += yi) {
-            glVertex2i(x, y);
+            gfx.vertex(x, y);
             if (D > 0) {
                 x += xi;
                 D += 2 * (dx - dy);
@@ -73,32 +77,34 @@ void drawLineBresenham(int x1, int y1, int x2, int y2, Color color, int thicknes
         }
     }
 
-    glEnd();
-    glPointSize(1.0f);
+    gfx.end();
+    gfx.pointSize(1.0f);
 }
 
 void plotCirclePoints(int xc, int yc, int x, int y) {
-    glVertex2i(xc + x, yc + y);
-    glVertex2i(xc - x, yc + y);
-    glVertex2i(xc + x, yc - y);
-    glVertex2i(xc - x, yc - y);
-    glVertex2i(xc + y, yc + x);
-    glVertex2i(xc - y, yc + x);
-    glVertex2i(xc + y, yc - x);
-    glVertex2i(xc - y, yc - x);
+    RenderBackend& gfx = renderBackend();
+    gfx.vertex(xc + x, yc + y);
+    gfx.vertex(xc - x, yc + y);
+    gfx.vertex(xc + x, yc - y);
+    gfx.vertex(xc - x, yc - y);
+    gfx.vertex(xc + y, yc + x);
+    gfx.vertex(xc - y, yc + x);
+    gfx.vertex(xc + y, yc - x);
+    gfx.vertex(xc - y, yc - x);
 }
 
 void drawCircleMidpoint(int xc, int yc, int r, Color color, bool filled) {
-    glColor4f(color.r, color.g, color.b, color.a);
+    RenderBackend& gfx = renderBackend();
+    gfx.color(color.r, color.g, color.b, color.a);
 
     //  Filled circle
     if (filled) {
         for (int y = -r; y <= r; y++) {
             int x = (int)sqrt(r * r - y * y);
-            glBegin(GL_LINES);
-            glVertex2i(xc - x, yc + y);
-            glVertex2i(xc + x, yc + y);
-            glEnd();
+            gfx.begin(Primitive::LINES);
+            gfx.vertex(xc - x, yc + y);
+            gfx.vertex(xc + x, yc + y);
+            gfx.end();
         }
         return;
     }
@@ -107,8 +113,8 @@ void drawCircleMidpoint(int xc, int yc, int r, Color color, bool filled) {
     int y = r;
     int p = 1 - r;  // Initial decision parameter
 
-    glPointSize(2.0f);
-    glBegin(GL_POINTS);
+    gfx.pointSize(2.0f);
+    gfx.begin(Primitive::POINTS);
 
     plotCirclePoints(xc, yc, x, y);
 
@@ -125,36 +131,38 @@ void drawCircleMidpoint(int xc, int yc, int r, Color color, bool filled) {
         plotCirclePoints(xc, yc, x, y);
     }
 
-    glEnd();
-    glPointSize(1.0f);
+    gfx.end();
+    gfx.pointSize(1.0f);
 }
 
 // Bresenham Circle Helper Function
 void drawCirclePointsGL(int xc, int yc, int x, int y, float r, float g, float b) {
-    glColor3f(r, g, b);
-    glBegin(GL_POINTS);
-    glVertex2f(xc + x, yc + y);
-    glVertex2f(xc - x, yc + y);
-    glVertex2f(xc + x, yc - y);
-    glVertex2f(xc - x, yc - y);
-    glVertex2f(xc + y, yc + x);
-    glVertex2f(xc - y, yc + x);
-    glVertex2f(xc + y, yc - x);
-    glVertex2f(xc - y, yc - x);
-    glEnd();
+    RenderBackend& gfx = renderBackend();
+    gfx.color(r, g, b);
+    gfx.begin(Primitive::POINTS);
+    gfx.vertex(xc + x, yc + y);
+    gfx.vertex(xc - x, yc + y);
+    gfx.vertex(xc + x, yc - y);
+    gfx.vertex(xc - x, yc - y);
+    gfx.vertex(xc + y, yc + x);
+    gfx.vertex(xc - y, yc + x);
+    gfx.vertex(xc + y, yc - x);
+    gfx.vertex(xc - y, yc - x);
+    gfx.end();
 }
 
 void drawCircleBresenham(int xc, int yc, int r, Color color, bool filled) {
-    glColor4f(color.r, color.g, color.b, color.a);
+    RenderBackend& gfx = renderBackend();
+    gfx.color(color.r, color.g, color.b, color.a);
 
     // Filled circle
     if (filled) {
         for (int y = -r; y <= r; y++) {
             int x = (int)sqrt(r * r - y * y);
-            glBegin(GL_LINES);
-            glVertex2i(xc - x, yc + y);
-            glVertex2i(xc + x, yc + y);
-            glEnd();
+            gfx.begin(Primitive::LINES);
+            gfx.vertex(xc - x, yc + y);
+            gfx.vertex(xc + x, yc + y);
+            gfx.end();
         }
         return;
     }
@@ -162,7 +170,7 @@ void drawCircleBresenham(int xc, int yc, int r, Color color, bool filled) {
     int x = 0, y = r;
     int d = 3 - 2 * r;
 
-    glPointSize(2.0f);
+    gfx.pointSize(2.0f);
 
     while (y >= x) {
         drawCirclePointsGL(xc, yc, x, y, color.r, color.g, color.b);
@@ -176,7 +184,7 @@ void drawCircleBresenham(int xc, int yc, int r, Color color, bool filled) {
         x++;
     }
 
-    glPointSize(1.0f);
+    gfx.pointSize(1.0f);
 }
 
 struct Edge {
@@ -186,19 +194,25 @@ struct Edge {
     bool operator<(const Edge& e) const { return x < e.x; }
 };
 
-void scanLineFill(std::vector<Point>& vertices, Color fillColor, Color gradientColor,
+typedef std::list<Edge, ArenaAllocator<Edge>> EdgeList;
+
+void scanLineFill(const Point* vertices, size_t count, Color fillColor, Color gradientColor,
                   bool useGradient) {
-    if (vertices.size() < 3) return;
+    if (count < 3) return;
+    RenderBackend& gfx = renderBackend();
 
-    std::map<int, std::list<Edge>> edgeTable;
+    // The edge lists live in the frame arena, handed back on return
+    FrameArena::Scope scratch(frameArena);
+    std::map<int, EdgeList, std::less<int>, ArenaAllocator<std::pair<const int, EdgeList>>>
+        edgeTable;
     int ymin = 100000, ymax = -100000;
 
     //  Build the edge table
-    for (size_t i = 0; i < vertices.size(); ++i) {
+    for (size_t i = 0; i < count; ++i) {
         int x1 = round(vertices[i].x);
         int y1 = round(vertices[i].y);
-        int x2 = round(vertices[(i + 1) % vertices.size()].x);
-        int y2 = round(vertices[(i + 1) % vertices.size()].y);
+        int x2 = round(vertices[(i + 1) % count].x);
+        int y2 = round(vertices[(i + 1) % count].y);
 
         if (y1 == y2) continue;  // skip horizontal edges
 
@@ -220,7 +234,7 @@ void scanLineFill(std::vector<Point>& vertices, Color fillColor, Color gradientC
     }
 
     // Initialize the Active Edge Table (AET)
-    std::list<Edge> AET;
+    EdgeList AET;
 
     // For each scanline
     for (int y = ymin; y < ymax; ++y) {
@@ -238,11 +252,11 @@ void scanLineFill(std::vector<Point>& vertices, Color fillColor, Color gradientC
         // Optional: gradient color based on scanline
         if (useGradient) {
             float t = (float)(y - ymin) / (float)(ymax - ymin);
-            glColor4f(fillColor.r + t * (gradientColor.r - fillColor.r),
+            gfx.color(fillColor.r + t * (gradientColor.r - fillColor.r),
                       fillColor.g + t * (gradientColor.g - fillColor.g),
                       fillColor.b + t * (gradientColor.b - fillColor.b), fillColor.a);
         } else {
-            glColor4f(fillColor.r, fillColor.g, fillColor.b, fillColor.a);
+            gfx.color(fillColor.r, fillColor.g, fillColor.b, fillColor.a);
         }
 
         // Draw pairs of intersections as filled lines
@@ -251,10 +265,10 @@ void scanLineFill(std::vector<Point>& vertices, Color fillColor, Color gradientC
             auto itNext = std::next(it);
             if (itNext == AET.end()) break;
 
-            glBegin(GL_LINES);
-            glVertex2f(it->x, y);
-            glVertex2f(itNext->x, y);
-            glEnd();
+            gfx.begin(Primitive::LINES);
+            gfx.vertex(it->x, y);
+            gfx.vertex(itNext->x, y);
+            gfx.end();
 
             std::advance(it, 2);
         }
@@ -0,0 +1,146 @@
+#include "jobs.h"
+
+// Queue owned by the current thread; external threads share queue 0
+static thread_local int currentQueue = 0;
+
+JobSystem::JobSystem(int workerCount) : queued(0), waiters(0), quit(false) {
+    setWorkerCount(workerCount);
+}
+
+JobSystem::~JobSystem() {
+    stop();
+}
+
+int JobSystem::defaultWorkerCount() {
+    int hardware = std::thread::hardware_concurrency();
+    return hardware > 1 ? hardware - 1 : 0;
+}
+
+void JobSystem::setWorkerCount(int workerCount) {
+    stop();
+
+    queues.clear();
+    for (int i = 0; i <= workerCount; i++) queues.emplace_back(new Queue());
+
+    quit = false;
+    for (int i = 1; i <= workerCount; i++) {
+        workers.push_back(std::thread(&JobSystem::workerLoop, this, i));
+    }
+}
+
+// Join the workers, then run whatever they left queued here
+void JobSystem::stop() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        quit = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) worker.join();
+    workers.clear();
+
+    Job job;
+    while (findJob(0, job)) run(job);
+}
+
+void JobSystem::submit(const JobFunction& fn, JobCounter& counter) {
+    counter.pending.fetch_add(1, std::memory_order_relaxed);
+
+    int index = currentQueue < (int)queues.size() ? currentQueue : 0;
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        Job job = {fn, &counter};
+        queues[index]->jobs.push_back(job);
+    }
+    queued.fetch_add(1, std::memory_order_release);
+
+    // Taking the sleep mutex orders this against a worker checking `queued` before sleeping.
+    // Threads asleep in wait() are woken too: the workers may all be waiting themselves.
+    bool waiting;
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        waiting = waiters > 0;
+    }
+    wake.notify_one();
+    if (waiting) finished.notify_all();
+}
+
+void JobSystem::parallelFor(size_t count, size_t grain, const RangeFunction& fn,
+                            JobCounter& counter) {
+    if (count == 0) return;
+    if (grain == 0) grain = 1;
+    if (count <= grain) {
+        fn(0, count);
+        return;
+    }
+
+    for (size_t begin = 0; begin < count; begin += grain) {
+        size_t end = begin + grain < count ? begin + grain : count;
+        submit([fn, begin, end]() { fn(begin, end); }, counter);
+    }
+}
+
+// Own queue from the back (most recent, still warm in cache), others from the front
+bool JobSystem::findJob(int queueIndex, Job& job) {
+    if (queued.load(std::memory_order_acquire) == 0) return false;
+
+    int count = queues.size();
+    for (int k = 0; k < count; k++) {
+        Queue& queue = *queues[(queueIndex + k) % count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty()) continue;
+
+        if (k == 0) {
+            job = queue.jobs.back();
+            queue.jobs.pop_back();
+        } else {
+            job = queue.jobs.front();
+            queue.jobs.pop_front();
+        }
+        queued.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void JobSystem::run(Job& job) {
+    job.fn();
+    // The counter may be gone once it reads zero, so it is not touched again
+    if (job.counter->pending.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+    bool waiting;
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        waiting = waiters > 0;
+    }
+    if (waiting) finished.notify_all();
+}
+
+void JobSystem::wait(JobCounter& counter) {
+    int index = currentQueue < (int)queues.size() ? currentQueue : 0;
+    while (!counter.done()) {
+        Job job;
+        if (findJob(index, job)) {
+            run(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        waiters++;
+        finished.wait(lock, [this, &counter] { return counter.done() || queued.load() > 0; });
+        waiters--;
+    }
+}
+
+void JobSystem::workerLoop(int queueIndex) {
+    currentQueue = queueIndex;
+    while (true) {
+        Job job;
+        if (findJob(queueIndex, job)) {
+            run(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this] { return quit || queued.load() > 0; });
+        if (quit) return;
+    }
+}
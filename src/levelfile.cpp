@@ -0,0 +1,256 @@
+#include "levelfile.h"
+#include <algorithm>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const uint64_t SECTION_ALIGN = 16;
+
+LevelFile::LevelFile()
+    : data(nullptr),
+      size(0),
+      header(nullptr),
+      platformRecords(nullptr),
+      coinRecords(nullptr),
+      enemyRecords(nullptr),
+      platformTotal(0),
+      coinTotal(0),
+      enemyTotal(0) {}
+
+LevelFile::~LevelFile() {
+    close();
+}
+
+// Locate a section's records, checking bounds and record size against this build
+static const void* findSection(const unsigned char* base, size_t size,
+                               const LevelSection& section, uint32_t recordSize,
+                               size_t& count) {
+    if (section.recordSize != recordSize || section.offset % SECTION_ALIGN != 0) return nullptr;
+    count = 0;
+    if (section.count == 0) return base;  // Empty trailing sections may point past EOF
+    if (section.offset > size || section.count > (size - section.offset) / recordSize) {
+        return nullptr;
+    }
+    count = section.count;
+    return base + section.offset;
+}
+
+bool LevelFile::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Failed to open level: %s\n", path.c_str());
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(LevelFileHeader)) {
+        fprintf(stderr, "Level file too small: %s\n", path.c_str());
+        ::close(fd);
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // The mapping keeps the file alive
+    if (mapped == MAP_FAILED) {
+        fprintf(stderr, "Failed to map level: %s\n", path.c_str());
+        return false;
+    }
+    data = mapped;
+    size = st.st_size;
+
+    const unsigned char* base = (const unsigned char*)data;
+    header = (const LevelFileHeader*)base;
+    if (header->magic != LEVEL_FILE_MAGIC || header->version != LEVEL_FILE_VERSION) {
+        fprintf(stderr, "Not a version %u level file: %s\n", LEVEL_FILE_VERSION, path.c_str());
+        close();
+        return false;
+    }
+
+    size_t tableEnd = sizeof(LevelFileHeader) + (size_t)header->sectionCount * sizeof(LevelSection);
+    if (header->sectionCount > 64 || tableEnd > size) {
+        fprintf(stderr, "Corrupt section table: %s\n", path.c_str());
+        close();
+        return false;
+    }
+
+    const LevelSection* sections = (const LevelSection*)(base + sizeof(LevelFileHeader));
+    for (uint32_t i = 0; i < header->sectionCount; i++) {
+        const LevelSection& s = sections[i];
+        const void* records = nullptr;
+        switch (s.type) {
+            case LEVEL_SECTION_PLATFORMS:
+                records = findSection(base, size, s, sizeof(PlatformRecord), platformTotal);
+                platformRecords = (const PlatformRecord*)records;
+                break;
+            case LEVEL_SECTION_COINS:
+                records = findSection(base, size, s, sizeof(CoinRecord), coinTotal);
+                coinRecords = (const CoinRecord*)records;
+                break;
+            case LEVEL_SECTION_ENEMIES:
+                records = findSection(base, size, s, sizeof(EnemyRecord), enemyTotal);
+                enemyRecords = (const EnemyRecord*)records;
+                break;
+            default:
+                continue;  // Unknown sections are skipped
+        }
+        if (!records) {
+            fprintf(stderr, "Corrupt section %u in %s\n", s.type, path.c_str());
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void LevelFile::close() {
+    if (data) munmap(data, size);
+    data = nullptr;
+    size = 0;
+    header = nullptr;
+    platformRecords = nullptr;
+    coinRecords = nullptr;
+    enemyRecords = nullptr;
+    platformTotal = coinTotal = enemyTotal = 0;
+}
+
+void LevelFile::swap(LevelFile& other) {
+    std::swap(data, other.data);
+    std::swap(size, other.size);
+    std::swap(header, other.header);
+    std::swap(platformRecords, other.platformRecords);
+    std::swap(coinRecords, other.coinRecords);
+    std::swap(enemyRecords, other.enemyRecords);
+    std::swap(platformTotal, other.platformTotal);
+    std::swap(coinTotal, other.coinTotal);
+    std::swap(enemyTotal, other.enemyTotal);
+}
+
+void LevelFile::instantiate(std::vector<Platform>& platforms,
+                            std::vector<Collectible>& collectibles,
+                            std::vector<Enemy>& enemies) const {
+    platforms.clear();
+    collectibles.clear();
+    enemies.clear();
+    platforms.reserve(platformTotal);
+    collectibles.reserve(coinTotal);
+    enemies.reserve(enemyTotal);
+
+    for (size_t i = 0; i < platformTotal; i++) {
+        platforms.push_back(platformFromRecord(platformRecords[i]));
+    }
+    for (size_t i = 0; i < coinTotal; i++) collectibles.push_back(coinFromRecord(coinRecords[i]));
+    for (size_t i = 0; i < enemyTotal; i++) enemies.push_back(enemyFromRecord(enemyRecords[i]));
+}
+
+// ─────────────────────────────────────────
+// Record conversion
+// ─────────────────────────────────────────
+
+Platform platformFromRecord(const PlatformRecord& r) {
+    bool moving = (r.flags & PLATFORM_RECORD_MOVING) != 0;
+    return Platform(r.x, r.y, r.width, r.height, Color(r.r, r.g, r.b), moving, r.moveSpeed,
+                    r.moveRange);
+}
+
+Collectible coinFromRecord(const CoinRecord& r) {
+    return Collectible(r.x, r.y);
+}
+
+Enemy enemyFromRecord(const EnemyRecord& r) {
+    return Enemy(r.x, r.y, r.patrolLeft, r.patrolRight, (EnemyType)r.type);
+}
+
+static PlatformRecord platformToRecord(const Platform& p) {
+    PlatformRecord r;
+    r.x = p.originalX;  // Moving platforms are stored at rest
+    r.y = p.y;
+    r.width = p.width;
+    r.height = p.height;
+    r.r = p.color.r;
+    r.g = p.color.g;
+    r.b = p.color.b;
+    r.moveSpeed = p.moveSpeed;
+    r.moveRange = p.moveRange;
+    r.flags = p.isMoving ? PLATFORM_RECORD_MOVING : 0;
+    return r;
+}
+
+// ─────────────────────────────────────────
+// Writer
+// ─────────────────────────────────────────
+
+template <typename T>
+static bool writeSection(FILE* f, const std::vector<T>& records, uint64_t offset) {
+    if (fseek(f, (long)offset, SEEK_SET) != 0) return false;
+    return records.empty() ||
+           fwrite(records.data(), sizeof(T), records.size(), f) == records.size();
+}
+
+static uint64_t alignUp(uint64_t value) {
+    return (value + SECTION_ALIGN - 1) / SECTION_ALIGN * SECTION_ALIGN;
+}
+
+bool writeLevelFile(const std::string& path, float width, float height,
+                    const std::vector<Platform>& platforms,
+                    const std::vector<Collectible>& collectibles,
+                    const std::vector<Enemy>& enemies) {
+    std::vector<PlatformRecord> platformData;
+    std::vector<CoinRecord> coinData;
+    std::vector<EnemyRecord> enemyData;
+    platformData.reserve(platforms.size());
+    coinData.reserve(collectibles.size());
+    enemyData.reserve(enemies.size());
+
+    for (const Platform& p : platforms) platformData.push_back(platformToRecord(p));
+    for (const Collectible& c : collectibles) {
+        CoinRecord r = {c.x, c.y};
+        coinData.push_back(r);
+    }
+    for (const Enemy& e : enemies) {
+        EnemyRecord r = {e.spawnX, e.y, e.patrolLeft, e.patrolRight, (uint32_t)e.type, 0};
+        enemyData.push_back(r);
+    }
+
+    std::stable_sort(platformData.begin(), platformData.end(),
+                     [](const PlatformRecord& a, const PlatformRecord& b) { return a.x < b.x; });
+    std::stable_sort(coinData.begin(), coinData.end(),
+                     [](const CoinRecord& a, const CoinRecord& b) { return a.x < b.x; });
+    std::stable_sort(enemyData.begin(), enemyData.end(),
+                     [](const EnemyRecord& a, const EnemyRecord& b) { return a.x < b.x; });
+
+    LevelFileHeader header = {};
+    header.magic = LEVEL_FILE_MAGIC;
+    header.version = LEVEL_FILE_VERSION;
+    header.sectionCount = 3;
+    header.flags = LEVEL_FLAG_SORTED_X;
+    header.width = width;
+    header.height = height;
+
+    LevelSection sections[3];
+    uint64_t offset = alignUp(sizeof(LevelFileHeader) + sizeof(sections));
+    sections[0] = {LEVEL_SECTION_PLATFORMS, sizeof(PlatformRecord), offset, platformData.size()};
+    offset = alignUp(offset + platformData.size() * sizeof(PlatformRecord));
+    sections[1] = {LEVEL_SECTION_COINS, sizeof(CoinRecord), offset, coinData.size()};
+    offset = alignUp(offset + coinData.size() * sizeof(CoinRecord));
+    sections[2] = {LEVEL_SECTION_ENEMIES, sizeof(EnemyRecord), offset, enemyData.size()};
+
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) {
+        fprintf(stderr, "Failed to write level: %s\n", path.c_str());
+        return false;
+    }
+
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+              fwrite(sections, sizeof(sections), 1, f) == 1 &&
+              writeSection(f, platformData, sections[0].offset) &&
+              writeSection(f, coinData, sections[1].offset) &&
+              writeSection(f, enemyData, sections[2].offset);
+    ok = (fclose(f) == 0) && ok;
+
+    if (!ok) fprintf(stderr, "Failed to write level: %s\n", path.c_str());
+    return ok;
+}
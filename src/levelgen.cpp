@@ -0,0 +1,186 @@
+#include "levelgen.h"
+#include "constants.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// Layout tuning
+static const float GROUND_Y = 50.0f;
+static const float GROUND_HEIGHT = 25.0f;
+static const float MIN_FLOAT_TOP = 110.0f;
+static const float MAX_FLOAT_TOP = 500.0f;
+static const float MAX_BONUS_TOP = 620.0f;
+static const float REACH_SAFETY = 0.75f;     // Fraction of the ideal jump reach used for gaps
+static const float MAX_RISE_FRACTION = 0.65f;  // Fraction of jumpApex() used for step-ups
+static const float MIN_SEPARATION = 20.0f;   // Closest two platforms' extents may get
+static const float MAX_MOVE_RANGE = 45.0f;
+
+// ─────────────────────────────────────────
+// Jump arc
+// ─────────────────────────────────────────
+
+struct ArcSample {
+    float x, y;
+};
+
+// Full-speed jump from the ground, stepped exactly like Player::update in the air
+static std::vector<ArcSample> buildJumpArc() {
+    std::vector<ArcSample> arc;
+
+    // Ground running speed converges to this under GROUND_FRICTION + ACCELERATION
+    float vx = PLAYER_SPEED * ACCELERATION / (1.0f - GROUND_FRICTION * (1.0f - ACCELERATION));
+    float vy = JUMP_VELOCITY;
+    float x = 0, y = 0;
+
+    while (y > -1000.0f) {
+        vy -= GRAVITY;
+        if (vy < MAX_FALL_SPEED) vy = MAX_FALL_SPEED;
+        vx *= AIR_RESISTANCE;
+        vx += (PLAYER_SPEED - vx) * ACCELERATION;
+        x += vx;
+        y += vy;
+        ArcSample s = {x, y};
+        arc.push_back(s);
+    }
+    return arc;
+}
+
+static const std::vector<ArcSample>& jumpArc() {
+    static const std::vector<ArcSample> arc = buildJumpArc();
+    return arc;
+}
+
+float jumpReach(float rise) {
+    const std::vector<ArcSample>& arc = jumpArc();
+    for (size_t i = arc.size(); i-- > 0;) {
+        if (arc[i].y >= rise) return arc[i].x;
+    }
+    return 0.0f;
+}
+
+float jumpApex() {
+    float apex = 0;
+    for (const ArcSample& s : jumpArc()) apex = std::max(apex, s.y);
+    return apex;
+}
+
+// ─────────────────────────────────────────
+// Generator
+// ─────────────────────────────────────────
+
+// xorshift32: small, fast and identical on every platform (unlike std:: distributions)
+struct LevelRng {
+    uint32_t state;
+
+    explicit LevelRng(uint32_t seed) : state(seed ? seed : 0x9E3779B9u) {}
+
+    uint32_t next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    float uniform(float lo, float hi) { return lo + (hi - lo) * (next() >> 8) / 16777216.0f; }
+    bool chance(float p) { return uniform(0.0f, 1.0f) < p; }
+};
+
+// `x` as stored in a float, stepped back inside [lo, hi] if rounding took it out, and never
+// past `hi` (the jump's reach) even where no float falls inside. Floats are 16 px apart by
+// 2e8 px, so the generator works in double and rounds once per platform.
+static float storedX(double x, double lo, double hi) {
+    float f = (float)x;
+    while (f > hi) f = nextafterf(f, -INFINITY);
+    while (f < lo && nextafterf(f, INFINITY) <= hi) f = nextafterf(f, INFINITY);
+    return f;
+}
+
+float generateLevel(const LevelGenParams& params, std::vector<Platform>& platforms,
+                    std::vector<Collectible>& collectibles, std::vector<Enemy>& enemies) {
+    platforms.clear();
+    collectibles.clear();
+    enemies.clear();
+    platforms.reserve(params.platformCount);
+    collectibles.reserve(params.platformCount * params.coinChance * 1.2f);
+    enemies.reserve(params.platformCount * params.enemyChance * 0.6f);
+
+    Color groundColor(0.2f, 0.7f, 0.2f);
+    Color floatColor(0.8f, 0.5f, 0.2f);
+    Color highColor(0.6f, 0.3f, 0.8f);
+    Color moveColor(0.5f, 0.4f, 0.7f);
+
+    LevelRng rng(params.seed);
+    float maxRise = jumpApex() * MAX_RISE_FRACTION;
+
+    // Starting ground under the player spawn
+    platforms.push_back(Platform(0, GROUND_Y, 400, GROUND_HEIGHT, groundColor));
+    double prevRight = 400;  // Right edge at rest (originalX + width), as stored
+    float prevRange = 0;     // Movement amplitude of the previous path platform
+    float prevTop = GROUND_Y + GROUND_HEIGHT;
+
+    while ((int)platforms.size() < params.platformCount) {
+        bool ground = rng.chance(0.2f);
+        float width, height, top, range = 0;
+        if (ground) {
+            width = rng.uniform(150, 450);
+            height = GROUND_HEIGHT;
+            top = GROUND_Y + GROUND_HEIGHT;
+        } else {
+            width = rng.uniform(60, 160);
+            height = rng.chance(0.5f) ? 18.0f : 15.0f;
+            top = std::min(std::max(prevTop + rng.uniform(-180, maxRise), MIN_FLOAT_TOP),
+                           MAX_FLOAT_TOP);
+            if (rng.chance(params.movingChance)) range = rng.uniform(20, MAX_MOVE_RANGE);
+        }
+
+        // Gap measured between the worst-case positions of both platforms, so the jump
+        // works whatever phase moving platforms are in
+        float reach = jumpReach(top - prevTop) * REACH_SAFETY;
+        if (MIN_SEPARATION + 2 * (prevRange + range) > reach) range = 0;
+        if (MIN_SEPARATION + 2 * prevRange > reach) {
+            top = prevTop;
+            reach = jumpReach(0) * REACH_SAFETY;
+        }
+        float maxSeparation = reach - 2 * (prevRange + range);
+        float separation = rng.uniform(MIN_SEPARATION, maxSeparation);
+        double start = prevRight + prevRange + range;
+        float x = storedX(start + separation, start + MIN_SEPARATION, start + maxSeparation);
+        bool moving = range > 0;
+        bool risingOrLevel = top >= prevTop;
+
+        Color color = ground ? groundColor : (moving ? moveColor : floatColor);
+        platforms.push_back(Platform(x, top - height, width, height, color, moving,
+                                     moving ? rng.uniform(0.02f, 0.035f) : 0, range));
+
+        if (rng.chance(params.coinChance)) {
+            collectibles.push_back(Collectible((float)(x + (double)width / 2), top + 22));
+        }
+        if (!moving && width >= 100 && rng.chance(params.enemyChance)) {
+            enemies.push_back(Enemy((float)(x + (double)width / 2), top + 18,
+                                    (float)(x + 12.0), (float)(x + (double)width - 12)));
+        }
+
+        // Bonus platform over the left half, high enough that no single-jump arc into or
+        // out of this platform can hit it from below; reached by double-jumping from the
+        // free right half
+        bool bonusFits = !moving && risingOrLevel && width >= 100 &&
+                         top + 270 <= MAX_BONUS_TOP &&
+                         (int)platforms.size() < params.platformCount;
+        if (bonusFits && rng.chance(params.bonusChance)) {
+            float bonusTop = top + rng.uniform(270, std::min(320.0f, MAX_BONUS_TOP - top));
+            float bonusWidth = rng.uniform(50, width * 0.5f);
+            float bonusX = (float)(x + (double)rng.uniform(0, width * 0.5f - bonusWidth));
+            platforms.push_back(Platform(bonusX, bonusTop - 18, bonusWidth, 18, highColor));
+            if (rng.chance(params.coinChance)) {
+                collectibles.push_back(
+                    Collectible((float)(bonusX + (double)bonusWidth / 2), bonusTop + 22));
+            }
+        }
+
+        prevRight = (double)x + width;
+        prevRange = range;
+        prevTop = top;
+    }
+
+    return (float)(prevRight + prevRange + 50);
+}
@@ -1,78 +1,191 @@
-#include <GL/glut.h>
+#include <GL/freeglut.h>
+#include <algorithm>
 #include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include "arena.h"
+#include "backend.h"
+#include "bot.h"
+#include "capture.h"
 #include "game.h"
+#include "netplay.h"
+#include "spectator.h"
 #include "constants.h"
 
 // Global game instance
 Game* game = nullptr;
+Bot* bot = nullptr;  // --autoplay
+
+// Online co-op (--peer): keys become session input instead of going to the game
+UdpTransport transport;
+RollbackSession* session = nullptr;
+InputBits heldInput = 0;    // Directions held
+bool jumpPressed = false;   // Since the last input was taken
+bool inputTaken = true;     // The session ran a tick with `netInput`
+InputBits netInput = 0;
+SpectatorPublisher* spectators = nullptr;  // --spectators
+FrameCapture* capture = nullptr;           // --capture
+int tickIntervalMs = 16;
 
 // GLUT callback functions
 void display() {
-    glClear(GL_COLOR_BUFFER_BIT);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-    glOrtho(0, WINDOW_WIDTH, 0, WINDOW_HEIGHT, -1, 1);
-    glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
+    frameArena.reset();  // Last frame's temporaries
+    RenderBackend& gfx = renderBackend();
+    gfx.beginFrame(WINDOW_WIDTH, WINDOW_HEIGHT);
 
     if (game) {
         game->render();
     }
 
-    glDisable(GL_BLEND);
+    gfx.endFrame();
+    if (capture) capture->captureFrame();
     glutSwapBuffers();
 }
 
 void timer(int value) {
-    if (game) {
+    if (session) {
+        // A waiting session gets the same input again next time
+        if (inputTaken) {
+            netInput = bot ? bot->decide(*game) : heldInput | (jumpPressed ? INPUT_JUMP : 0);
+            jumpPressed = false;
+        }
+        inputTaken = session->advance(netInput);
+        if (session->hasEnded()) {
+            std::cout << "Online co-op ended: the game state could not be saved" << std::endl;
+            exit(1);
+        }
+    } else if (game) {
+        if (bot) bot->act(*game);
         game->update();
     }
+    if (spectators) spectators->publish(*game);
     glutPostRedisplay();
-    glutTimerFunc(16, timer, 0);  // ~60 FPS
+    glutTimerFunc(tickIntervalMs, timer, 0);  // ~60 FPS unless --tick-rate is lower
 }
 
 void update(int value) {
-    if (game) {
+    if (game && !session) {
         game->processInput();
     }
     glutTimerFunc(16, update, 0);
 }
 
+void netKey(InputBits bit, bool down) {
+    if (bit == INPUT_JUMP) {
+        jumpPressed |= down;
+    } else if (down) {
+        heldInput |= bit;
+    } else {
+        heldInput &= ~bit;
+    }
+}
+
+InputBits netKeyBit(unsigned char key) {
+    switch (key) {
+        case 'a':
+        case 'A':
+            return INPUT_LEFT;
+        case 'd':
+        case 'D':
+            return INPUT_RIGHT;
+        case 'w':
+        case 'W':
+        case ' ':
+            return INPUT_JUMP;
+    }
+    return 0;
+}
+
+InputBits netSpecialBit(int key) {
+    switch (key) {
+        case GLUT_KEY_LEFT:
+            return INPUT_LEFT;
+        case GLUT_KEY_RIGHT:
+            return INPUT_RIGHT;
+        case GLUT_KEY_UP:
+            return INPUT_JUMP;
+    }
+    return 0;
+}
+
+// Once an online game is won or lost, restarting it (R) or leaving for the menu (Q, ESC)
+// ends the session: the peers would no longer start from the same state. The game carries
+// on here, offline, with the key.
+void leaveFinishedSession(unsigned char key) {
+    GameState state = game->getState();
+    if (state != GameState::GAME_OVER && state != GameState::WIN) return;
+    if (key != 'r' && key != 'R' && key != 'q' && key != 'Q' && key != 27) return;
+    delete session;
+    session = nullptr;
+    transport.close();
+    heldInput = 0;
+    jumpPressed = false;
+    inputTaken = true;
+    std::cout << "Online co-op session ended" << std::endl;
+}
+
 void keyboardDown(unsigned char key, int x, int y) {
-    if (game) {
+    if (session) leaveFinishedSession(key);
+    if (session) {
+        if (key == 27) exit(0);
+        netKey(netKeyBit(key), true);
+    } else if (game) {
         game->handleKeyDown(key);
     }
 }
 
 void keyboardUp(unsigned char key, int x, int y) {
-    if (game) {
+    if (session) {
+        netKey(netKeyBit(key), false);
+    } else if (game) {
         game->handleKeyUp(key);
     }
 }
 
 void specialDown(int key, int x, int y) {
-    if (game) {
+    if (session) {
+        netKey(netSpecialBit(key), true);
+    } else if (game) {
         game->handleSpecialDown(key);
     }
 }
 
 void specialUp(int key, int x, int y) {
-    if (game) {
+    if (session) {
+        netKey(netSpecialBit(key), false);
+    } else if (game) {
         game->handleSpecialUp(key);
     }
 }
 
+// ESC exits from inside the game, so the capture is finished from here
+void stopCapture() {
+    if (!capture || !capture->isActive()) return;
+    capture->stop();
+    const CaptureStats& stats = capture->getStats();
+    printf("Captured %d frames (%d dropped); game thread %.2f ms per frame on average, "
+           "%.2f ms at most\n",
+           stats.written, stats.dropped, stats.gameMs / std::max(1, stats.frames + stats.dropped),
+           stats.maxGameMs);
+}
+
+void reportTextures() {
+    const TextureStats& stats = TextureManager::getInstance().getStats();
+    printf("Textures: %zu KiB resident, %zu KiB at most (budget %zu KiB); %d evictions, "
+           "%d reloads, %d draws stalled, longest reload %d frames\n",
+           stats.residentBytes / 1024, stats.peakBytes / 1024, stats.budgetBytes / 1024,
+           stats.evictions, stats.reloads, stats.stalledDraws, stats.maxStallFrames);
+}
+
+// Sizes FRAME_ARENA_BYTES
+void reportFrameArena() {
+    const FrameArenaStats& stats = frameArena.getStats();
+    printf("Frame arena: %.1f KiB at most of %zu KiB; %d allocations overflowed to the heap\n",
+           stats.highWater / 1024.0, stats.capacity / 1024, stats.overflows);
+}
+
 void init() {
     glClearColor(0.6f, 0.8f, 1.0f, 1.0f);
-    glPointSize(1.0f);
-    glLineWidth(1.0f);
-    glEnable(GL_POINT_SMOOTH);
-    glEnable(GL_LINE_SMOOTH);
-    glHint(GL_POINT_SMOOTH_HINT, GL_NICEST);
-    glHint(GL_LINE_SMOOTH_HINT, GL_NICEST);
 }
 
 void printInstructions() {
@@ -88,17 +201,147 @@ void printInstructions() {
 
 int main(int argc, char** argv) {
     glutInit(&argc, argv);
+
+    // Level selection: --level FILE, or a procedural level with --seed N [--platforms N].
+    // Defaults to the packed built-in level, falling back to the compiled-in copy.
+    bool generated = false;
+    LevelGenParams levelParams;
+    std::string levelPath = "assets/levels/default.phl";
+    int threads = JobSystem::defaultWorkerCount();
+    int tickRate = BASE_TICK_RATE;
+    bool autoplay = false;
+    // Online co-op: --peer HOST:PORT [--port N] [--player 1|2]. Both peers need the same level.
+    std::string peer;
+    int port = 7777, slot = 0;
+    std::string spectatorAddress;  // unix:PATH or a localhost TCP port
+    // Capture: --capture FILE.y4m or --capture DIR (PNGs) [--capture-workers N]
+    std::string capturePath;
+    int captureWorkers = std::max(1, JobSystem::defaultWorkerCount());
+    SpriteSource sprites = SpriteSource::GENERATED;  // --sprites generated|pack|png
+    bool hotReload = false;  // Reload sprites as assets/sprites/*.png are saved
+    size_t textureBudget = 0;  // --texture-budget KIB
+    RendererKind renderer = RendererKind::FIXED_FUNCTION;  // --renderer fixed|core
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--autoplay") == 0) {
+            autoplay = true;
+            continue;
+        }
+        if (strcmp(argv[i], "--hot-reload") == 0) {
+            hotReload = true;
+            continue;
+        }
+        if (i + 1 >= argc) break;
+        if (strcmp(argv[i], "--level") == 0) {
+            levelPath = argv[++i];
+        } else if (strcmp(argv[i], "--seed") == 0) {
+            levelParams.seed = strtoul(argv[++i], nullptr, 10);
+            generated = true;
+        } else if (strcmp(argv[i], "--platforms") == 0) {
+            levelParams.platformCount = atoi(argv[++i]);
+            generated = true;
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--tick-rate") == 0) {
+            tickRate = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--peer") == 0) {
+            peer = argv[++i];
+        } else if (strcmp(argv[i], "--port") == 0) {
+            port = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--player") == 0) {
+            slot = atoi(argv[++i]) == 2 ? 1 : 0;
+        } else if (strcmp(argv[i], "--spectators") == 0) {
+            spectatorAddress = argv[++i];
+        } else if (strcmp(argv[i], "--capture") == 0) {
+            capturePath = argv[++i];
+        } else if (strcmp(argv[i], "--capture-workers") == 0) {
+            captureWorkers = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--texture-budget") == 0) {
+            textureBudget = strtoul(argv[++i], nullptr, 10) * 1024;
+        } else if (strcmp(argv[i], "--renderer") == 0) {
+            renderer = strcmp(argv[++i], "core") == 0 ? RendererKind::CORE
+                                                       : RendererKind::FIXED_FUNCTION;
+        } else if (strcmp(argv[i], "--sprites") == 0) {
+            i++;
+            if (strcmp(argv[i], "pack") == 0) {
+                sprites = SpriteSource::PACK;
+            } else if (strcmp(argv[i], "png") == 0) {
+                sprites = SpriteSource::FILES;
+            }
+        }
+    }
+
     glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB | GLUT_ALPHA);
     glutInitWindowSize(WINDOW_WIDTH, WINDOW_HEIGHT);
     glutInitWindowPosition(100, 100);
+    if (renderer == RendererKind::CORE) {
+        glutInitContextVersion(3, 3);
+        glutInitContextProfile(GLUT_CORE_PROFILE);
+    }
     glutCreateWindow("PIXEL HERO");
 
+    if (!selectRenderBackend(renderer)) return 1;
     init();
     printInstructions();
 
     // Create game instance
     game = new Game();
+    game->setWorkerThreads(threads);
+    game->setTickRate(tickRate);
+    game->setSpriteSource(sprites);
+    tickIntervalMs = 16 * BASE_TICK_RATE / game->getTickRate();
+    if (generated) {
+        game->setGeneratedLevel(levelParams);
+    } else if (!game->setLevelFile(levelPath)) {
+        std::cout << "Using built-in level" << std::endl;
+    }
     game->init();
+    atexit(reportFrameArena);
+    if (textureBudget) {
+        TextureManager::getInstance().setTextureBudget(textureBudget);
+        atexit(reportTextures);
+    }
+    if (hotReload && TextureManager::getInstance().watchSprites("assets/sprites")) {
+        std::cout << "Watching assets/sprites for changes" << std::endl;
+    }
+    if (autoplay) bot = new Bot(peer.empty() ? 0 : slot);
+
+    if (!peer.empty()) {
+        size_t colon = peer.rfind(':');
+        if (colon == std::string::npos ||
+            !transport.open(port, peer.substr(0, colon), atoi(peer.c_str() + colon + 1))) {
+            std::cout << "Cannot reach peer " << peer << std::endl;
+            return 1;
+        }
+        // Straight into a two-player game; ticks wait until the peer is there too
+        game->setTwoPlayer(true);
+        game->handleKeyDown(13);
+        game->handleKeyUp(13);
+        if (game->getStreamer().isStreaming()) {
+            std::cout << "Online co-op cannot roll back a streamed level; use a smaller one"
+                      << std::endl;
+            return 1;
+        }
+        session = new RollbackSession(*game, transport, slot);
+        std::cout << "Online co-op as player " << slot + 1 << " with " << peer << std::endl;
+    }
+
+    if (!spectatorAddress.empty()) {
+        spectators = new SpectatorPublisher();
+        if (!spectators->listen(spectatorAddress)) return 1;
+        std::cout << "Spectators can watch at " << spectatorAddress << std::endl;
+    }
+
+    if (!capturePath.empty()) {
+        bool y4m = capturePath.size() > 4 &&
+                   capturePath.compare(capturePath.size() - 4, 4, ".y4m") == 0;
+        capture = new FrameCapture();
+        if (!capture->start(capturePath, y4m ? CaptureFormat::Y4M : CaptureFormat::PNG,
+                            WINDOW_WIDTH, WINDOW_HEIGHT, game->getTickRate(), captureWorkers)) {
+            return 1;
+        }
+        atexit(stopCapture);
+        std::cout << "Capturing to " << capturePath << std::endl;
+    }
 
     // Register GLUT callbacks
     glutDisplayFunc(display);
@@ -112,6 +355,11 @@ int main(int argc, char** argv) {
     glutMainLoop();
 
     // Cleanup
+    stopCapture();
+    delete capture;
+    capture = nullptr;
+    delete spectators;
+    delete session;
     delete game;
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,231 @@
+#include "netplay.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+// Datagram layout, little-endian:
+//   u8  magic, u8 version
+//   i32 ack             remote ticks received (all below it)
+//   i32 checksum tick   -1 if none yet
+//   u32 checksum
+//   i32 first tick      of the inputs that follow
+//   u8  count, then count input bytes
+static const uint8_t PACKET_MAGIC = 0xB7;
+static const uint8_t PACKET_VERSION = 1;
+static const size_t PACKET_HEADER = 19;
+static const size_t MAX_PACKET = 512;
+
+static void put32(uint8_t* p, uint32_t v) {
+    p[0] = v;
+    p[1] = v >> 8;
+    p[2] = v >> 16;
+    p[3] = v >> 24;
+}
+
+static uint32_t get32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// FNV-1a over the gameplay state of a snapshot (not effect timers)
+static uint32_t mix(uint32_t hash, const void* data, size_t size) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < size; i++) hash = (hash ^ bytes[i]) * 16777619u;
+    return hash;
+}
+
+static uint32_t mixPlayer(uint32_t hash, const Player& p) {
+    const float values[] = {p.x, p.y, p.vx, p.vy, p.targetVx, p.wallJumpCooldown};
+    const int flags[] = {p.onGround, p.wallSliding, p.wallDirection, p.jumpCount, p.facingRight};
+    hash = mix(hash, values, sizeof(values));
+    return mix(hash, flags, sizeof(flags));
+}
+
+uint32_t stateChecksum(const GameSnapshot& s) {
+    uint32_t hash = 2166136261u;
+    hash = mixPlayer(hash, s.player);
+    hash = mixPlayer(hash, s.partner);
+    const int values[] = {s.score, s.lives, s.coinsCollected, (int)s.state, s.simTick,
+                          (int)s.changeCount};
+    return mix(hash, values, sizeof(values));
+}
+
+RollbackSession::RollbackSession(Game& g, Transport& t, int slot)
+    : game(g),
+      transport(t),
+      localSlot(slot),
+      tick(0),
+      remoteReceived(0),
+      remoteAcked(0),
+      firstMismatch(-1),
+      ended(false),
+      nextChecksumTick(0),
+      latestChecksum({-1, 0}),
+      pendingRemote({-1, 0}),
+      lastCompared(-1),
+      stats() {
+    for (int i = 0; i < HISTORY; i++) {
+        localInputs[i] = remoteInputs[i] = usedRemote[i] = 0;
+        remoteTicks[i] = -1;
+    }
+    for (Checksum& c : localChecksums) c = {-1, 0};
+}
+
+bool RollbackSession::advance(InputBits local) {
+    if (ended) return false;
+    receive();
+
+    // Too far ahead of what the peer has sent, or of what it has acknowledged of ours
+    if (tick - remoteReceived >= MAX_ROLLBACK || tick - remoteAcked >= HISTORY / 2) {
+        stats.stalls++;
+        send();
+        return false;
+    }
+
+    if (firstMismatch >= 0) rollback();
+    if (ended) return false;
+
+    localInputs[tick % HISTORY] = local;
+    if (!simulate(tick, predictRemote(tick))) return false;
+    tick++;
+    stats.ticks++;
+
+    updateChecksums();
+    send();
+    return true;
+}
+
+void RollbackSession::poll() {
+    if (ended) return;
+    receive();
+    if (firstMismatch >= 0) rollback();
+    updateChecksums();
+    send();
+}
+
+// Play tick `t` from the current state, saving that state first. Ends the session instead
+// if the state cannot be saved.
+bool RollbackSession::simulate(int t, InputBits remote) {
+    int slot = t % HISTORY;
+    if (!game.saveState(snapshots[slot])) {
+        ended = true;
+        return false;
+    }
+    usedRemote[slot] = remote;
+
+    // Same order on both peers: player 0, then player 1
+    InputBits inputs[2];
+    inputs[localSlot] = localInputs[slot];
+    inputs[1 - localSlot] = remote;
+    game.applyInput(0, inputs[0]);
+    game.applyInput(1, inputs[1]);
+    game.update();
+    return true;
+}
+
+InputBits RollbackSession::predictRemote(int t) const {
+    if (remoteTicks[t % HISTORY] == t) return remoteInputs[t % HISTORY];
+    if (remoteReceived == 0) return 0;
+    // Keep walking the way the peer last walked; a jump is a one-off
+    return remoteInputs[(remoteReceived - 1) % HISTORY] & ~INPUT_JUMP;
+}
+
+void RollbackSession::rollback() {
+    auto start = std::chrono::steady_clock::now();
+    int from = firstMismatch;
+    firstMismatch = -1;
+
+    if (!game.loadState(snapshots[from % HISTORY])) {
+        ended = true;
+        return;
+    }
+    game.setReplaying(true);
+    for (int t = from; t < tick && !ended; t++) simulate(t, predictRemote(t));
+    game.setReplaying(false);
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+                    .count();
+    stats.rollbacks++;
+    stats.resimulatedTicks += tick - from;
+    stats.maxRollback = std::max(stats.maxRollback, tick - from);
+    stats.maxRollbackMs = std::max(stats.maxRollbackMs, ms);
+}
+
+void RollbackSession::receive() {
+    uint8_t packet[MAX_PACKET];
+    size_t size;
+    while ((size = transport.receive(packet, sizeof(packet))) > 0) {
+        if (size < PACKET_HEADER || packet[0] != PACKET_MAGIC || packet[1] != PACKET_VERSION) {
+            continue;
+        }
+        int ack = (int)get32(packet + 2);
+        Checksum remote = {(int)get32(packet + 6), get32(packet + 10)};
+        int firstTick = (int)get32(packet + 14);
+        int count = packet[18];
+        if ((size_t)count > size - PACKET_HEADER || firstTick < 0) continue;
+
+        if (ack > remoteAcked && ack <= tick) remoteAcked = ack;
+        readInputs(packet + PACKET_HEADER, firstTick, count);
+        if (remote.tick >= 0) compareChecksum(remote);
+    }
+}
+
+void RollbackSession::readInputs(const uint8_t* data, int firstTick, int count) {
+    for (int i = 0; i < count; i++) {
+        int t = firstTick + i;
+        if (t < remoteReceived || t >= remoteReceived + HISTORY / 2) continue;
+        int slot = t % HISTORY;
+        if (remoteTicks[slot] == t) continue;  // Duplicate
+        remoteTicks[slot] = t;
+        remoteInputs[slot] = data[i];
+
+        // Already played with a guess that turned out wrong
+        if (t < tick && usedRemote[slot] != data[i] &&
+            (firstMismatch < 0 || t < firstMismatch)) {
+            firstMismatch = t;
+        }
+    }
+    while (remoteTicks[remoteReceived % HISTORY] == remoteReceived) remoteReceived++;
+}
+
+// Checksum the state before every CHECKSUM_INTERVAL-th tick once all input before it is
+// confirmed, i.e. once no rollback can change it again
+void RollbackSession::updateChecksums() {
+    while (nextChecksumTick < tick && nextChecksumTick <= remoteReceived) {
+        Checksum c = {nextChecksumTick, stateChecksum(snapshots[nextChecksumTick % HISTORY])};
+        localChecksums[(c.tick / CHECKSUM_INTERVAL) % CHECKSUM_SLOTS] = c;
+        latestChecksum = c;
+        if (pendingRemote.tick == c.tick) compareChecksum(pendingRemote);
+        nextChecksumTick += CHECKSUM_INTERVAL;
+    }
+}
+
+void RollbackSession::compareChecksum(const Checksum& remote) {
+    if (remote.tick <= lastCompared) return;
+    const Checksum& local = localChecksums[(remote.tick / CHECKSUM_INTERVAL) % CHECKSUM_SLOTS];
+    if (local.tick != remote.tick) {
+        if (remote.tick > local.tick) pendingRemote = remote;  // Ours is not ready yet
+        return;
+    }
+    lastCompared = remote.tick;
+    stats.checksumsCompared++;
+    if (local.value != remote.value) stats.desyncs++;
+}
+
+void RollbackSession::send() {
+    uint8_t packet[PACKET_HEADER + HISTORY / 2];
+    int first = std::max(remoteAcked, tick - HISTORY / 2);
+    int count = tick - first;
+
+    packet[0] = PACKET_MAGIC;
+    packet[1] = PACKET_VERSION;
+    put32(packet + 2, remoteReceived);
+    put32(packet + 6, latestChecksum.tick);
+    put32(packet + 10, latestChecksum.value);
+    put32(packet + 14, first);
+    packet[18] = count;
+    for (int i = 0; i < count; i++) packet[PACKET_HEADER + i] = localInputs[(first + i) % HISTORY];
+
+    transport.send(packet, PACKET_HEADER + count);
+    stats.datagramsSent++;
+    stats.bytesSent += PACKET_HEADER + count;
+}
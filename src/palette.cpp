@@ -0,0 +1,72 @@
+#include "palette.h"
+#include <cstring>
+
+uint32_t packColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
+    uint8_t bytes[4] = {r, g, b, a};
+    uint32_t color;
+    memcpy(&color, bytes, 4);
+    return color;
+}
+
+bool indexColors(const unsigned char* rgba, int count, std::vector<uint32_t>& palette,
+                 std::vector<unsigned char>& indices) {
+    // Open addressing over 1024 slots, at most a quarter full. Runs of one colour are common
+    // in pixel art, so the last colour is checked before hashing.
+    const int SLOTS = 1024;
+    uint32_t keys[SLOTS];
+    int16_t values[SLOTS];
+    for (int i = 0; i < SLOTS; i++) values[i] = -1;
+
+    palette.clear();
+    indices.resize(count);
+    uint32_t last = 0;
+    int lastIndex = -1;
+    for (int i = 0; i < count; i++) {
+        uint32_t color;
+        memcpy(&color, rgba + (size_t)i * 4, 4);
+        if (rgba[(size_t)i * 4 + 3] == 0) color = 0;
+
+        if (lastIndex < 0 || color != last) {
+            int slot = (int)((color * 2654435761u) >> 22);
+            while (values[slot] >= 0 && keys[slot] != color) slot = (slot + 1) & (SLOTS - 1);
+            if (values[slot] < 0) {
+                if (palette.size() == 256) return false;
+                keys[slot] = color;
+                values[slot] = (int16_t)palette.size();
+                palette.push_back(color);
+            }
+            last = color;
+            lastIndex = values[slot];
+        }
+        indices[i] = (unsigned char)lastIndex;
+    }
+    return true;
+}
+
+void expandIndexed(const unsigned char* indices, int count, const uint32_t* palette,
+                   unsigned char* rgba) {
+    for (int i = 0; i < count; i++) memcpy(rgba + (size_t)i * 4, &palette[indices[i]], 4);
+}
+
+static uint8_t scaleChannel(uint8_t value, float scale) {
+    float scaled = value * scale + 0.5f;
+    return scaled >= 255.0f ? 255 : (uint8_t)scaled;
+}
+
+void swapPalette(const std::vector<uint32_t>& base, const PaletteSwap& swap,
+                 std::vector<uint32_t>& out) {
+    out.resize(base.size());
+    for (size_t i = 0; i < base.size(); i++) {
+        uint32_t color = base[i];
+        for (const auto& pair : swap.colors) {
+            if (pair.first == color) {
+                color = pair.second;
+                break;
+            }
+        }
+        uint8_t c[4];
+        memcpy(c, &color, 4);
+        out[i] = packColor(scaleChannel(c[0], swap.r), scaleChannel(c[1], swap.g),
+                           scaleChannel(c[2], swap.b), c[3]);
+    }
+}
@@ -1,16 +1,17 @@
 #include "particle.h"
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 
 Particle::Particle(float px, float py, float pvx, float pvy, Color c, float l)
     : x(px), y(py), vx(pvx), vy(pvy), color(c), life(l), maxLife(l) {}
 
-void Particle::update() {
-    x += vx;
-    y += vy;
-    vy -= 0.2f;   // gravity on particles
-    vx *= 0.99f;  // air resistance
-    life--;
+void Particle::update(float dt, float drag) {
+    x += vx * dt;
+    y += vy * dt;
+    vy -= 0.2f * dt;  // gravity on particles
+    vx *= drag;       // air resistance
+    life -= dt;
 
     // Fade out
     color.a = life / maxLife;
@@ -20,8 +21,24 @@ bool Particle::isDead() const {
     return life <= 0;
 }
 
+static const size_t PARTICLE_GRAIN = 2048;
+
+// Air resistance per base tick
+static const float PARTICLE_DRAG = 0.99f;
+
+ParticleSystem::ParticleSystem() : updating(false), stepDt(1.0f), stepDrag(PARTICLE_DRAG) {}
+
+void ParticleSystem::setStep(float dt) {
+    stepDt = dt;
+    stepDrag = powf(PARTICLE_DRAG, dt);
+}
+
 void ParticleSystem::addParticle(float x, float y, float vx, float vy, Color color, float life) {
-    particles.push_back(Particle(x, y, vx, vy, color, life));
+    if (updating) {
+        staged.push_back(Particle(x, y, vx, vy, color, life));
+    } else {
+        particles.push_back(Particle(x, y, vx, vy, color, life));
+    }
 }
 
 void ParticleSystem::createJumpParticles(float x, float y) {
@@ -51,13 +68,48 @@ void ParticleSystem::createCollectionParticles(float x, float y) {
     }
 }
 
-void ParticleSystem::update() {
-    for (auto it = particles.begin(); it != particles.end();) {
-        it->update();
-        if (it->isDead()) {
-            it = particles.erase(it);
-        } else {
-            ++it;
+void ParticleSystem::update(float dt) {
+    setStep(dt);
+    size_t alive = 0;
+    for (size_t i = 0; i < particles.size(); i++) {
+        particles[i].update(stepDt, stepDrag);
+        if (!particles[i].isDead()) particles[alive++] = particles[i];
+    }
+    particles.erase(particles.begin() + alive, particles.end());
+}
+
+void ParticleSystem::beginUpdate(JobSystem& jobs, JobCounter& done, float dt) {
+    setStep(dt);
+    updating = true;
+    size_t count = particles.size();
+    rangeSurvivors.assign((count + PARTICLE_GRAIN - 1) / PARTICLE_GRAIN, 0);
+
+    // Each job compacts survivors to the front of its own range
+    jobs.parallelFor(count, PARTICLE_GRAIN, [this](size_t begin, size_t end) {
+        size_t alive = begin;
+        for (size_t i = begin; i < end; i++) {
+            particles[i].update(stepDt, stepDrag);
+            if (!particles[i].isDead()) particles[alive++] = particles[i];
         }
+        rangeSurvivors[begin / PARTICLE_GRAIN] = alive - begin;
+    }, done);
+}
+
+void ParticleSystem::endUpdate() {
+    // Stitch the ranges together in order
+    size_t alive = 0;
+    for (size_t r = 0; r < rangeSurvivors.size(); r++) {
+        size_t begin = r * PARTICLE_GRAIN;
+        std::move(particles.begin() + begin, particles.begin() + begin + rangeSurvivors[r],
+                  particles.begin() + alive);
+        alive += rangeSurvivors[r];
+    }
+    particles.erase(particles.begin() + alive, particles.end());
+    updating = false;
+
+    for (Particle& p : staged) {
+        p.update(stepDt, stepDrag);
+        if (!p.isDead()) particles.push_back(p);
     }
+    staged.clear();
 }
\ No newline at end of file
@@ -12,13 +12,15 @@ Platform::Platform(float px, float py, float w, float h, Color c, bool moving, f
       moveSpeed(speed),
       moveRange(range),
       originalX(px),
-      moveTimer(0) {}
+      phase(0) {}
 
-void Platform::update() {
-    if (isMoving) {
-        moveTimer += moveSpeed;
-        x = originalX + sin(moveTimer) * moveRange;
-    }
+float Platform::xAt(float tick) const {
+    if (!isMoving) return originalX;
+    return originalX + sin(moveSpeed * (tick + phase)) * moveRange;
+}
+
+void Platform::advanceTo(int tick) {
+    if (isMoving) x = xAt(tick);
 }
 
 void initializePlatforms(std::vector<Platform>& platforms) {
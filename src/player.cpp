@@ -10,6 +10,8 @@ void Player::reset() {
     y = 400.0f;
     vx = 0.0f;
     vy = 0.0f;
+    moveX = 0.0f;
+    moveY = 0.0f;
     targetVx = 0.0f;
     onGround = false;
     wasOnGround = false;
@@ -24,31 +26,40 @@ void Player::reset() {
     wallJumpCooldown = 0;
 }
 
-void Player::update() {
+void Player::update(float dt) {
     wasOnGround = onGround;
 
     // Update animation timer
-    animationTimer += 0.1f;
+    animationTimer += 0.1f * dt;
 
     // Decrease wall jump cooldown
-    if (wallJumpCooldown > 0) wallJumpCooldown -= 0.016f;
+    if (wallJumpCooldown > 0) wallJumpCooldown -= BASE_TICK_SECONDS * dt;
 
-    // Apply physics
+    // Apply physics. Per-tick factors are raised to `dt` so a long step decays velocity as
+    // much as the base ticks it stands for.
+    float gravity = 0;
+    bool clamped = false;
     if (!onGround) {
         if (wallSliding) {
             // Slow fall while wall sliding
-            vy -= GRAVITY * 0.3f;
-            if (vy < -3.0f) vy = -3.0f;  // Slow terminal velocity on wall
-            vx *= 0.9f;
+            gravity = GRAVITY * 0.3f;
+            vy -= gravity * dt;
+            if (vy < -3.0f) {
+                vy = -3.0f;  // Slow terminal velocity on wall
+                clamped = true;
+            }
+            vx *= powf(0.9f, dt);
         } else {
-            vy -= GRAVITY;
+            gravity = GRAVITY;
+            vy -= gravity * dt;
             if (vy < MAX_FALL_SPEED) {
                 vy = MAX_FALL_SPEED;
+                clamped = true;
             }
-            vx *= AIR_RESISTANCE;
+            vx *= powf(AIR_RESISTANCE, dt);
         }
     } else {
-        vx *= GROUND_FRICTION;
+        vx *= powf(GROUND_FRICTION, dt);
         jumpCount = 0;
         wallSliding = false;
         onWall = false;
@@ -57,12 +68,15 @@ void Player::update() {
     // Smooth acceleration towards target velocity (skip during wall jump cooldown)
     if (wallJumpCooldown <= 0) {
         float velocityDiff = targetVx - vx;
-        vx += velocityDiff * ACCELERATION;
+        vx += velocityDiff * (1.0f - powf(1.0f - ACCELERATION, dt));
     }
 
-    // Update position
-    x += vx;
-    y += vy;
+    // Displacement over the step. The vertical term adds back the gravity the skipped base
+    // ticks would not yet have applied, so jump arcs pass through the same points at any
+    // tick rate.
+    moveX = vx * dt;
+    moveY = vy * dt;
+    if (!clamped) moveY += gravity * dt * (dt - 1) * 0.5f;
 
     // Update squash and stretch animation
     if (onGround && fabs(vx) > 0.5f) {
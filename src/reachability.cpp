@@ -0,0 +1,352 @@
+#include "reachability.h"
+#include "constants.h"
+#include "player.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// ─────────────────────────────────────────
+// Jump envelopes
+// ─────────────────────────────────────────
+
+static const int MAX_TABLE_RISE = 1000;  // Comfortably above any multi-jump apex
+
+// Ticks after a wall jump before steering works again, as Player::update counts them down
+static int wallJumpCooldownTicks() {
+    float cooldown = 0.2f;  // Set by Player::wallJump
+    int ticks = 0;
+    while ((cooldown -= BASE_TICK_SECONDS) > 0) ticks++;
+    return ticks;
+}
+
+JumpEnvelope::JumpEnvelope() : maxRise(0) {
+    ground.assign(MAX_TABLE_RISE - MIN_RISE + 1, -1.0f);
+    wall.assign(MAX_TABLE_RISE - MIN_RISE + 1, -1.0f);
+
+    // Ground running speed converges to this under GROUND_FRICTION + ACCELERATION
+    float runSpeed = PLAYER_SPEED * ACCELERATION / (1.0f - GROUND_FRICTION * (1.0f - ACCELERATION));
+    trace(0, 0, runSpeed, JUMP_VELOCITY, 0, Player::maxJumps - 1, ground);
+
+    // Player::wallJump: launch away from the wall, one jump used
+    trace(0, 0, PLAYER_SPEED * 2.5f, JUMP_VELOCITY * 0.9f, wallJumpCooldownTicks(),
+          Player::maxJumps - 1, wall);
+
+    fill(ground);
+    fill(wall);
+    for (int i = MAX_TABLE_RISE - MIN_RISE; i >= 0; i--) {
+        if (ground[i] >= 0 || wall[i] >= 0) {
+            maxRise = i + MIN_RISE;
+            break;
+        }
+    }
+}
+
+// Step one airborne arc at full speed, exactly like Player::update, branching into a fresh
+// jump at every tick while jumps remain. Records the farthest x seen at each height.
+void JumpEnvelope::trace(float x, float y, float vx, float vy, int cooldownTicks, int jumpsLeft,
+                         std::vector<float>& table) {
+    while (y > MIN_RISE) {
+        if (jumpsLeft > 0) trace(x, y, vx, JUMP_VELOCITY, cooldownTicks, jumpsLeft - 1, table);
+
+        vy -= GRAVITY;
+        if (vy < MAX_FALL_SPEED) vy = MAX_FALL_SPEED;
+        vx *= AIR_RESISTANCE;
+        if (cooldownTicks > 0) {
+            cooldownTicks--;
+        } else {
+            vx += (PLAYER_SPEED - vx) * ACCELERATION;
+        }
+        x += vx;
+        y += vy;
+
+        int bucket = std::min((int)floor(y), MAX_TABLE_RISE) - MIN_RISE;
+        if (bucket >= 0 && x > table[bucket]) table[bucket] = x;
+    }
+}
+
+// Turn "farthest x at this height" into "farthest x at this height or above"
+void JumpEnvelope::fill(std::vector<float>& table) {
+    for (size_t i = table.size() - 1; i-- > 0;) table[i] = std::max(table[i], table[i + 1]);
+}
+
+float JumpEnvelope::reach(TakeOff style, float rise) const {
+    const std::vector<float>& table = style == TakeOff::GROUND ? ground : wall;
+    int bucket = std::max((int)ceil(rise), MIN_RISE) - MIN_RISE;
+    if (bucket >= (int)table.size()) return -1.0f;
+    return table[bucket];
+}
+
+float JumpEnvelope::maxReach() const {
+    return std::max(ground[0], wall[0]);
+}
+
+// ─────────────────────────────────────────
+// Graph
+// ─────────────────────────────────────────
+
+// Platform extent over its whole movement range
+static void platformRange(const Platform& p, float& left, float& right) {
+    float range = p.isMoving ? fabs(p.moveRange) : 0;
+    left = p.originalX - range;
+    right = p.originalX + range + p.width;
+}
+
+static NodeSpan nodeSpan(const Platform& p, int kind) {
+    float left, right;
+    platformRange(p, left, right);
+    float travel = right - left - p.width;  // Movement range of each face
+
+    NodeSpan s;
+    switch (kind) {
+        case ReachabilityGraph::NODE_TOP:
+            s.left = left - PLAYER_HALF_WIDTH;
+            s.right = right + PLAYER_HALF_WIDTH;
+            s.y = p.y + p.height + PLAYER_HALF_HEIGHT;
+            s.away = 0;
+            break;
+        case ReachabilityGraph::NODE_LEFT_FACE:
+            s.left = left - PLAYER_HALF_WIDTH;
+            s.right = s.left + travel;
+            s.y = p.y + p.height / 2;
+            s.away = -1;
+            break;
+        default:
+            s.right = right + PLAYER_HALF_WIDTH;
+            s.left = s.right - travel;
+            s.y = p.y + p.height / 2;
+            s.away = 1;
+            break;
+    }
+    return s;
+}
+
+static NodeGraph flatten(std::vector<std::vector<int>>& adjacency) {
+    NodeGraph g;
+    g.offsets.assign(adjacency.size() + 1, 0);
+    for (size_t n = 0; n < adjacency.size(); n++) {
+        g.offsets[n + 1] = g.offsets[n] + adjacency[n].size();
+    }
+    g.targets.reserve(g.offsets.back());
+    for (std::vector<int>& edges : adjacency) {
+        g.targets.insert(g.targets.end(), edges.begin(), edges.end());
+        std::vector<int>().swap(edges);
+    }
+    return g;
+}
+
+ReachabilityGraph::ReachabilityGraph() : window(0) {}
+
+const JumpEnvelope& ReachabilityGraph::envelope() {
+    static const JumpEnvelope shared;
+    return shared;
+}
+
+// Arcs that dip below the death line on the way are not ruled out
+bool ReachabilityGraph::canReach(const NodeSpan& from, float left, float right, float y) const {
+    if (y < FALL_DEATH_Y) return false;  // The player dies before getting there
+
+    float reach = envelope().reach(TakeOff::GROUND, y - from.y);
+    if (reach >= 0 && right >= from.left - reach && left <= from.right + reach) return true;
+    if (from.away == 0) return false;
+
+    reach = envelope().reach(TakeOff::WALL, y - from.y);
+    if (reach < 0) return false;
+    if (from.away < 0) return right >= from.left - reach && left <= from.right;
+    return left <= from.right + reach && right >= from.left;
+}
+
+void ReachabilityGraph::platformsNear(float left, float right, std::vector<int>& out) const {
+    index.query(left - window, right + window, out);
+}
+
+void ReachabilityGraph::build(const std::vector<Platform>& platforms, JobSystem& jobs) {
+    const size_t PLATFORM_GRAIN = 256;
+
+    // Coin pickup adds its radius on top of the longest jump
+    window = envelope().maxReach() + PLAYER_HALF_WIDTH + COIN_PICKUP_RADIUS;
+    index.build(platforms);
+
+    int platformNodes = platforms.size() * NODES_PER_PLATFORM;
+    spans.resize(platformNodes + 1);
+    for (int node = 0; node < platformNodes; node++) {
+        spans[node] = nodeSpan(platforms[platformOf(node)], node % NODES_PER_PLATFORM);
+    }
+    Player spawnPlayer;
+    spans[platformNodes] = {spawnPlayer.x, spawnPlayer.x, spawnPlayer.y, 0};
+
+    // Edges out of every platform's nodes, platforms split across jobs
+    std::vector<std::vector<int>> adjacency(platformNodes + 1);
+    auto addEdges = [&](int node, const std::vector<int>& candidates) {
+        const NodeSpan& from = spans[node];
+        for (int j : candidates) {
+            for (int k = 0; k < NODES_PER_PLATFORM; k++) {
+                int target = j * NODES_PER_PLATFORM + k;
+                if (target == node) continue;
+                const NodeSpan& to = spans[target];
+                if (canReach(from, to.left, to.right, to.y)) adjacency[node].push_back(target);
+            }
+        }
+    };
+
+    JobCounter built;
+    jobs.parallelFor(platforms.size(), PLATFORM_GRAIN, [&](size_t begin, size_t end) {
+        std::vector<int> candidates;
+        for (size_t i = begin; i < end; i++) {
+            float left, right;
+            platformRange(platforms[i], left, right);
+            platformsNear(left, right, candidates);
+            for (int k = 0; k < NODES_PER_PLATFORM; k++) {
+                addEdges(i * NODES_PER_PLATFORM + k, candidates);
+            }
+        }
+    }, built);
+
+    std::vector<int> spawnCandidates;
+    platformsNear(spans[platformNodes].left, spans[platformNodes].right, spawnCandidates);
+    addEdges(platformNodes, spawnCandidates);
+    jobs.wait(built);
+
+    graph = flatten(adjacency);
+}
+
+static NodeGraph transpose(const NodeGraph& g) {
+    NodeGraph t;
+    t.offsets.assign(g.offsets.size(), 0);
+    for (int target : g.targets) t.offsets[target + 1]++;
+    for (size_t n = 1; n < t.offsets.size(); n++) t.offsets[n] += t.offsets[n - 1];
+
+    std::vector<size_t> cursor(t.offsets.begin(), t.offsets.end() - 1);
+    t.targets.resize(g.targets.size());
+    for (size_t n = 0; n < g.nodes(); n++) {
+        for (size_t e = g.offsets[n]; e < g.offsets[n + 1]; e++) {
+            t.targets[cursor[g.targets[e]]++] = (int)n;
+        }
+    }
+    return t;
+}
+
+// Level-synchronous breadth-first search. Each frontier is split across jobs; a node joins
+// the next frontier exactly once, claimed with an atomic exchange.
+static std::vector<char> search(const NodeGraph& g, int start, JobSystem& jobs) {
+    const size_t FRONTIER_GRAIN = 512;
+
+    size_t count = g.nodes();
+    std::unique_ptr<std::atomic<char>[]> visited(new std::atomic<char>[count]);
+    for (size_t n = 0; n < count; n++) visited[n].store(0, std::memory_order_relaxed);
+
+    std::vector<int> frontier(1, start), next;
+    std::mutex nextMutex;
+    visited[start].store(1);
+    while (!frontier.empty()) {
+        next.clear();
+        JobCounter done;
+        jobs.parallelFor(frontier.size(), FRONTIER_GRAIN, [&](size_t begin, size_t end) {
+            std::vector<int> found;
+            for (size_t i = begin; i < end; i++) {
+                int n = frontier[i];
+                for (size_t e = g.offsets[n]; e < g.offsets[n + 1]; e++) {
+                    int target = g.targets[e];
+                    if (!visited[target].load(std::memory_order_relaxed) &&
+                        !visited[target].exchange(1)) {
+                        found.push_back(target);
+                    }
+                }
+            }
+            std::lock_guard<std::mutex> lock(nextMutex);
+            next.insert(next.end(), found.begin(), found.end());
+        }, done);
+        jobs.wait(done);
+        frontier.swap(next);
+    }
+
+    std::vector<char> result(count);
+    for (size_t n = 0; n < count; n++) result[n] = visited[n].load(std::memory_order_relaxed);
+    return result;
+}
+
+// ─────────────────────────────────────────
+// Validation
+// ─────────────────────────────────────────
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+ReachabilityReport validateLevel(const std::vector<Platform>& platforms,
+                                 const std::vector<Collectible>& collectibles, JobSystem& jobs) {
+    const size_t COIN_GRAIN = 1024;
+    const float COIN_MARGIN = COIN_PICKUP_RADIUS;
+    const int NODES_PER_PLATFORM = ReachabilityGraph::NODES_PER_PLATFORM;
+
+    ReachabilityReport report;
+    auto buildStart = std::chrono::steady_clock::now();
+
+    ReachabilityGraph graph;
+    graph.build(platforms, jobs);
+    NodeGraph reverse = transpose(graph.edges());
+    report.nodes = graph.nodes();
+    report.edges = graph.edges().targets.size();
+    report.buildSeconds = secondsSince(buildStart);
+
+    auto searchStart = std::chrono::steady_clock::now();
+    int spawnNode = graph.spawnNode();
+    const NodeSpan& spawn = graph.span(spawnNode);
+    std::vector<char> reached = search(graph.edges(), spawnNode, jobs);
+
+    // "Back to spawn" means back onto the platform the player first lands on
+    std::vector<int> spawnCandidates;
+    graph.platformsNear(spawn.left, spawn.right, spawnCandidates);
+    int home = -1;
+    float homeTop = -1e30f;
+    for (int j : spawnCandidates) {
+        const NodeSpan& top = graph.span(j * NODES_PER_PLATFORM + ReachabilityGraph::NODE_TOP);
+        if (top.left <= spawn.left && top.right >= spawn.right && top.y <= spawn.y &&
+            top.y > homeTop) {
+            home = j * NODES_PER_PLATFORM + ReachabilityGraph::NODE_TOP;
+            homeTop = top.y;
+        }
+    }
+    std::vector<char> returns;
+    if (home >= 0) returns = search(reverse, home, jobs);
+
+    for (size_t i = 0; i < platforms.size(); i++) {
+        int top = i * NODES_PER_PLATFORM + ReachabilityGraph::NODE_TOP;
+        if (!reached[top]) {
+            report.unreachablePlatforms.push_back(i);
+        } else if (home >= 0 && !returns[top]) {
+            report.softLocks.push_back(i);
+        }
+    }
+
+    // A coin is collectible if any reached node can bring the player's centre within
+    // pickup range of it
+    std::vector<char> coinReached(collectibles.size(), 0);
+    JobCounter coinsChecked;
+    jobs.parallelFor(collectibles.size(), COIN_GRAIN, [&](size_t begin, size_t end) {
+        std::vector<int> candidates;
+        for (size_t c = begin; c < end; c++) {
+            const Collectible& coin = collectibles[c];
+            float left = coin.x - COIN_MARGIN, right = coin.x + COIN_MARGIN;
+            float y = coin.y - COIN_MARGIN;
+            if (graph.canReach(spawn, left, right, y)) {
+                coinReached[c] = 1;
+                continue;
+            }
+            graph.platformsNear(left, right, candidates);
+            for (size_t k = 0; k < candidates.size() * NODES_PER_PLATFORM && !coinReached[c]; k++) {
+                int node = candidates[k / NODES_PER_PLATFORM] * NODES_PER_PLATFORM +
+                           k % NODES_PER_PLATFORM;
+                if (reached[node] && graph.canReach(graph.span(node), left, right, y)) {
+                    coinReached[c] = 1;
+                }
+            }
+        }
+    }, coinsChecked);
+    jobs.wait(coinsChecked);
+
+    for (size_t c = 0; c < collectibles.size(); c++) {
+        if (!coinReached[c]) report.unreachableCoins.push_back(c);
+    }
+    report.searchSeconds = secondsSince(searchStart);
+    return report;
+}
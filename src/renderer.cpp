@@ -1,38 +1,87 @@
 #include "renderer.h"
+#include "arena.h"
+#include "backend.h"
 #include "graphics.h"
 #include "constants.h"
 #include <GL/glut.h>
+#include <algorithm>
 #include <cmath>
-#include <string>
-
-Renderer::Renderer() : gameTime(0) {}
+#include <cstring>
+
+Renderer::Renderer()
+    : gameTime(0),
+      assetsLoading(false),
+      reloadsSeen(0),
+      playerPalettes(),
+      instancing(true),
+      retainPlatforms(false),
+      platformChunksBuilt(false),
+      chunkReach(0),
+      tileStates() {}
+
+Renderer::~Renderer() {
+    releasePlatformChunks();
+}
 
-void Renderer::loadAssets() {
+// Generated sprites are drawn on the texture manager's loader threads, PNGs decoded there,
+// and pollAssets() uploads them as frames are drawn, so the menu is up before they are.
+// Sprites in the asset pack are uploaded on the spot.
+void Renderer::loadAssets(SpriteSource source) {
     TextureManager& tm = TextureManager::getInstance();
     printf("Loading sprite assets...\n");
-    tm.loadSprite("player", "assets/sprites/player.png", 4);
-    tm.loadSprite("coin", "assets/sprites/coin.png", 6);
-    tm.loadSprite("enemy", "assets/sprites/enemy.png", 2);
-    tm.loadSprite("tile_grass", "assets/sprites/tile_grass.png", 1);
-    tm.loadSprite("tile_stone", "assets/sprites/tile_stone.png", 1);
-    tm.loadSprite("tile_moving", "assets/sprites/tile_moving.png", 1);
-    tm.loadSprite("cloud", "assets/sprites/cloud.png", 1);
-    tm.loadSprite("particle", "assets/sprites/particle.png", 1);
-    printf("All assets loaded.\n");
+    assetsRequested = std::chrono::steady_clock::now();
+
+    // Player variants: the partner is greener, and both turn blue while wall sliding
+    PaletteSwap partner(0.6f, 1.0f, 0.6f), wallSlide(0.8f, 0.85f, 1.0f);
+    PaletteSwap partnerWallSlide(partner.r * wallSlide.r, partner.g * wallSlide.g,
+                                 partner.b * wallSlide.b);
+    playerPalettes[1] = tm.definePalette("player", "partner", partner);
+    playerPalettes[2] = tm.definePalette("player", "wall_slide", wallSlide);
+    playerPalettes[3] = tm.definePalette("player", "partner_wall_slide", partnerWallSlide);
+
+    if (source == SpriteSource::GENERATED) {
+        tm.loadGeneratedSprites();
+    } else {
+        if (source == SpriteSource::PACK) tm.openPack("assets/sprites.pha");
+        tm.loadSpriteAsync("player", "assets/sprites/player.png", 4);
+        tm.loadSpriteAsync("coin", "assets/sprites/coin.png", 6);
+        tm.loadSpriteAsync("enemy", "assets/sprites/enemy.png", 2);
+        tm.loadSpriteAsync("tile_grass", "assets/sprites/tile_grass.png", 1);
+        tm.loadSpriteAsync("tile_stone", "assets/sprites/tile_stone.png", 1);
+        tm.loadSpriteAsync("tile_moving", "assets/sprites/tile_moving.png", 1);
+        tm.loadSpriteAsync("cloud", "assets/sprites/cloud.png", 1);
+        tm.loadSpriteAsync("particle", "assets/sprites/particle.png", 1);
+    }
+    assetsLoading = true;
+    pollAssets();
+}
+
+void Renderer::pollAssets() {
+    TextureManager& tm = TextureManager::getInstance();
+    tm.nextFrame();
+    tm.checkWatched();
+    int pending = tm.uploadDecoded(SPRITE_UPLOADS_PER_FRAME);
+    if (tm.getHotReloadCount() != reloadsSeen) {
+        reloadsSeen = tm.getHotReloadCount();
+        printf("Sprites reloaded (%d so far).\n", reloadsSeen);
+    }
+    if (pending > 0 || !assetsLoading) return;
+    assetsLoading = false;
+    printf("All assets loaded in %.2f ms.\n",
+           std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() -
+                                                     assetsRequested)
+               .count());
 }
 
 // ─────────────────────────────────────────
 // Helper Methods
 // ─────────────────────────────────────────
 
-void Renderer::drawText(const std::string& text, float x, float y, void* font) {
-    glRasterPos2f(x, y);
-    for (char c : text) {
-        glutBitmapCharacter(font, c);
-    }
+void Renderer::drawText(const char* text, float x, float y, void* font) {
+    renderBackend().drawText(text, x, y, font);
 }
 
-void Renderer::drawTextCentered(const std::string& text, float y, void* font) {
+void Renderer::drawTextCentered(const char* text, float y, void* font) {
     int charWidth = 10;
     if (font == GLUT_BITMAP_HELVETICA_18)
         charWidth = 10;
@@ -41,7 +90,7 @@ void Renderer::drawTextCentered(const std::string& text, float y, void* font) {
     else if (font == GLUT_BITMAP_9_BY_15)
         charWidth = 9;
 
-    float x = (WINDOW_WIDTH - text.length() * charWidth) / 2.0f;
+    float x = (WINDOW_WIDTH - strlen(text) * charWidth) / 2.0f;
     drawText(text, x, y, font);
 }
 
@@ -52,7 +101,7 @@ void Renderer::drawHeart(float x, float y, float size, bool filled) {
     drawCircleMidpoint(x - r, y + r * 0.5f, r, heartColor, true);
     drawCircleMidpoint(x + r, y + r * 0.5f, r, heartColor, true);
 
-    std::vector<Point> triangle = {Point(x - size * 0.6f, y), Point(x + size * 0.6f, y),
+    FrameVector<Point> triangle = {Point(x - size * 0.6f, y), Point(x + size * 0.6f, y),
                                    Point(x, y - size * 0.7f)};
     scanLineFill(triangle, heartColor);
 }
@@ -68,21 +117,22 @@ void Renderer::drawCoinIcon(float x, float y, float size) {
 // ─────────────────────────────────────────
 
 void Renderer::drawBackground(float cameraX) {
+    RenderBackend& gfx = renderBackend();
     // Gradient sky
     for (int y = 0; y < WINDOW_HEIGHT; y += 3) {
         float t = (float)y / WINDOW_HEIGHT;
         float r = 0.35f + t * 0.3f;
         float g = 0.55f + t * 0.25f;
         float b = 0.75f + t * 0.15f;
-        glColor3f(r, g, b);
-        glBegin(GL_LINES);
-        glVertex2f(0, y);
-        glVertex2f(WINDOW_WIDTH, y);
-        glEnd();
+        gfx.color(r, g, b);
+        gfx.begin(Primitive::LINES);
+        gfx.vertex(0, y);
+        gfx.vertex(WINDOW_WIDTH, y);
+        gfx.end();
     }
 
     // Distant mountains (procedural — looks great at this scale)
-    std::vector<Point> mountain1 = {
+    FrameVector<Point> mountain1 = {
         Point(-200 - cameraX * 0.1f, 80),  Point(100 - cameraX * 0.1f, 280),
         Point(300 - cameraX * 0.1f, 220),  Point(500 - cameraX * 0.1f, 320),
         Point(700 - cameraX * 0.1f, 200),  Point(900 - cameraX * 0.1f, 350),
@@ -90,7 +140,7 @@ void Renderer::drawBackground(float cameraX) {
     scanLineFill(mountain1, Color(0.3f, 0.25f, 0.45f, 0.6f));
 
     // Closer hills
-    std::vector<Point> hills = {Point(-100 - cameraX * 0.2f, 60), Point(150 - cameraX * 0.2f, 180),
+    FrameVector<Point> hills = {Point(-100 - cameraX * 0.2f, 60), Point(150 - cameraX * 0.2f, 180),
                                 Point(350 - cameraX * 0.2f, 120), Point(550 - cameraX * 0.2f, 200),
                                 Point(800 - cameraX * 0.2f, 140), Point(1000 - cameraX * 0.2f, 190),
                                 Point(1200 - cameraX * 0.2f, 60)};
@@ -136,7 +186,7 @@ void Renderer::drawBackground(float cameraX) {
 // Player (sprite-based)
 // ─────────────────────────────────────────
 
-void Renderer::drawPlayer(const Player& player, float cameraX) {
+void Renderer::drawPlayer(const Player& player, float cameraX, bool partner) {
     TextureManager& tm = TextureManager::getInstance();
     float screenX = player.x - cameraX;
     float drawY = player.y;
@@ -160,57 +210,151 @@ void Renderer::drawPlayer(const Player& player, float cameraX) {
     // Wall slide visual: slightly tilted by adjusting position
     if (player.wallSliding) {
         frame = 3;  // Use jump frame for wall slide
-        // Tint slightly blue when wall sliding
-        tm.drawSprite("player", screenX, drawY, scaleX, scaleY, frame, flipX, 0.8f, 0.85f, 1.0f,
-                      1.0f);
-    } else {
-        tm.drawSprite("player", screenX, drawY, scaleX, scaleY, frame, flipX);
     }
+    // Partner and wall-slide tints are palette swaps (see loadAssets)
+    int palette = playerPalettes[(partner ? 1 : 0) | (player.wallSliding ? 2 : 0)];
+    tm.drawSprite("player", screenX, drawY, scaleX, scaleY, frame, flipX, 1.0f, 1.0f, 1.0f, 1.0f,
+                  palette);
 }
 
 // ─────────────────────────────────────────
 // Platforms (sprite-tiled)
 // ─────────────────────────────────────────
 
-void Renderer::drawPlatforms(const std::vector<Platform>& platforms, float cameraX) {
+// One platform at `x`: on screen, or in its chunk while that is being baked
+void Renderer::drawPlatform(const Platform& platform, float x) {
     TextureManager& tm = TextureManager::getInstance();
+    bool isGround = platform.height > 20;
+
+    // Choose tile based on platform type
+    std::string tileName;
+    if (isGround) {
+        tileName = "tile_grass";
+    } else if (platform.isMoving) {
+        tileName = "tile_moving";
+    } else {
+        tileName = "tile_stone";
+    }
+
+    // Draw the tile repeated across the platform
+    tm.drawTiled(tileName, x, platform.y, platform.width, platform.height);
+
+    // Subtle outline
+    Color edgeColor(0.1f, 0.1f, 0.1f, 0.4f);
+    drawLineDDA(x, platform.y, x + platform.width, platform.y, edgeColor);
+    drawLineDDA(x + platform.width, platform.y, x + platform.width,
+                platform.y + platform.height, edgeColor);
+    drawLineDDA(x + platform.width, platform.y + platform.height, x,
+                platform.y + platform.height, edgeColor);
+    drawLineDDA(x, platform.y + platform.height, x, platform.y, edgeColor);
+
+    // Moving platform glow
+    if (platform.isMoving) {
+        float glowAlpha = 0.2f + 0.15f * sin(gameTime * 3);
+        drawCircleMidpoint(x + platform.width / 2, platform.y + platform.height + 3, 4,
+                           Color(0.7f, 0.5f, 1.0f, glowAlpha), true);
+    }
+}
+
+// Sort static platforms into chunks by their left edge; nothing is baked yet
+void Renderer::buildPlatformChunks(const std::vector<Platform>& platforms) {
+    releasePlatformChunks();
+    platformChunks.clear();
+    movingPlatforms.clear();
+    chunkReach = 0;
+    for (size_t i = 0; i < platforms.size(); i++) {
+        const Platform& p = platforms[i];
+        if (p.isMoving) {
+            movingPlatforms.push_back((int)i);
+            continue;
+        }
+        int number = (int)floorf(p.x / PLATFORM_CHUNK_WIDTH);
+        auto found = platformChunks.find(number);
+        if (found == platformChunks.end()) {
+            found = platformChunks.insert(std::make_pair(number, PlatformChunk())).first;
+            found->second.left = p.x;
+            found->second.right = p.x + p.width;
+            found->second.geometry = 0;
+        }
+        PlatformChunk& chunk = found->second;
+        chunk.platforms.push_back((int)i);
+        chunk.left = std::min(chunk.left, p.x);
+        chunk.right = std::max(chunk.right, p.x + p.width);
+        chunkReach = std::max(chunkReach, chunk.right - number * PLATFORM_CHUNK_WIDTH);
+    }
+    platformChunksBuilt = true;
+}
+
+void Renderer::releasePlatformChunks() {
+    for (auto& pair : platformChunks) {
+        if (pair.second.geometry) renderBackend().deleteRetained(pair.second.geometry);
+        pair.second.geometry = 0;
+    }
+}
+
+void Renderer::setRetainedPlatforms(bool enabled) {
+    retainPlatforms = enabled;
+    platformsChanged();
+}
+
+void Renderer::platformsChanged() {
+    releasePlatformChunks();
+    platformChunks.clear();
+    movingPlatforms.clear();
+    platformChunksBuilt = false;
+}
 
-    for (const auto& platform : platforms) {
-        float screenX = platform.x - cameraX;
+void Renderer::drawPlatforms(const std::vector<Platform>& platforms, float cameraX) {
+    // Frustum culling, with room for the outlines
+    float left = cameraX - 50, right = cameraX + WINDOW_WIDTH + 50;
 
-        // Frustum culling
-        if (screenX + platform.width < -50 || screenX > WINDOW_WIDTH + 50) continue;
+    if (!retainPlatforms) {
+        for (const auto& platform : platforms) {
+            if (platform.x + platform.width < left || platform.x > right) continue;
+            drawPlatform(platform, platform.x - cameraX);
+        }
+        return;
+    }
 
-        bool isGround = platform.height > 20;
+    if (!platformChunksBuilt) buildPlatformChunks(platforms);
 
-        // Choose tile based on platform type
-        std::string tileName;
-        if (isGround) {
-            tileName = "tile_grass";
-        } else if (platform.isMoving) {
-            tileName = "tile_moving";
-        } else {
-            tileName = "tile_stone";
+    // Chunks hold on to the tile textures, so they count as drawn, and are baked again if
+    // a tile was reloaded, evicted or resized
+    TextureManager& tm = TextureManager::getInstance();
+    const char* const tiles[2] = {"tile_grass", "tile_stone"};
+    for (int t = 0; t < 2; t++) {
+        const Sprite* sprite = tm.touch(tiles[t]);
+        TileState state = TileState();
+        if (sprite) {
+            state = TileState{sprite->textureID, sprite->paletteID, sprite->width,
+                              sprite->height, sprite->paletteSize, sprite->paletteRows,
+                              sprite->topDown};
+        }
+        if (!(state == tileStates[t])) {
+            releasePlatformChunks();
+            tileStates[t] = state;
         }
+    }
 
-        // Draw the tile repeated across the platform
-        tm.drawTiled(tileName, screenX, platform.y, platform.width, platform.height);
-
-        // Subtle outline
-        Color edgeColor(0.1f, 0.1f, 0.1f, 0.4f);
-        drawLineDDA(screenX, platform.y, screenX + platform.width, platform.y, edgeColor);
-        drawLineDDA(screenX + platform.width, platform.y, screenX + platform.width,
-                    platform.y + platform.height, edgeColor);
-        drawLineDDA(screenX + platform.width, platform.y + platform.height, screenX,
-                    platform.y + platform.height, edgeColor);
-        drawLineDDA(screenX, platform.y + platform.height, screenX, platform.y, edgeColor);
-
-        // Moving platform glow
-        if (platform.isMoving) {
-            float glowAlpha = 0.2f + 0.15f * sin(gameTime * 3);
-            drawCircleMidpoint(screenX + platform.width / 2, platform.y + platform.height + 3, 4,
-                               Color(0.7f, 0.5f, 1.0f, glowAlpha), true);
+    RenderBackend& gfx = renderBackend();
+    int first = (int)floorf((left - chunkReach) / PLATFORM_CHUNK_WIDTH);
+    for (auto it = platformChunks.lower_bound(first);
+         it != platformChunks.end() && it->second.left <= right; ++it) {
+        PlatformChunk& chunk = it->second;
+        if (chunk.right < left) continue;
+        float origin = it->first * PLATFORM_CHUNK_WIDTH;
+        if (!chunk.geometry) {
+            gfx.beginRetained();
+            for (int i : chunk.platforms) drawPlatform(platforms[i], platforms[i].x - origin);
+            chunk.geometry = gfx.endRetained();
         }
+        gfx.drawRetained(chunk.geometry, origin - cameraX, 0);
+    }
+
+    for (int i : movingPlatforms) {
+        const Platform& platform = platforms[i];
+        if (platform.x + platform.width < left || platform.x > right) continue;
+        drawPlatform(platform, platform.x - cameraX);
     }
 }
 
@@ -218,25 +362,51 @@ void Renderer::drawPlatforms(const std::vector<Platform>& platforms, float camer
 // Collectibles (sprite-based)
 // ─────────────────────────────────────────
 
-void Renderer::drawCollectibles(const std::vector<Collectible>& collectibles, float cameraX) {
-    TextureManager& tm = TextureManager::getInstance();
+static uint8_t unorm(float value) {
+    return (uint8_t)(std::min(1.0f, std::max(0.0f, value)) * 255.0f + 0.5f);
+}
 
-    for (const auto& coin : collectibles) {
-        if (coin.collected) continue;
+static DrawInstance drawInstance(float x, float y, float scale, int frame, const Color& color) {
+    return DrawInstance{x, y, scale, (float)frame,
+                        {unorm(color.r), unorm(color.g), unorm(color.b), unorm(color.a)}};
+}
 
+void Renderer::drawCollectibles(const std::vector<SpriteInstance>& coins, float cameraX) {
+    TextureManager& tm = TextureManager::getInstance();
+    const Color glow(1.0f, 0.9f, 0.3f, 0.15f);
+
+    if (instancing) {
+        // Every glow, then every coin on top
+        instances.clear();
+        for (const auto& coin : coins) {
+            float screenX = coin.x - cameraX;
+            if (screenX > -50 && screenX < WINDOW_WIDTH + 50) {
+                instances.push_back(drawInstance(screenX, coin.y, 1.0f, 0, glow));
+            }
+        }
+        renderBackend().drawDiscs(14, instances.data(), instances.size());
+
+        instances.clear();
+        for (const auto& coin : coins) {
+            float screenX = coin.x - cameraX;
+            if (screenX > -50 && screenX < WINDOW_WIDTH + 50) {
+                instances.push_back(
+                    drawInstance(screenX, coin.y, coin.scale, coin.frame, Color()));
+            }
+        }
+        tm.drawSprites("coin", instances.data(), instances.size());
+        return;
+    }
+
+    for (const auto& coin : coins) {
         float screenX = coin.x - cameraX;
-        float drawY = coin.y + sin(coin.bobOffset) * 5;
 
         if (screenX > -50 && screenX < WINDOW_WIDTH + 50) {
-            // Animated coin sprite
-            int frame = ((int)(coin.rotation * 3)) % 6;
-            float pulse = 1.0f + 0.08f * sin(coin.rotation * 2);
-
             // Outer glow (procedural)
-            drawCircleMidpoint(screenX, drawY, 14, Color(1.0f, 0.9f, 0.3f, 0.15f), true);
+            drawCircleMidpoint(screenX, coin.y, 14, glow, true);
 
             // Coin sprite
-            tm.drawSprite("coin", screenX, drawY, 2.0f * pulse, 2.0f * pulse, frame);
+            tm.drawSprite("coin", screenX, coin.y, coin.scale, coin.scale, coin.frame);
         }
     }
 }
@@ -245,23 +415,15 @@ void Renderer::drawCollectibles(const std::vector<Collectible>& collectibles, fl
 // Enemies (sprite-based)
 // ─────────────────────────────────────────
 
-void Renderer::drawEnemies(const std::vector<Enemy>& enemies, float cameraX) {
+void Renderer::drawEnemies(const std::vector<SpriteInstance>& enemies, float cameraX) {
     TextureManager& tm = TextureManager::getInstance();
 
     for (const auto& enemy : enemies) {
-        if (!enemy.alive) continue;
-
         float screenX = enemy.x - cameraX;
         if (screenX < -50 || screenX > WINDOW_WIDTH + 50) continue;
 
-        float bounce = fabs(sin(enemy.animationTimer * 0.3f)) * 3;
-        float drawY = enemy.y + bounce;
-
-        // Animated enemy sprite
-        int frame = ((int)(enemy.animationTimer * 0.3f)) % 2;
-        bool flipX = !enemy.facingRight;
-
-        tm.drawSprite("enemy", screenX, drawY, 1.5f, 1.5f, frame, flipX);
+        tm.drawSprite("enemy", screenX, enemy.y, enemy.scale, enemy.scale, enemy.frame,
+                      enemy.flipX);
     }
 }
 
@@ -272,6 +434,21 @@ void Renderer::drawEnemies(const std::vector<Enemy>& enemies, float cameraX) {
 void Renderer::drawParticles(const std::vector<Particle>& particles, float cameraX) {
     TextureManager& tm = TextureManager::getInstance();
 
+    if (instancing) {
+        instances.clear();
+        for (const auto& particle : particles) {
+            if (particle.isDead()) continue;
+
+            float screenX = particle.x - cameraX;
+            if (screenX > -10 && screenX < WINDOW_WIDTH + 10) {
+                float size = 0.5f + particle.color.a * 0.8f;
+                instances.push_back(drawInstance(screenX, particle.y, size, 0, particle.color));
+            }
+        }
+        tm.drawSprites("particle", instances.data(), instances.size());
+        return;
+    }
+
     for (const auto& particle : particles) {
         if (particle.isDead()) continue;
 
@@ -289,14 +466,15 @@ void Renderer::drawParticles(const std::vector<Particle>& particles, float camer
 // ─────────────────────────────────────────
 
 void Renderer::drawHUD(int score, int lives, float timer, const Player& player) {
+    RenderBackend& gfx = renderBackend();
     // Semi-transparent HUD background bar
-    glColor4f(0.0f, 0.0f, 0.0f, 0.35f);
-    glBegin(GL_QUADS);
-    glVertex2f(0, WINDOW_HEIGHT - 45);
-    glVertex2f(WINDOW_WIDTH, WINDOW_HEIGHT - 45);
-    glVertex2f(WINDOW_WIDTH, WINDOW_HEIGHT);
-    glVertex2f(0, WINDOW_HEIGHT);
-    glEnd();
+    gfx.color(0.0f, 0.0f, 0.0f, 0.35f);
+    gfx.begin(Primitive::QUADS);
+    gfx.vertex(0, WINDOW_HEIGHT - 45);
+    gfx.vertex(WINDOW_WIDTH, WINDOW_HEIGHT - 45);
+    gfx.vertex(WINDOW_WIDTH, WINDOW_HEIGHT);
+    gfx.vertex(0, WINDOW_HEIGHT);
+    gfx.end();
 
     // Lives (hearts)
     for (int i = 0; i < 3; i++) {
@@ -305,21 +483,20 @@ void Renderer::drawHUD(int score, int lives, float timer, const Player& player)
 
     // Coin icon + score
     drawCoinIcon(130, WINDOW_HEIGHT - 22, 8);
-    glColor3f(1.0f, 1.0f, 1.0f);
-    drawText(std::to_string(score), 145, WINDOW_HEIGHT - 27, GLUT_BITMAP_HELVETICA_18);
+    gfx.color(1.0f, 1.0f, 1.0f);
+    drawText(frameArena.format("%d", score), 145, WINDOW_HEIGHT - 27, GLUT_BITMAP_HELVETICA_18);
 
     // Timer
     int minutes = (int)timer / 60;
     int seconds = (int)timer % 60;
-    char timerBuf[32];
-    snprintf(timerBuf, sizeof(timerBuf), "%d:%02d", minutes, seconds);
-    glColor3f(0.9f, 0.9f, 0.9f);
-    drawText(timerBuf, WINDOW_WIDTH - 80, WINDOW_HEIGHT - 27, GLUT_BITMAP_HELVETICA_18);
+    gfx.color(0.9f, 0.9f, 0.9f);
+    drawText(frameArena.format("%d:%02d", minutes, seconds), WINDOW_WIDTH - 80,
+             WINDOW_HEIGHT - 27, GLUT_BITMAP_HELVETICA_18);
 
     // Jump counter
-    glColor3f(0.7f, 0.8f, 1.0f);
-    std::string jumpInfo = "Jumps: " + std::to_string(player.maxJumps - player.jumpCount) + "/" +
-                           std::to_string(player.maxJumps);
+    gfx.color(0.7f, 0.8f, 1.0f);
+    const char* jumpInfo =
+        frameArena.format("Jumps: %d/%d", player.maxJumps - player.jumpCount, player.maxJumps);
     drawText(jumpInfo, WINDOW_WIDTH / 2 - 30, WINDOW_HEIGHT - 27, GLUT_BITMAP_HELVETICA_12);
 }
 
@@ -328,14 +505,15 @@ void Renderer::drawHUD(int score, int lives, float timer, const Player& player)
 // ─────────────────────────────────────────
 
 void Renderer::drawMenuScreen() {
+    RenderBackend& gfx = renderBackend();
     // Gradient background
     for (int y = 0; y < WINDOW_HEIGHT; y += 2) {
         float t = (float)y / WINDOW_HEIGHT;
-        glColor3f(0.08f + t * 0.1f, 0.05f + t * 0.15f, 0.15f + t * 0.2f);
-        glBegin(GL_LINES);
-        glVertex2f(0, y);
-        glVertex2f(WINDOW_WIDTH, y);
-        glEnd();
+        gfx.color(0.08f + t * 0.1f, 0.05f + t * 0.15f, 0.15f + t * 0.2f);
+        gfx.begin(Primitive::LINES);
+        gfx.vertex(0, y);
+        gfx.vertex(WINDOW_WIDTH, y);
+        gfx.end();
     }
 
     // Animated stars
@@ -344,17 +522,17 @@ void Renderer::drawMenuScreen() {
         sx = fmod(sx, (float)WINDOW_WIDTH);
         float sy = (i * 83) % WINDOW_HEIGHT;
         float twinkle = 0.3f + 0.7f * fabs(sin(gameTime * 2 + i * 0.8f));
-        glColor4f(1.0f, 1.0f, 1.0f, twinkle);
-        glPointSize(1.0f + twinkle);
-        glBegin(GL_POINTS);
-        glVertex2f(sx, sy);
-        glEnd();
+        gfx.color(1.0f, 1.0f, 1.0f, twinkle);
+        gfx.pointSize(1.0f + twinkle);
+        gfx.begin(Primitive::POINTS);
+        gfx.vertex(sx, sy);
+        gfx.end();
     }
-    glPointSize(1.0f);
+    gfx.pointSize(1.0f);
 
     // Title
     float titleBob = sin(gameTime * 1.5f) * 8;
-    glColor3f(1.0f, 0.85f, 0.3f);
+    gfx.color(1.0f, 0.85f, 0.3f);
     drawTextCentered("P I X E L   H E R O", WINDOW_HEIGHT / 2 + 80 + titleBob,
                      GLUT_BITMAP_HELVETICA_18);
 
@@ -365,18 +543,18 @@ void Renderer::drawMenuScreen() {
                   previewFrame);
 
     // Subtitle
-    glColor4f(0.8f, 0.8f, 0.9f, 0.8f);
+    gfx.color(0.8f, 0.8f, 0.9f, 0.8f);
     drawTextCentered("A Classic Platformer Adventure", WINDOW_HEIGHT / 2 + 40,
                      GLUT_BITMAP_HELVETICA_12);
 
     // Blinking "Press ENTER" text
     float blinkAlpha = 0.5f + 0.5f * sin(gameTime * 3);
-    glColor4f(1.0f, 1.0f, 1.0f, blinkAlpha);
+    gfx.color(1.0f, 1.0f, 1.0f, blinkAlpha);
     drawTextCentered("Press ENTER or SPACE to Start", WINDOW_HEIGHT / 2 - 30,
                      GLUT_BITMAP_HELVETICA_18);
 
     // Controls
-    glColor4f(0.6f, 0.65f, 0.7f, 0.7f);
+    gfx.color(0.6f, 0.65f, 0.7f, 0.7f);
     drawTextCentered("A/D or Arrow Keys  -  Move", WINDOW_HEIGHT / 2 - 100,
                      GLUT_BITMAP_HELVETICA_12);
     drawTextCentered("W / Space / Up  -  Jump (Double Jump!)", WINDOW_HEIGHT / 2 - 120,
@@ -398,18 +576,19 @@ void Renderer::drawMenuScreen() {
 // ─────────────────────────────────────────
 
 void Renderer::drawPauseOverlay() {
-    glColor4f(0.0f, 0.0f, 0.0f, 0.6f);
-    glBegin(GL_QUADS);
-    glVertex2f(0, 0);
-    glVertex2f(WINDOW_WIDTH, 0);
-    glVertex2f(WINDOW_WIDTH, WINDOW_HEIGHT);
-    glVertex2f(0, WINDOW_HEIGHT);
-    glEnd();
-
-    glColor3f(1.0f, 1.0f, 1.0f);
+    RenderBackend& gfx = renderBackend();
+    gfx.color(0.0f, 0.0f, 0.0f, 0.6f);
+    gfx.begin(Primitive::QUADS);
+    gfx.vertex(0, 0);
+    gfx.vertex(WINDOW_WIDTH, 0);
+    gfx.vertex(WINDOW_WIDTH, WINDOW_HEIGHT);
+    gfx.vertex(0, WINDOW_HEIGHT);
+    gfx.end();
+
+    gfx.color(1.0f, 1.0f, 1.0f);
     drawTextCentered("P A U S E D", WINDOW_HEIGHT / 2 + 30, GLUT_BITMAP_HELVETICA_18);
 
-    glColor4f(0.8f, 0.8f, 0.8f, 0.8f);
+    gfx.color(0.8f, 0.8f, 0.8f, 0.8f);
     drawTextCentered("Press P or ESC to Resume", WINDOW_HEIGHT / 2 - 20, GLUT_BITMAP_HELVETICA_12);
     drawTextCentered("Press Q to Quit to Menu", WINDOW_HEIGHT / 2 - 45, GLUT_BITMAP_HELVETICA_12);
 }
@@ -419,33 +598,33 @@ void Renderer::drawPauseOverlay() {
 // ─────────────────────────────────────────
 
 void Renderer::drawGameOverScreen(int score, float timer) {
-    glColor4f(0.3f, 0.0f, 0.0f, 0.7f);
-    glBegin(GL_QUADS);
-    glVertex2f(0, 0);
-    glVertex2f(WINDOW_WIDTH, 0);
-    glVertex2f(WINDOW_WIDTH, WINDOW_HEIGHT);
-    glVertex2f(0, WINDOW_HEIGHT);
-    glEnd();
+    RenderBackend& gfx = renderBackend();
+    gfx.color(0.3f, 0.0f, 0.0f, 0.7f);
+    gfx.begin(Primitive::QUADS);
+    gfx.vertex(0, 0);
+    gfx.vertex(WINDOW_WIDTH, 0);
+    gfx.vertex(WINDOW_WIDTH, WINDOW_HEIGHT);
+    gfx.vertex(0, WINDOW_HEIGHT);
+    gfx.end();
 
     float shake = sin(gameTime * 20) * 2;
-    glColor3f(1.0f, 0.2f, 0.2f);
+    gfx.color(1.0f, 0.2f, 0.2f);
     drawTextCentered("G A M E   O V E R", WINDOW_HEIGHT / 2 + 60 + shake, GLUT_BITMAP_HELVETICA_18);
 
-    glColor3f(1.0f, 1.0f, 1.0f);
-    drawTextCentered("Score: " + std::to_string(score), WINDOW_HEIGHT / 2 + 10,
+    gfx.color(1.0f, 1.0f, 1.0f);
+    drawTextCentered(frameArena.format("Score: %d", score), WINDOW_HEIGHT / 2 + 10,
                      GLUT_BITMAP_HELVETICA_18);
 
     int minutes = (int)timer / 60;
     int seconds = (int)timer % 60;
-    char timerBuf[32];
-    snprintf(timerBuf, sizeof(timerBuf), "Time: %d:%02d", minutes, seconds);
-    drawTextCentered(std::string(timerBuf), WINDOW_HEIGHT / 2 - 20, GLUT_BITMAP_HELVETICA_12);
+    drawTextCentered(frameArena.format("Time: %d:%02d", minutes, seconds), WINDOW_HEIGHT / 2 - 20,
+                     GLUT_BITMAP_HELVETICA_12);
 
     float blinkAlpha = 0.5f + 0.5f * sin(gameTime * 3);
-    glColor4f(1.0f, 1.0f, 1.0f, blinkAlpha);
+    gfx.color(1.0f, 1.0f, 1.0f, blinkAlpha);
     drawTextCentered("Press R to Restart", WINDOW_HEIGHT / 2 - 70, GLUT_BITMAP_HELVETICA_18);
 
-    glColor4f(0.7f, 0.7f, 0.7f, 0.6f);
+    gfx.color(0.7f, 0.7f, 0.7f, 0.6f);
     drawTextCentered("Press Q or ESC for Menu", WINDOW_HEIGHT / 2 - 100, GLUT_BITMAP_HELVETICA_12);
 }
 
@@ -454,13 +633,14 @@ void Renderer::drawGameOverScreen(int score, float timer) {
 // ─────────────────────────────────────────
 
 void Renderer::drawWinScreen(int score, float timer) {
-    glColor4f(0.2f, 0.15f, 0.0f, 0.6f);
-    glBegin(GL_QUADS);
-    glVertex2f(0, 0);
-    glVertex2f(WINDOW_WIDTH, 0);
-    glVertex2f(WINDOW_WIDTH, WINDOW_HEIGHT);
-    glVertex2f(0, WINDOW_HEIGHT);
-    glEnd();
+    RenderBackend& gfx = renderBackend();
+    gfx.color(0.2f, 0.15f, 0.0f, 0.6f);
+    gfx.begin(Primitive::QUADS);
+    gfx.vertex(0, 0);
+    gfx.vertex(WINDOW_WIDTH, 0);
+    gfx.vertex(WINDOW_WIDTH, WINDOW_HEIGHT);
+    gfx.vertex(0, WINDOW_HEIGHT);
+    gfx.end();
 
     // Celebration particles
     TextureManager& tm = TextureManager::getInstance();
@@ -473,25 +653,24 @@ void Renderer::drawWinScreen(int score, float timer) {
     }
 
     float bob = sin(gameTime * 2) * 5;
-    glColor3f(1.0f, 0.9f, 0.2f);
+    gfx.color(1.0f, 0.9f, 0.2f);
     drawTextCentered("Y O U   W I N !", WINDOW_HEIGHT / 2 + 80 + bob, GLUT_BITMAP_HELVETICA_18);
 
-    glColor3f(1.0f, 1.0f, 1.0f);
+    gfx.color(1.0f, 1.0f, 1.0f);
     drawTextCentered("All coins collected!", WINDOW_HEIGHT / 2 + 40, GLUT_BITMAP_HELVETICA_12);
-    drawTextCentered("Final Score: " + std::to_string(score), WINDOW_HEIGHT / 2,
+    drawTextCentered(frameArena.format("Final Score: %d", score), WINDOW_HEIGHT / 2,
                      GLUT_BITMAP_HELVETICA_18);
 
     int minutes = (int)timer / 60;
     int seconds = (int)timer % 60;
-    char timerBuf[32];
-    snprintf(timerBuf, sizeof(timerBuf), "Time: %d:%02d", minutes, seconds);
-    drawTextCentered(std::string(timerBuf), WINDOW_HEIGHT / 2 - 30, GLUT_BITMAP_HELVETICA_12);
+    drawTextCentered(frameArena.format("Time: %d:%02d", minutes, seconds), WINDOW_HEIGHT / 2 - 30,
+                     GLUT_BITMAP_HELVETICA_12);
 
     float blinkAlpha = 0.5f + 0.5f * sin(gameTime * 3);
-    glColor4f(1.0f, 1.0f, 1.0f, blinkAlpha);
+    gfx.color(1.0f, 1.0f, 1.0f, blinkAlpha);
     drawTextCentered("Press R to Play Again", WINDOW_HEIGHT / 2 - 80, GLUT_BITMAP_HELVETICA_18);
 
-    glColor4f(0.7f, 0.7f, 0.7f, 0.6f);
+    gfx.color(0.7f, 0.7f, 0.7f, 0.6f);
     drawTextCentered("Press Q or ESC for Menu", WINDOW_HEIGHT / 2 - 110, GLUT_BITMAP_HELVETICA_12);
 }
 
@@ -500,12 +679,13 @@ void Renderer::drawWinScreen(int score, float timer) {
 // ─────────────────────────────────────────
 
 void Renderer::drawScreenFlash(float r, float g, float b, float alpha) {
+    RenderBackend& gfx = renderBackend();
     if (alpha <= 0) return;
-    glColor4f(r, g, b, alpha);
-    glBegin(GL_QUADS);
-    glVertex2f(0, 0);
-    glVertex2f(WINDOW_WIDTH, 0);
-    glVertex2f(WINDOW_WIDTH, WINDOW_HEIGHT);
-    glVertex2f(0, WINDOW_HEIGHT);
-    glEnd();
+    gfx.color(r, g, b, alpha);
+    gfx.begin(Primitive::QUADS);
+    gfx.vertex(0, 0);
+    gfx.vertex(WINDOW_WIDTH, 0);
+    gfx.vertex(WINDOW_WIDTH, WINDOW_HEIGHT);
+    gfx.vertex(0, WINDOW_HEIGHT);
+    gfx.end();
 }
\ No newline at end of file
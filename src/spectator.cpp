@@ -0,0 +1,819 @@
+#include "spectator.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Stream layout: a sequence of messages, each a LEB128 byte length and a payload.
+//
+// The first message is the hello, little-endian:
+//   u8 magic, u8 version, u8 level source, u8 streamed, u16 tick rate
+//   GENERATED: u32 seed, u32 platform count, f32 coin, enemy, moving and bonus chance
+//   FILE:      u16 path length, path bytes
+//
+// Every later message is a frame, a bit stream written LSB first:
+//   reset:1 [key:1]   level back at spawn state before this frame; key: velocities follow
+//   tick              delta
+//   camera            x error [key: vx]
+//   hud:1             [state:3 twoPlayer:1 score lives deltas]  (no flag in keyframes)
+//   seconds           delta
+//   per player        changed:1 [x, y errors [key: vx, vy] squash delta, poseChanged:1
+//                     [pose:7]]  (no changed flag in keyframes)
+//   events            count, then coin:1 undo:1 record (delta from the previous event's)
+//   enemies           count, then record gap, x error [key: vx], facingRight:1
+// Counts and gaps are Elias gamma codes of n + 1; signed values are zigzag mapped first.
+// An error is the difference from the guess x + vx; after it, vx becomes the change of x.
+static const uint8_t HELLO_MAGIC = 0xB8;
+static const uint8_t STREAM_VERSION = 1;
+static const size_t HELLO_SIZE = 6;
+static const float POSITION_SCALE = 8.0f;    // 1/8 px
+static const float SQUASH_SCALE = 64.0f;
+static const size_t MAX_MESSAGE = 64 << 20;  // A keyframe can list every change in a level
+static const size_t MAX_OUTBOX = 1 << 20;    // Per viewer, before it is dropped as too slow
+static const size_t REWRITE_WINDOW = 64;     // Changes a rollback can rewrite at the log's end
+
+// ─────────────────────────────────────────
+// Bit packing
+// ─────────────────────────────────────────
+
+class BitWriter {
+   private:
+    std::vector<uint8_t>& out;
+    uint64_t pending;
+    int count;
+
+   public:
+    explicit BitWriter(std::vector<uint8_t>& o) : out(o), pending(0), count(0) {}
+
+    void bits(uint32_t value, int n) {  // n <= 32
+        pending |= (uint64_t)value << count;
+        count += n;
+        while (count >= 8) {
+            out.push_back((uint8_t)pending);
+            pending >>= 8;
+            count -= 8;
+        }
+    }
+    void flag(bool value) { bits(value, 1); }
+    // n zeros, a one, then the n low bits of value + 1 (which has n + 1 bits)
+    void gamma(uint32_t value) {
+        uint64_t v = (uint64_t)value + 1;
+        int n = 63 - __builtin_clzll(v);
+        bits(0, n);
+        bits(1, 1);
+        bits((uint32_t)(v & ((1ull << n) - 1)), n);
+    }
+    void signedValue(int32_t value) {
+        gamma(((uint32_t)value << 1) ^ (uint32_t)(value >> 31));
+    }
+    void finish() {
+        if (count > 0) out.push_back((uint8_t)pending);
+        pending = 0;
+        count = 0;
+    }
+};
+
+class BitReader {
+   private:
+    const uint8_t* data;
+    size_t size;      // Bits
+    size_t position;  // Bits
+
+   public:
+    bool failed;  // Read past the end or found a code too long to be valid
+
+    BitReader(const uint8_t* d, size_t bytes)
+        : data(d), size(bytes * 8), position(0), failed(false) {}
+
+    uint32_t bits(int n) {
+        uint32_t value = 0;
+        for (int i = 0; i < n; i++, position++) {
+            if (position >= size) {
+                failed = true;
+                return 0;
+            }
+            value |= (uint32_t)((data[position >> 3] >> (position & 7)) & 1) << i;
+        }
+        return value;
+    }
+    bool flag() { return bits(1) != 0; }
+    uint32_t gamma() {
+        int n = 0;
+        while (!bits(1)) {
+            if (failed || ++n > 32) {
+                failed = true;
+                return 0;
+            }
+        }
+        return (uint32_t)(((1ull << n) | bits(n)) - 1);
+    }
+    int32_t signedValue() {
+        uint32_t z = gamma();
+        return (int32_t)(z >> 1) ^ -(int32_t)(z & 1);
+    }
+};
+
+static void put16(std::vector<uint8_t>& out, uint16_t v) {
+    out.push_back(v);
+    out.push_back(v >> 8);
+}
+
+static void put32(std::vector<uint8_t>& out, uint32_t v) {
+    for (int i = 0; i < 4; i++) out.push_back(v >> (8 * i));
+}
+
+static uint16_t get16(const uint8_t* p) {
+    return p[0] | (p[1] << 8);
+}
+
+static uint32_t get32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint32_t floatBits(float f) {
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+static float bitsFloat(uint32_t u) {
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+static void appendMessage(std::vector<uint8_t>& out, const std::vector<uint8_t>& payload) {
+    size_t n = payload.size();
+    do {
+        out.push_back((n & 0x7F) | (n > 0x7F ? 0x80 : 0));
+        n >>= 7;
+    } while (n > 0);
+    out.insert(out.end(), payload.begin(), payload.end());
+}
+
+static int32_t toFixed(float v, float scale) {
+    return (int32_t)lrintf(v * scale);
+}
+
+// ─────────────────────────────────────────
+// Shared frame pieces
+// ─────────────────────────────────────────
+
+static void resetEnemies(const std::vector<Enemy>& enemies, std::vector<SpectatorEnemy>& out) {
+    out.resize(enemies.size());
+    for (size_t i = 0; i < enemies.size(); i++) {
+        out[i].x = toFixed(enemies[i].spawnX, POSITION_SCALE);
+        out[i].vx = 0;
+        out[i].facingRight = true;
+    }
+}
+
+static void writePlayer(BitWriter& w, const SpectatorPlayer& from, const SpectatorPlayer& to,
+                        bool key) {
+    int32_t errorX = to.x - from.x - from.vx, errorY = to.y - from.y - from.vy;
+    if (!key) {
+        bool changed = errorX || errorY || to.squash != from.squash || to.pose != from.pose;
+        w.flag(changed);
+        if (!changed) return;
+    }
+    w.signedValue(errorX);
+    w.signedValue(errorY);
+    if (key) {
+        w.signedValue(to.vx);
+        w.signedValue(to.vy);
+    }
+    w.signedValue(to.squash - from.squash);
+    w.flag(to.pose != from.pose);
+    if (to.pose != from.pose) w.bits(to.pose, 7);
+}
+
+static void readPlayer(BitReader& r, SpectatorPlayer& p, bool key) {
+    if (!key && !r.flag()) {
+        p.x += p.vx;
+        p.y += p.vy;
+        return;
+    }
+    int32_t x = p.x + p.vx + r.signedValue(), y = p.y + p.vy + r.signedValue();
+    if (key) {
+        p.vx = r.signedValue();
+        p.vy = r.signedValue();
+    } else {
+        p.vx = x - p.x;
+        p.vy = y - p.y;
+    }
+    p.x = x;
+    p.y = y;
+    p.squash += r.signedValue();
+    if (r.flag()) p.pose = r.bits(7);
+}
+
+// For frames `to` carries velocities already (the change from `from`)
+static void writeView(BitWriter& w, const SpectatorView& from, const SpectatorView& to, bool key) {
+    w.signedValue(to.tick - from.tick);
+    w.signedValue(to.cameraX - from.cameraX - from.cameraVx);
+    if (key) w.signedValue(to.cameraVx);
+
+    bool hud = key || to.state != from.state || to.twoPlayer != from.twoPlayer ||
+               to.score != from.score || to.lives != from.lives;
+    if (!key) w.flag(hud);
+    if (hud) {
+        w.bits((uint32_t)to.state, 3);
+        w.flag(to.twoPlayer);
+        w.signedValue(to.score - from.score);
+        w.signedValue(to.lives - from.lives);
+    }
+    w.signedValue(to.seconds - from.seconds);
+
+    // Keyframes carry the partner even when it is not playing, as frames keep it around
+    for (int slot = 0; slot < (key || to.twoPlayer ? 2 : 1); slot++) {
+        writePlayer(w, from.players[slot], to.players[slot], key);
+    }
+}
+
+static void readView(BitReader& r, SpectatorView& v, bool key) {
+    v.tick += r.signedValue();
+    int32_t cameraX = v.cameraX + v.cameraVx + r.signedValue();
+    v.cameraVx = key ? r.signedValue() : cameraX - v.cameraX;
+    v.cameraX = cameraX;
+
+    if (key || r.flag()) {
+        v.state = (GameState)std::min<uint32_t>(r.bits(3), (uint32_t)GameState::WIN);
+        v.twoPlayer = r.flag();
+        v.score += r.signedValue();
+        v.lives += r.signedValue();
+    }
+    v.seconds += r.signedValue();
+
+    for (int slot = 0; slot < (key || v.twoPlayer ? 2 : 1); slot++) {
+        readPlayer(r, v.players[slot], key);
+    }
+}
+
+static void writeEvent(BitWriter& w, const LevelChange& change, bool undo, int& previous) {
+    w.flag(change.coin);
+    w.flag(undo);
+    w.signedValue(change.record - previous);
+    previous = change.record;
+}
+
+static void writeEnemy(BitWriter& w, int gap, const SpectatorEnemy& from,
+                       const SpectatorEnemy& to, bool key) {
+    w.gamma(gap);
+    w.signedValue(to.x - from.x - from.vx);
+    if (key) w.signedValue(to.vx);
+    w.flag(to.facingRight);
+}
+
+// ─────────────────────────────────────────
+// Encoder
+// ─────────────────────────────────────────
+
+SpectatorEncoder::SpectatorEncoder() : sent(), levelSerial(-1), streamed(false) {}
+
+static SpectatorPlayer capturePlayer(const Player& p, const SpectatorPlayer& previous) {
+    SpectatorPlayer s;
+    s.x = toFixed(p.x, POSITION_SCALE);
+    s.y = toFixed(p.y, POSITION_SCALE);
+    s.vx = s.x - previous.x;
+    s.vy = s.y - previous.y;
+    s.squash = toFixed(p.squashScale, SQUASH_SCALE);
+    s.pose = (p.onGround ? POSE_ON_GROUND : 0) | (p.wallSliding ? POSE_WALL_SLIDING : 0) |
+             (p.facingRight ? POSE_FACING_RIGHT : 0) | (fabs(p.vx) > 1.0f ? POSE_RUNNING : 0) |
+             ((int)(p.animationTimer * 0.5f) % 2 ? POSE_RUN_FRAME : 0) |
+             (std::min(std::max(p.jumpCount, 0), 3) << POSE_JUMP_SHIFT);
+    return s;
+}
+
+void SpectatorEncoder::encodeHello(Game& game, std::vector<uint8_t>& out) const {
+    std::vector<uint8_t> hello;
+    hello.push_back(HELLO_MAGIC);
+    hello.push_back(STREAM_VERSION);
+    hello.push_back((uint8_t)game.getLevelSource());
+    hello.push_back(game.getStreamer().isStreaming());
+    put16(hello, game.getTickRate());
+    if (game.getLevelSource() == LevelSource::GENERATED) {
+        const LevelGenParams& p = game.getLevelParams();
+        put32(hello, p.seed);
+        put32(hello, p.platformCount);
+        put32(hello, floatBits(p.coinChance));
+        put32(hello, floatBits(p.enemyChance));
+        put32(hello, floatBits(p.movingChance));
+        put32(hello, floatBits(p.bonusChance));
+    } else if (game.getLevelSource() == LevelSource::FILE) {
+        // Absolute, so viewers started elsewhere find the same file
+        std::string path = game.getLevelPath();
+        if (char* full = realpath(path.c_str(), nullptr)) {
+            path = full;
+            free(full);
+        }
+        put16(hello, path.size());
+        hello.insert(hello.end(), path.begin(), path.end());
+    }
+    appendMessage(out, hello);
+}
+
+void SpectatorEncoder::encodeFrame(Game& game, std::vector<uint8_t>& out) {
+    payload.clear();
+    BitWriter w(payload);
+
+    bool reset = game.getLevelSerial() != levelSerial;
+    w.flag(reset);
+    if (reset) {
+        w.flag(false);  // Not a keyframe
+        levelSerial = game.getLevelSerial();
+        streamed = game.getStreamer().isStreaming();
+        static const std::vector<Enemy> none;
+        const std::vector<Enemy>& enemies = streamed ? none : game.getEnemies();
+        enemyIndex.build(enemies);
+        resetEnemies(enemies, sentEnemies);
+        sent = SpectatorView();
+        sentChanges.clear();
+    }
+
+    SpectatorView now = sent;
+    now.tick = game.getTick();
+    now.cameraX = toFixed(game.getCameraX(), POSITION_SCALE);
+    now.cameraVx = now.cameraX - sent.cameraX;
+    now.twoPlayer = game.isTwoPlayer();
+    now.state = game.getState();
+    now.score = game.getScore();
+    now.lives = game.getLives();
+    now.seconds = (int)game.getGameTime();
+    now.players[0] = capturePlayer(game.getPlayer(), sent.players[0]);
+    if (now.twoPlayer) now.players[1] = capturePlayer(game.getPartner(), sent.players[1]);
+    writeView(w, sent, now, false);
+    sent = now;
+
+    // Coins and enemies changed since the last frame. A rollback may have taken back and
+    // replaced the newest changes, so undo what no longer matches before adding the rest.
+    const std::vector<LevelChange>& log = game.getChanges();
+    size_t common = streamed ? 0 : std::min(sentChanges.size(), log.size());
+    for (size_t i = common > REWRITE_WINDOW ? common - REWRITE_WINDOW : 0; i < common; i++) {
+        if (sentChanges[i].coin != log[i].coin || sentChanges[i].record != log[i].record) {
+            common = i;
+            break;
+        }
+    }
+    size_t added = streamed ? 0 : log.size() - common;
+    w.gamma(sentChanges.size() - common + added);
+    int previous = 0;
+    for (size_t i = sentChanges.size(); i-- > common;) {
+        writeEvent(w, sentChanges[i], true, previous);
+    }
+    sentChanges.resize(common);
+    for (size_t i = common; i < common + added; i++) {
+        writeEvent(w, log[i], false, previous);
+        sentChanges.push_back(log[i]);
+    }
+
+    // Enemies in view that moved or turned
+    enemyUpdates.clear();
+    if (!streamed) {
+        const std::vector<Enemy>& enemies = game.getEnemies();
+        float left = game.getCameraX() - ACTIVITY_MARGIN;
+        enemyIndex.query(left, left + WINDOW_WIDTH + 2 * ACTIVITY_MARGIN, visibleEnemies);
+        for (int i : visibleEnemies) {
+            const Enemy& e = enemies[i];
+            if (!e.alive) continue;
+            SpectatorEnemy pose;
+            pose.facingRight = true;
+            float x = e.spawnX;
+            if (e.type == EnemyType::PATROL) {
+                x = patrolX(e.spawnX, e.patrolLeft, e.patrolRight, now.tick + e.phase,
+                            pose.facingRight);
+            }
+            pose.x = toFixed(x, POSITION_SCALE);
+            const SpectatorEnemy& old = sentEnemies[i];
+            if (pose.x == old.x && pose.facingRight == old.facingRight) continue;
+            pose.vx = pose.x - old.x;
+            enemyUpdates.push_back({i, pose});
+        }
+    }
+    w.gamma(enemyUpdates.size());
+    int last = -1;
+    for (const EnemyUpdate& u : enemyUpdates) {
+        writeEnemy(w, u.record - last - 1, sentEnemies[u.record], u.pose, false);
+        sentEnemies[u.record] = u.pose;
+        last = u.record;
+    }
+
+    w.finish();
+    appendMessage(out, payload);
+}
+
+void SpectatorEncoder::encodeKeyframe(Game& game, std::vector<uint8_t>& out) const {
+    std::vector<uint8_t> key;
+    BitWriter w(key);
+    w.flag(true);
+    w.flag(true);
+    writeView(w, SpectatorView(), sent, true);
+
+    w.gamma(sentChanges.size());
+    int previous = 0;
+    for (const LevelChange& change : sentChanges) writeEvent(w, change, false, previous);
+
+    // Every enemy viewers have seen away from its spawn state
+    std::vector<SpectatorEnemy> spawn;
+    if (!streamed) resetEnemies(game.getEnemies(), spawn);
+    std::vector<int> moved;
+    for (size_t i = 0; i < spawn.size(); i++) {
+        const SpectatorEnemy& e = sentEnemies[i];
+        if (e.x != spawn[i].x || e.vx != 0 || !e.facingRight) moved.push_back(i);
+    }
+    w.gamma(moved.size());
+    int last = -1;
+    for (int i : moved) {
+        writeEnemy(w, i - last - 1, spawn[i], sentEnemies[i], true);
+        last = i;
+    }
+
+    w.finish();
+    appendMessage(out, key);
+}
+
+// ─────────────────────────────────────────
+// Decoder
+// ─────────────────────────────────────────
+
+SpectatorDecoder::SpectatorDecoder()
+    : ready(false), view(), levelWidth(DEFAULT_LEVEL_WIDTH), tickRate(BASE_TICK_RATE) {}
+
+bool SpectatorDecoder::consume(std::vector<uint8_t>& buffer) {
+    size_t at = 0;
+    for (;;) {
+        // Length prefix
+        size_t length = 0, p = at;
+        int shift = 0;
+        bool complete = false;
+        while (p < buffer.size() && shift < 35) {
+            uint8_t b = buffer[p++];
+            length |= (size_t)(b & 0x7F) << shift;
+            shift += 7;
+            if (!(b & 0x80)) {
+                complete = true;
+                break;
+            }
+        }
+        if (!complete) {
+            if (shift >= 35) return false;
+            break;
+        }
+        if (length > MAX_MESSAGE) return false;
+        if (buffer.size() - p < length) break;
+
+        bool ok = ready ? applyFrame(buffer.data() + p, length)
+                        : applyHello(buffer.data() + p, length);
+        if (!ok) return false;
+        at = p + length;
+    }
+    buffer.erase(buffer.begin(), buffer.begin() + at);
+    return true;
+}
+
+bool SpectatorDecoder::applyHello(const uint8_t* data, size_t size) {
+    if (size < HELLO_SIZE || data[0] != HELLO_MAGIC || data[1] != STREAM_VERSION) {
+        fprintf(stderr, "Not a spectator stream, or a different version\n");
+        return false;
+    }
+    LevelSource source = (LevelSource)data[2];
+    bool streamed = data[3] != 0;
+    tickRate = std::max<int>(1, get16(data + 4));
+    const uint8_t* p = data + HELLO_SIZE;
+    size_t left = size - HELLO_SIZE;
+
+    switch (source) {
+        case LevelSource::BUILTIN:
+            initializePlatforms(platforms);
+            initializeCollectibles(collectibles);
+            initializeEnemies(enemies);
+            levelWidth = DEFAULT_LEVEL_WIDTH;
+            break;
+
+        case LevelSource::GENERATED: {
+            if (left < 24) return false;
+            LevelGenParams params(get32(p), (int)get32(p + 4));
+            params.coinChance = bitsFloat(get32(p + 8));
+            params.enemyChance = bitsFloat(get32(p + 12));
+            params.movingChance = bitsFloat(get32(p + 16));
+            params.bonusChance = bitsFloat(get32(p + 20));
+            levelWidth = generateLevel(params, platforms, collectibles, enemies);
+            break;
+        }
+
+        case LevelSource::FILE: {
+            if (left < 2 || left - 2 < get16(p)) return false;
+            std::string path((const char*)p + 2, get16(p));
+            LevelFile file;
+            if (!file.open(path)) {
+                fprintf(stderr, "Cannot open the game's level file %s\n", path.c_str());
+                return false;
+            }
+            levelWidth = file.width();
+            file.instantiate(platforms, collectibles, enemies);
+            break;
+        }
+
+        default:
+            return false;
+    }
+    // Only the players and camera follow the stream on streamed levels
+    if (streamed) {
+        collectibles.clear();
+        enemies.clear();
+    }
+
+    platformIndex.build(platforms);
+    coinIndex.build(collectibles);
+    enemyIndex.build(enemies);
+    ready = true;
+    return true;
+}
+
+bool SpectatorDecoder::applyFrame(const uint8_t* data, size_t size) {
+    BitReader r(data, size);
+    bool key = false;
+    if (r.flag()) {
+        key = r.flag();
+        view = SpectatorView();
+        for (Collectible& c : collectibles) c.collected = false;
+        for (Enemy& e : enemies) {
+            e.alive = true;
+            e.x = e.spawnX;
+            e.facingRight = true;
+        }
+        resetEnemies(enemies, enemyPoses);
+    }
+    readView(r, view, key);
+
+    uint32_t events = r.gamma();
+    int record = 0;
+    for (uint32_t i = 0; i < events && !r.failed; i++) {
+        bool coin = r.flag();
+        bool undo = r.flag();
+        record += r.signedValue();
+        if (record < 0 || record >= (int)(coin ? collectibles.size() : enemies.size())) {
+            return false;
+        }
+        if (coin) {
+            collectibles[record].collected = !undo;
+        } else {
+            enemies[record].alive = undo;
+        }
+    }
+
+    uint32_t updates = r.gamma();
+    int last = -1;
+    for (uint32_t i = 0; i < updates && !r.failed; i++) {
+        last += 1 + r.gamma();
+        if (last < 0 || last >= (int)enemies.size()) return false;
+        SpectatorEnemy& pose = enemyPoses[last];
+        int32_t x = pose.x + pose.vx + r.signedValue();
+        pose.vx = key ? r.signedValue() : x - pose.x;
+        pose.x = x;
+        pose.facingRight = r.flag();
+        enemies[last].x = pose.x / POSITION_SCALE;
+        enemies[last].facingRight = pose.facingRight;
+    }
+    return !r.failed;
+}
+
+void SpectatorDecoder::posePlayer(int slot, Player& out) const {
+    const SpectatorPlayer& p = view.players[slot];
+    out.reset();
+    out.x = p.x / POSITION_SCALE;
+    out.y = p.y / POSITION_SCALE;
+    out.squashScale = p.squash / SQUASH_SCALE;
+    out.onGround = (p.pose & POSE_ON_GROUND) != 0;
+    out.wallSliding = (p.pose & POSE_WALL_SLIDING) != 0;
+    out.facingRight = (p.pose & POSE_FACING_RIGHT) != 0;
+    // Only what Renderer::drawPlayer picks the frame from: |vx| > 1 and the run phase
+    out.vx = (p.pose & POSE_RUNNING) ? (out.facingRight ? 2.0f : -2.0f) : 0.0f;
+    out.animationTimer = (p.pose & POSE_RUN_FRAME) ? 2.0f : 0.0f;
+    out.jumpCount = p.pose >> POSE_JUMP_SHIFT;
+}
+
+float SpectatorDecoder::getCameraX() const {
+    return view.cameraX / POSITION_SCALE;
+}
+
+// ─────────────────────────────────────────
+// Sockets
+// ─────────────────────────────────────────
+
+// "unix:PATH" or a TCP port on 127.0.0.1
+static int openSocket(const std::string& address, sockaddr_storage& addr, socklen_t& size) {
+    memset(&addr, 0, sizeof(addr));
+    if (address.compare(0, 5, "unix:") == 0) {
+        std::string path = address.substr(5);
+        sockaddr_un* un = (sockaddr_un*)&addr;
+        if (path.empty() || path.size() >= sizeof(un->sun_path)) {
+            fprintf(stderr, "Bad Unix socket path: %s\n", path.c_str());
+            return -1;
+        }
+        un->sun_family = AF_UNIX;
+        memcpy(un->sun_path, path.c_str(), path.size() + 1);
+        size = sizeof(sockaddr_un);
+    } else {
+        int port = atoi(address.c_str());
+        if (port <= 0 || port > 65535) {
+            fprintf(stderr, "Bad spectator address: %s (unix:PATH or a port)\n",
+                    address.c_str());
+            return -1;
+        }
+        sockaddr_in* in = (sockaddr_in*)&addr;
+        in->sin_family = AF_INET;
+        in->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        in->sin_port = htons(port);
+        size = sizeof(sockaddr_in);
+    }
+    int fd = socket(addr.ss_family, SOCK_STREAM, 0);
+    if (fd < 0) perror("socket");
+    return fd;
+}
+
+static void setNonBlocking(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+SpectatorPublisher::SpectatorPublisher() : listenFd(-1), stats() {}
+
+SpectatorPublisher::~SpectatorPublisher() {
+    close();
+}
+
+bool SpectatorPublisher::listen(const std::string& address) {
+    close();
+    sockaddr_storage addr;
+    socklen_t size;
+    listenFd = openSocket(address, addr, size);
+    if (listenFd < 0) return false;
+
+    if (addr.ss_family == AF_UNIX) {
+        unixPath = ((sockaddr_un*)&addr)->sun_path;
+        unlink(unixPath.c_str());  // Left over from a previous run
+    } else {
+        int on = 1;
+        setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    }
+    if (bind(listenFd, (const sockaddr*)&addr, size) != 0 || ::listen(listenFd, 8) != 0) {
+        fprintf(stderr, "Cannot listen for spectators on %s: %s\n", address.c_str(),
+                strerror(errno));
+        unixPath.clear();
+        close();
+        return false;
+    }
+    setNonBlocking(listenFd);
+    return true;
+}
+
+void SpectatorPublisher::close() {
+    for (Viewer& v : viewers) ::close(v.fd);
+    viewers.clear();
+    if (listenFd >= 0) ::close(listenFd);
+    listenFd = -1;
+    if (!unixPath.empty()) unlink(unixPath.c_str());
+    unixPath.clear();
+}
+
+void SpectatorPublisher::accept(int tick) {
+    if (listenFd < 0) return;
+    for (;;) {
+        int fd = ::accept(listenFd, nullptr, nullptr);
+        if (fd < 0) return;
+        setNonBlocking(fd);
+        int on = 1;  // Frames are small and due now; fails harmlessly on Unix sockets
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        viewers.push_back({fd, false, std::vector<uint8_t>(), 0, tick});
+        printf("Spectator joined (%d watching)\n", (int)viewers.size());
+    }
+}
+
+// Hand the socket what it takes. False once the viewer has gone or fallen too far behind.
+bool SpectatorPublisher::flush(Viewer& viewer) {
+    uint8_t probe;
+    if (recv(viewer.fd, &probe, 1, MSG_DONTWAIT) == 0) return false;  // Closed
+
+    size_t done = 0;
+    while (done < viewer.outbox.size()) {
+        ssize_t n = send(viewer.fd, viewer.outbox.data() + done, viewer.outbox.size() - done,
+                         MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return false;
+        }
+        done += n;
+    }
+    viewer.outbox.erase(viewer.outbox.begin(), viewer.outbox.begin() + done);
+    viewer.bytesSent += done;
+    if (viewer.outbox.size() > MAX_OUTBOX) {
+        fprintf(stderr, "Spectator not keeping up, dropped\n");
+        return false;
+    }
+    return true;
+}
+
+void SpectatorPublisher::publish(Game& game) {
+    accept(game.getTick());
+    if (viewers.empty()) return;
+
+    auto start = std::chrono::steady_clock::now();
+    frame.clear();
+    encoder.encodeFrame(game, frame);
+    double ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+            .count();
+    stats.frames++;
+    stats.frameBytes += frame.size();
+    stats.encodeMs += ms;
+    stats.maxEncodeMs = std::max(stats.maxEncodeMs, ms);
+
+    // Viewers that just joined get the hello and a keyframe of the state this frame led to
+    bool joining = false;
+    for (Viewer& v : viewers) {
+        if (v.synced) {
+            v.outbox.insert(v.outbox.end(), frame.begin(), frame.end());
+        } else {
+            joining = true;
+        }
+    }
+    if (joining) {
+        scratch.clear();
+        encoder.encodeHello(game, scratch);
+        size_t helloSize = scratch.size();
+        encoder.encodeKeyframe(game, scratch);
+        stats.keyframes++;
+        stats.keyframeBytes += scratch.size() - helloSize;
+        for (Viewer& v : viewers) {
+            if (v.synced) continue;
+            v.outbox.insert(v.outbox.end(), scratch.begin(), scratch.end());
+            v.synced = true;
+        }
+    }
+
+    for (size_t i = 0; i < viewers.size();) {
+        Viewer& v = viewers[i];
+        if (flush(v)) {
+            i++;
+            continue;
+        }
+        double seconds = std::max(1, game.getTick() - v.joinedTick) / (double)BASE_TICK_RATE;
+        printf("Spectator left after %.0f s: %.0f B/s; encoding %.1f us per frame on average, "
+               "%.1f us at most\n",
+               seconds, v.bytesSent / seconds, 1000.0 * stats.encodeMs / stats.frames,
+               1000.0 * stats.maxEncodeMs);
+        ::close(v.fd);
+        viewers.erase(viewers.begin() + i);
+    }
+}
+
+SpectatorClient::SpectatorClient() : fd(-1), received(0) {}
+
+SpectatorClient::~SpectatorClient() {
+    if (fd >= 0) ::close(fd);
+}
+
+bool SpectatorClient::connect(const std::string& address) {
+    sockaddr_storage addr;
+    socklen_t size;
+    fd = openSocket(address, addr, size);
+    if (fd < 0) return false;
+    if (::connect(fd, (const sockaddr*)&addr, size) != 0) {
+        fprintf(stderr, "Cannot connect to %s: %s\n", address.c_str(), strerror(errno));
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+    setNonBlocking(fd);
+    return true;
+}
+
+bool SpectatorClient::poll() {
+    if (fd < 0) return false;
+    bool open = true;
+    uint8_t chunk[16384];
+    for (;;) {
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n > 0) {
+            buffer.insert(buffer.end(), chunk, chunk + n);
+            received += n;
+            continue;
+        }
+        if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) open = false;
+        break;
+    }
+    if (!decoder.consume(buffer)) {
+        fprintf(stderr, "Malformed spectator stream\n");
+        return false;
+    }
+    return open;
+}
@@ -0,0 +1,312 @@
+#include "streaming.h"
+#include "constants.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+LevelStreamer::LevelStreamer() : file(nullptr), chunkCount(0), inFlight(-1), quit(false) {
+    stats = StreamStats();
+}
+
+LevelStreamer::~LevelStreamer() {
+    stop();
+    for (Chunk* chunk : pool) delete chunk;
+}
+
+void LevelStreamer::start(const LevelFile* levelFile) {
+    stop();
+    file = levelFile;
+    chunkCount = (int)ceil(file->width() / CHUNK_WIDTH);
+    if (chunkCount < 1) chunkCount = 1;
+    coinCollected.assign(file->coinCount(), false);
+    enemyKilled.assign(file->enemyCount(), false);
+    stats = StreamStats();
+    worker = std::thread(&LevelStreamer::workerLoop, this);
+}
+
+void LevelStreamer::stop() {
+    if (!file) return;
+    reset();
+    stopWorker();
+    file = nullptr;
+    chunkCount = 0;
+}
+
+void LevelStreamer::reset() {
+    // Drain the worker: drop queued requests and wait out the chunk in flight
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (Chunk* chunk : requests) recycle(chunk);
+        requests.clear();
+        delivered.wait(lock, [this] { return inFlight < 0; });
+    }
+    collectCompleted();
+
+    for (auto& entry : resident) recycle(entry.second);
+    resident.clear();
+    pending.clear();
+    active.clear();
+    coinCollected.assign(coinCollected.size(), false);
+    enemyKilled.assign(enemyKilled.size(), false);
+}
+
+void LevelStreamer::waitIdle() {
+    std::unique_lock<std::mutex> lock(mutex);
+    delivered.wait(lock, [this] { return requests.empty() && inFlight < 0; });
+}
+
+void LevelStreamer::stopWorker() {
+    if (!worker.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    wake.notify_all();
+    worker.join();
+    quit = false;
+}
+
+// ─────────────────────────────────────────
+// Worker
+// ─────────────────────────────────────────
+
+void LevelStreamer::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return quit || !requests.empty(); });
+        if (quit) break;
+
+        Chunk* chunk = requests.front();
+        requests.pop_front();
+        inFlight = chunk->index;
+        lock.unlock();
+
+        decodeChunk(*chunk);
+
+        lock.lock();
+        inFlight = -1;
+        completed.push_back(chunk);
+        delivered.notify_all();
+    }
+}
+
+template <typename Record>
+static size_t lowerBoundX(const Record* records, size_t count, float x) {
+    return std::lower_bound(records, records + count, x,
+                            [](const Record& r, float value) { return r.x < value; }) -
+           records;
+}
+
+// Only reads the (immutable) mapped file, so it is safe on the worker thread
+void LevelStreamer::decodeChunk(Chunk& chunk) const {
+    const float inf = std::numeric_limits<float>::infinity();
+    float x0 = chunk.index == 0 ? -inf : chunk.index * CHUNK_WIDTH;
+    float x1 = chunk.index == chunkCount - 1 ? inf : (chunk.index + 1) * CHUNK_WIDTH;
+
+    const PlatformRecord* platforms = file->platforms();
+    size_t p0 = lowerBoundX(platforms, file->platformCount(), x0);
+    size_t p1 = lowerBoundX(platforms, file->platformCount(), x1);
+    for (size_t i = p0; i < p1; i++) chunk.platforms.push_back(platformFromRecord(platforms[i]));
+
+    const CoinRecord* coins = file->coins();
+    size_t c0 = lowerBoundX(coins, file->coinCount(), x0);
+    size_t c1 = lowerBoundX(coins, file->coinCount(), x1);
+    for (size_t i = c0; i < c1; i++) chunk.coins.push_back(coinFromRecord(coins[i]));
+    chunk.coinBase = c0;
+
+    const EnemyRecord* enemies = file->enemies();
+    size_t e0 = lowerBoundX(enemies, file->enemyCount(), x0);
+    size_t e1 = lowerBoundX(enemies, file->enemyCount(), x1);
+    for (size_t i = e0; i < e1; i++) chunk.enemies.push_back(enemyFromRecord(enemies[i]));
+    chunk.enemyBase = e0;
+}
+
+// ─────────────────────────────────────────
+// Chunk bookkeeping (game thread)
+// ─────────────────────────────────────────
+
+LevelStreamer::Chunk* LevelStreamer::acquireChunk(int index) {
+    Chunk* chunk;
+    if (pool.empty()) {
+        chunk = new Chunk();
+    } else {
+        chunk = pool.back();
+        pool.pop_back();
+    }
+    chunk->index = index;
+    return chunk;
+}
+
+// Return a chunk to the pool, keeping its vectors' capacity for reuse
+void LevelStreamer::recycle(Chunk* chunk) {
+    chunk->platforms.clear();
+    chunk->coins.clear();
+    chunk->enemies.clear();
+    pool.push_back(chunk);
+}
+
+void LevelStreamer::request(int index) {
+    if (index < 0 || index >= chunkCount) return;
+    if (resident.count(index) || pending.count(index)) return;
+
+    Chunk* chunk = acquireChunk(index);
+    pending.insert(index);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        requests.push_back(chunk);
+    }
+    wake.notify_one();
+}
+
+void LevelStreamer::collectCompleted() {
+    std::vector<Chunk*> done;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done.swap(completed);
+    }
+    for (Chunk* chunk : done) {
+        pending.erase(chunk->index);
+        resident[chunk->index] = chunk;
+        stats.asyncLoads++;
+    }
+}
+
+// Make a chunk resident now. Only happens when prefetch fell behind (e.g. on respawn), and
+// deliberately blocks the tick: simulating without the chunk would drop the player through
+// platforms that are not there yet, and make the game depend on the worker's timing.
+LevelStreamer::Chunk* LevelStreamer::waitForChunk(int index) {
+    auto it = resident.find(index);
+    if (it != resident.end()) return it->second;
+    stats.syncLoads++;
+    auto start = std::chrono::steady_clock::now();
+
+    Chunk* chunk = nullptr;
+    std::unique_lock<std::mutex> lock(mutex);
+    if (inFlight == index) {
+        delivered.wait(lock, [this, index] { return inFlight != index; });
+        lock.unlock();
+        collectCompleted();
+        chunk = resident[index];
+    } else {
+        // Still queued: take it back and decode it here, otherwise decode from scratch
+        for (auto q = requests.begin(); q != requests.end(); ++q) {
+            if ((*q)->index == index) {
+                chunk = *q;
+                requests.erase(q);
+                break;
+            }
+        }
+        lock.unlock();
+
+        if (!chunk) chunk = acquireChunk(index);
+        decodeChunk(*chunk);
+        pending.erase(index);
+        resident[index] = chunk;
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+                    .count();
+    stats.worstSyncMs = std::max(stats.worstSyncMs, ms);
+    return chunk;
+}
+
+// Copy live entity state from the game vectors back into the active chunks
+void LevelStreamer::writeBack(std::vector<Platform>& platforms,
+                              std::vector<Collectible>& collectibles,
+                              std::vector<Enemy>& enemies) {
+    size_t p = 0, c = 0, e = 0;
+    for (int index : active) {
+        Chunk* chunk = resident[index];
+        size_t np = chunk->platforms.size(), nc = chunk->coins.size(), ne = chunk->enemies.size();
+        if (p + np > platforms.size() || c + nc > collectibles.size() || e + ne > enemies.size()) {
+            return;  // Game vectors were replaced behind our back; nothing to write back
+        }
+
+        std::copy(platforms.begin() + p, platforms.begin() + p + np, chunk->platforms.begin());
+        std::copy(collectibles.begin() + c, collectibles.begin() + c + nc, chunk->coins.begin());
+        std::copy(enemies.begin() + e, enemies.begin() + e + ne, chunk->enemies.begin());
+
+        for (size_t i = 0; i < nc; i++) {
+            if (chunk->coins[i].collected) coinCollected[chunk->coinBase + i] = true;
+        }
+        for (size_t i = 0; i < ne; i++) {
+            if (!chunk->enemies[i].alive) enemyKilled[chunk->enemyBase + i] = true;
+        }
+        p += np;
+        c += nc;
+        e += ne;
+    }
+}
+
+void LevelStreamer::evict(int index) {
+    auto it = resident.find(index);
+    if (it == resident.end()) return;
+    recycle(it->second);
+    resident.erase(it);
+    stats.evictions++;
+}
+
+// ─────────────────────────────────────────
+// Per-tick update
+// ─────────────────────────────────────────
+
+bool LevelStreamer::update(float cameraX, float playerVx, std::vector<Platform>& platforms,
+                           std::vector<Collectible>& collectibles, std::vector<Enemy>& enemies) {
+    if (!file) return false;
+    collectCompleted();
+
+    int first = (int)floor(cameraX / CHUNK_WIDTH) - ACTIVE_MARGIN_CHUNKS;
+    int last = (int)floor((cameraX + WINDOW_WIDTH) / CHUNK_WIDTH) + ACTIVE_MARGIN_CHUNKS;
+    first = std::max(first, 0);
+    last = std::min(last, chunkCount - 1);
+
+    // Prefetch in the direction of travel (both ways when standing still)
+    int direction = playerVx > 0.5f ? 1 : (playerVx < -0.5f ? -1 : 0);
+    for (int i = 1; i <= PREFETCH_CHUNKS; i++) {
+        if (direction >= 0) request(last + i);
+        if (direction <= 0) request(first - i);
+    }
+
+    // Activate the chunks around the camera
+    bool changed = false;
+    std::vector<int> desired;
+    for (int i = first; i <= last; i++) desired.push_back(i);
+
+    if (desired != active) {
+        writeBack(platforms, collectibles, enemies);
+
+        platforms.clear();
+        collectibles.clear();
+        enemies.clear();
+        for (int index : desired) {
+            Chunk* chunk = waitForChunk(index);
+            platforms.insert(platforms.end(), chunk->platforms.begin(), chunk->platforms.end());
+
+            for (size_t i = 0; i < chunk->coins.size(); i++) {
+                collectibles.push_back(chunk->coins[i]);
+                if (coinCollected[chunk->coinBase + i]) collectibles.back().collected = true;
+            }
+            for (size_t i = 0; i < chunk->enemies.size(); i++) {
+                enemies.push_back(chunk->enemies[i]);
+                if (enemyKilled[chunk->enemyBase + i]) enemies.back().alive = false;
+            }
+        }
+        active.swap(desired);
+        changed = true;
+    }
+
+    // Evict chunks outside the prefetch window plus a little hysteresis
+    int keepFirst = first - PREFETCH_CHUNKS - KEEP_CHUNKS;
+    int keepLast = last + PREFETCH_CHUNKS + KEEP_CHUNKS;
+    std::vector<int> stale;
+    for (auto& entry : resident) {
+        if (entry.first < keepFirst || entry.first > keepLast) stale.push_back(entry.first);
+    }
+    for (int index : stale) evict(index);
+
+    stats.residentChunks = resident.size();
+    stats.activeChunks = active.size();
+    stats.pooledChunks = pool.size();
+    return changed;
+}
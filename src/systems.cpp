@@ -0,0 +1,99 @@
+#include "systems.h"
+#include <cmath>
+
+Entity spawnCoin(Registry& registry, const Collectible& coin, int record) {
+    Entity e = registry.create();
+    registry.transforms.insert(e, Transform{coin.x, coin.y});
+    registry.boxes.insert(e, AABB{COIN_PICKUP_RADIUS, COIN_PICKUP_RADIUS});
+    registry.animations.insert(e, Animation{coin.phase});
+    registry.drawables.insert(e, Drawable{SpriteKind::COIN, COIN_SPRITE_SCALE});
+    registry.pickups.insert(e, Pickup{record, 100});
+    return e;
+}
+
+Entity spawnEnemy(Registry& registry, const Enemy& enemy, int record, int tick) {
+    Entity e = registry.create();
+    registry.transforms.insert(e, Transform{enemy.spawnX, enemy.y});
+    registry.velocities.insert(e, Velocity{0, 0});
+    registry.boxes.insert(e, AABB{enemy.width / 2, enemy.height / 2});
+    registry.animations.insert(e, Animation{enemy.phase});
+    registry.drawables.insert(e, Drawable{SpriteKind::ENEMY, ENEMY_SPRITE_SCALE});
+    registry.hazards.insert(e, Hazard{record, 200});
+
+    if (enemy.type == EnemyType::PATROL) {
+        registry.patrols.insert(
+            e, Patrol{enemy.spawnX, enemy.patrolLeft, enemy.patrolRight, enemy.phase});
+        bool facingRight;
+        Transform& t = registry.transforms.get(e);
+        t.x = patrolX(enemy.spawnX, enemy.patrolLeft, enemy.patrolRight, tick + enemy.phase,
+                      facingRight);
+        registry.velocities.get(e).vx = facingRight ? ENEMY_PATROL_SPEED : -ENEMY_PATROL_SPEED;
+    }
+    return e;
+}
+
+void patrolSystem(Registry& registry, int tick) {
+    patrolSystem(registry, tick, 0, registry.patrols.size());
+}
+
+void patrolSystem(Registry& registry, int tick, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+        const Patrol& p = registry.patrols[i];
+        Entity e = registry.patrols.entity(i);
+
+        bool facingRight;
+        registry.transforms.get(e).x = patrolX(p.spawnX, p.left, p.right, tick + p.phase,
+                                               facingRight);
+        registry.velocities.get(e).vx = facingRight ? ENEMY_PATROL_SPEED : -ENEMY_PATROL_SPEED;
+    }
+}
+
+void addTrigger(const Registry& registry, SweepAndPrune& triggers, Entity e) {
+    const Transform& t = registry.transforms.get(e);
+    const AABB& box = registry.boxes.get(e);
+    triggers.insert(e, t.x - box.halfWidth, t.x + box.halfWidth);
+}
+
+void syncTriggers(const Registry& registry, SweepAndPrune& triggers) {
+    for (size_t i = 0; i < registry.patrols.size(); i++) {
+        Entity e = registry.patrols.entity(i);
+        float x = registry.transforms.get(e).x;
+        float halfWidth = registry.boxes.get(e).halfWidth;
+        triggers.move(e, x - halfWidth, x + halfWidth);
+    }
+}
+
+void extractSprites(const Registry& registry, SpriteKind kind, float tick,
+                    std::vector<SpriteInstance>& out) {
+    for (size_t i = 0; i < registry.drawables.size(); i++) {
+        const Drawable& drawable = registry.drawables[i];
+        if (drawable.kind != kind) continue;
+
+        Entity e = registry.drawables.entity(i);
+        const Transform& t = registry.transforms.get(e);
+        float clock = tick + registry.animations.get(e).phase;
+        bool facingLeft = kind == SpriteKind::ENEMY && registry.velocities.get(e).vx < 0;
+        out.push_back(poseSprite(kind, t.x, t.y, drawable.scale, clock, facingLeft));
+    }
+}
+
+SpriteInstance poseSprite(SpriteKind kind, float x, float y, float scale, float clock,
+                          bool facingLeft) {
+    SpriteInstance s;
+    s.kind = kind;
+    s.x = x;
+    if (kind == SpriteKind::COIN) {
+        float rotation = COIN_ROTATION_SPEED * clock;
+        s.y = y + sin(COIN_BOB_SPEED * clock) * 5;
+        s.scale = scale * (1.0f + 0.08f * sin(rotation * 2));
+        s.frame = ((int)(rotation * 3)) % 6;
+        s.flipX = false;
+    } else {
+        float animation = ENEMY_ANIMATION_SPEED * clock;
+        s.y = y + fabs(sin(animation * 0.3f)) * 3;
+        s.scale = scale;
+        s.frame = ((int)(animation * 0.3f)) % 2;
+        s.flipX = facingLeft;
+    }
+    return s;
+}
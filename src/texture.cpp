@@ -1,10 +1,26 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 #include "texture.h"
+#include "backend.h"
+#include "spritegen.h"
+#include <algorithm>
 #include <cstdio>
+#include <iterator>
+#include <sys/inotify.h>
+#include <unistd.h>
 
 TextureManager* TextureManager::instance = nullptr;
 
+TextureManager::TextureManager()
+    : loaderThreads(-1),
+      loadersStarted(false),
+      pendingLoads(0),
+      watchFd(-1),
+      hotReloads(0),
+      frameNumber(0),
+      stats(),
+      indexing(true) {}
+
 TextureManager& TextureManager::getInstance() {
     if (!instance) {
         instance = new TextureManager();
@@ -12,50 +28,526 @@ TextureManager& TextureManager::getInstance() {
     return *instance;
 }
 
-bool TextureManager::loadSprite(const std::string& name, const std::string& path, int frameCount) {
-    int width, height, channels;
-    stbi_set_flip_vertically_on_load(true);  // OpenGL expects bottom-up
-    unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 4);  // Force RGBA
+// Whether sprites loaded now should be indexed; GL thread only
+bool TextureManager::indexSprites() {
+    return indexing && renderBackend().hasPaletteLookup();
+}
 
-    if (!data) {
-        fprintf(stderr, "Failed to load sprite: %s (%s)\n", path.c_str(), stbi_failure_reason());
-        return false;
+// Bind the sprite's texture for a new image, creating it on first use
+void TextureManager::prepare(Sprite& sprite, int width, int height, bool indexed) {
+    if (sprite.ready) {
+        glBindTexture(GL_TEXTURE_2D, sprite.textureID);
+        stats.residentBytes -= sprite.textureBytes;
+    } else {
+        glGenTextures(1, &sprite.textureID);
+        glBindTexture(GL_TEXTURE_2D, sprite.textureID);
+
+        // Nearest-neighbor filtering for pixel art (no blurring)
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    }
+    if (!indexed && sprite.paletteID) {
+        glDeleteTextures(1, &sprite.paletteID);
+        sprite.paletteID = 0;
     }
 
-    GLuint textureID;
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
+    sprite.width = width;
+    sprite.height = height;
+    sprite.frameWidth = width / sprite.frameCount;
+    sprite.frameHeight = height;
+    sprite.indexed = indexed;
+}
 
-    // Nearest-neighbor filtering for pixel art (no blurring)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+// Account for the image just uploaded by prepare()'s caller
+void TextureManager::finish(Sprite& sprite, size_t texelBytes) {
+    sprite.ready = true;
+    sprite.textureBytes = texelBytes;
+    if (sprite.indexed) sprite.textureBytes += (size_t)sprite.paletteSize * sprite.paletteRows * 4;
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+    stats.residentBytes += sprite.textureBytes;
+    stats.peakBytes = std::max(stats.peakBytes, stats.residentBytes);
+    if (sprite.evicted && sprite.reloadRequested >= 0) {
+        stats.maxStallFrames = std::max(stats.maxStallFrames, frameNumber - sprite.reloadRequested);
+    }
+    sprite.evicted = false;
+}
 
-    stbi_image_free(data);
+// Create the sprite's texture from RGBA pixels, indexed if it can be. A sprite that already
+// has one gets the new pixels in place, or a reallocated image in the same texture if the
+// size or storage changed.
+void TextureManager::upload(Sprite& sprite, const std::string& name, const unsigned char* pixels,
+                            int width, int height) {
+    if (indexSprites()) {
+        std::vector<uint32_t> palette;
+        std::vector<unsigned char> indices;
+        if (indexColors(pixels, width * height, palette, indices)) {
+            uploadIndexed(sprite, name, indices.data(), palette, width, height);
+            return;
+        }
+    }
+
+    bool inPlace = sprite.ready && !sprite.indexed && width == sprite.width &&
+                   height == sprite.height;
+    prepare(sprite, width, height, false);
+    palettes.erase(name);
+    if (inPlace) {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    } else {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                     pixels);
+    }
+    finish(sprite, (size_t)width * height * 4);
+}
+
+void TextureManager::uploadIndexed(Sprite& sprite, const std::string& name,
+                                   const unsigned char* indices,
+                                   const std::vector<uint32_t>& palette, int width, int height) {
+    bool inPlace = sprite.ready && sprite.indexed && width == sprite.width &&
+                   height == sprite.height;
+    prepare(sprite, width, height, true);
+    bool core = renderBackend().isCoreProfile();
+    GLenum format = core ? GL_RED : GL_LUMINANCE;
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);  // Rows of odd widths are not padded
+    if (inPlace) {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, GL_UNSIGNED_BYTE,
+                        indices);
+    } else {
+        glTexImage2D(GL_TEXTURE_2D, 0, core ? GL_R8 : GL_LUMINANCE8, width, height, 0, format,
+                     GL_UNSIGNED_BYTE, indices);
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    palettes[name] = palette;
+    uploadPalette(name, sprite);
+    finish(sprite, (size_t)width * height);
+}
+
+// The sprite's palette and a row per variant
+void TextureManager::uploadPalette(const std::string& name, Sprite& sprite) {
+    const std::vector<uint32_t>& base = palettes[name];
+    const PaletteVariants& rows = variants[name];
+    std::vector<uint32_t> texels(base), row;
+    for (const auto& variant : rows) {
+        swapPalette(base, variant.second, row);
+        texels.insert(texels.end(), row.begin(), row.end());
+    }
+
+    if (!sprite.paletteID) {
+        glGenTextures(1, &sprite.paletteID);
+        glBindTexture(GL_TEXTURE_2D, sprite.paletteID);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    } else {
+        glBindTexture(GL_TEXTURE_2D, sprite.paletteID);
+    }
+    sprite.paletteSize = (int)base.size();
+    sprite.paletteRows = 1 + (int)rows.size();
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, sprite.paletteSize, sprite.paletteRows, 0, GL_RGBA,
+                 GL_UNSIGNED_BYTE, texels.data());
+}
+
+// A decoded or generated image, indexed already if the loader thread managed to
+void TextureManager::uploadDecodedImage(Sprite& sprite, const Decoded& d,
+                                        const unsigned char* pixels) {
+    if (!d.indices.empty() && indexSprites()) {
+        uploadIndexed(sprite, d.name, d.indices.data(), d.palette, d.width, d.height);
+    } else {
+        upload(sprite, d.name, pixels, d.width, d.height);
+    }
+}
+
+// Straight from the mapped pack, expanded to RGBA8 on the CPU if it is indexed and the GL
+// cannot look colours up itself
+void TextureManager::uploadPacked(Sprite& sprite, const std::string& name,
+                                  const AssetPackEntry& entry) {
+    if (!(entry.flags & ASSET_FLAG_INDEXED)) {
+        upload(sprite, name, pack.pixels(entry), entry.width, entry.height);
+        return;
+    }
+    const uint32_t* colors = (const uint32_t*)pack.pixels(entry);
+    std::vector<uint32_t> palette(colors, colors + pack.paletteSize(entry));
+    int count = entry.width * entry.height;
+    if (indexSprites()) {
+        uploadIndexed(sprite, name, pack.indices(entry), palette, entry.width, entry.height);
+    } else {
+        // A corrupt pack can hold indices past the palette; they read as transparent black
+        palette.resize(256, 0);
+        std::vector<unsigned char> rgba((size_t)count * 4);
+        expandIndexed(pack.indices(entry), count, palette.data(), rgba.data());
+        upload(sprite, name, rgba.data(), entry.width, entry.height);
+    }
+}
 
+static Sprite makeSprite(int width, int height, int frameCount) {
     Sprite sprite;
-    sprite.textureID = textureID;
+    sprite.textureID = 0;
     sprite.width = width;
     sprite.height = height;
     sprite.frameWidth = width / frameCount;
     sprite.frameHeight = height;
     sprite.frameCount = frameCount;
+    sprite.ready = false;
+    sprite.topDown = false;
+    sprite.lastUsed = -1;
+    sprite.evicted = false;
+    sprite.reloadRequested = -1;
+    sprite.indexed = false;
+    sprite.paletteID = 0;
+    sprite.paletteSize = 0;
+    sprite.paletteRows = 0;
+    sprite.textureBytes = 0;
+    return sprite;
+}
+
+bool TextureManager::openPack(const std::string& path) {
+    return pack.open(path);
+}
 
+bool TextureManager::loadFromPack(const std::string& name, int frameCount) {
+    const AssetPackEntry* entry = pack.isOpen() ? pack.find(name) : nullptr;
+    if (!entry) return false;
+    Sprite sprite = makeSprite(entry->width, entry->height, frameCount);
+    sprite.topDown = (entry->flags & ASSET_FLAG_FLIPPED) == 0;
+    uploadPacked(sprite, name, *entry);
     sprites[name] = sprite;
+    origins[name] = Origin{std::string(), -1};
+    return true;
+}
+
+bool TextureManager::loadSprite(const std::string& name, const std::string& path, int frameCount) {
+    if (loadFromPack(name, frameCount)) {
+        printf("  Loaded sprite: %s (packed, %dx%d, %d frames)\n", name.c_str(),
+               sprites[name].width, sprites[name].height, frameCount);
+        return true;
+    }
+
+    int width, height, channels;
+    stbi_set_flip_vertically_on_load(true);  // OpenGL expects bottom-up
+    unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 4);  // Force RGBA
+
+    if (!data) {
+        fprintf(stderr, "Failed to load sprite: %s (%s)\n", path.c_str(), stbi_failure_reason());
+        return false;
+    }
+
+    Sprite sprite = makeSprite(width, height, frameCount);
+    upload(sprite, name, data, width, height);
+    stbi_image_free(data);
+
+    sprites[name] = sprite;
+    origins[name] = Origin{path, -1};
     printf("  Loaded sprite: %s (%dx%d, %d frames)\n", name.c_str(), width, height, frameCount);
     return true;
 }
 
+bool TextureManager::loadSpriteAsync(const std::string& name, const std::string& path,
+                                     int frameCount) {
+    if (sprites.count(name) || loadFromPack(name, frameCount)) return true;
+
+    // The header alone gives the size, so layout code can use the sprite before it is ready
+    int width, height, channels;
+    if (!stbi_info(path.c_str(), &width, &height, &channels)) {
+        fprintf(stderr, "Failed to load sprite: %s (%s)\n", path.c_str(), stbi_failure_reason());
+        return false;
+    }
+    sprites[name] = makeSprite(width, height, frameCount);
+    origins[name] = Origin{path, -1};
+    pendingLoads++;
+    decodeAsync(name, path, 0);
+    return true;
+}
+
+void TextureManager::decodeAsync(const std::string& name, const std::string& path, int reload) {
+    startLoaders();
+    loaders.submit([this, name, path, reload]() {
+        Decoded result;
+        result.name = name;
+        result.frameCount = 0;
+        result.reload = reload;
+        result.generator = -1;
+        int channels;
+        stbi_set_flip_vertically_on_load_thread(true);
+        result.pixels = stbi_load(path.c_str(), &result.width, &result.height, &channels, 4);
+        if (!result.pixels) {
+            fprintf(stderr, "Failed to load sprite: %s (%s)\n", path.c_str(),
+                    stbi_failure_reason());
+        } else if (indexing && !indexColors(result.pixels, result.width * result.height,
+                                            result.palette, result.indices)) {
+            result.indices.clear();  // Too many colours; stays RGBA
+        }
+        std::lock_guard<std::mutex> lock(decodedMutex);
+        decoded.push_back(std::move(result));
+    }, decoding);
+}
+
+void TextureManager::startLoaders() {
+    if (loadersStarted) return;
+    int count = loaderThreads;
+    if (count < 0) count = JobSystem::defaultWorkerCount() + 1;
+    loaders.setWorkerCount(count);
+    loadersStarted = true;
+}
+
+void TextureManager::loadGeneratedSprites() {
+    for (int i = 0; i < SPRITE_GENERATOR_COUNT; i++) generateAsync(i);
+}
+
+void TextureManager::generateAsync(int generator) {
+    startLoaders();
+    pendingLoads++;  // Until the generator says how many sheets it drew
+    loaders.submit([this, generator]() {
+        std::vector<SpriteImage> sheets;
+        SPRITE_GENERATORS[generator](sheets);
+
+        std::lock_guard<std::mutex> lock(decodedMutex);
+        pendingLoads += (int)sheets.size() - 1;
+        for (SpriteImage& sheet : sheets) {
+            Decoded result;
+            result.name = sheet.name;
+            result.pixels = nullptr;
+            result.generated.swap(sheet.rgba);
+            result.width = sheet.width;
+            result.height = sheet.height;
+            result.frameCount = sheet.frameCount;
+            result.reload = 0;
+            result.generator = generator;
+            if (indexing && !indexColors(result.generated.data(), result.width * result.height,
+                                         result.palette, result.indices)) {
+                result.indices.clear();
+            }
+            decoded.push_back(std::move(result));
+        }
+    }, decoding);
+}
+
+int TextureManager::uploadDecoded(int maxUploads) {
+    std::vector<Decoded> batch;
+    {
+        std::lock_guard<std::mutex> lock(decodedMutex);
+        size_t count = decoded.size();
+        if (maxUploads >= 0 && (size_t)maxUploads < count) count = maxUploads;
+        batch.assign(std::make_move_iterator(decoded.begin()),
+                     std::make_move_iterator(decoded.begin() + count));
+        decoded.erase(decoded.begin(), decoded.begin() + count);
+    }
+
+    for (Decoded& d : batch) {
+        auto it = sprites.find(d.name);
+        if (d.reload) {
+            // Only the newest reload of a sprite counts; a broken save keeps the old pixels
+            if (it != sprites.end() && d.pixels && d.reload == reloadSerials[d.name]) {
+                it->second.topDown = false;
+                uploadDecodedImage(it->second, d, d.pixels);
+                origins[d.name] = Origin{watchDirectory + "/" + d.name + ".png", -1};
+                hotReloads++;
+            }
+            stbi_image_free(d.pixels);
+            continue;
+        }
+
+        pendingLoads--;
+        if (!d.generated.empty()) {
+            if (it != sprites.end()) {
+                // Loaded some other way, or a sibling sheet of one being loaded back
+                if (it->second.evicted) uploadDecodedImage(it->second, d, d.generated.data());
+                continue;
+            }
+            // Uploaded as drawn, top-down, and drawn with v reversed rather than flipped
+            Sprite sprite = makeSprite(d.width, d.height, d.frameCount);
+            sprite.topDown = true;
+            uploadDecodedImage(sprite, d, d.generated.data());
+            sprites[d.name] = sprite;
+            origins[d.name] = Origin{std::string(), d.generator};
+            continue;
+        }
+        if (!d.pixels) {
+            // As if it had never loaded; an evicted sprite stays, drawing nothing
+            if (it != sprites.end() && !it->second.evicted) sprites.erase(it);
+            continue;
+        }
+        // The header may have lied; upload() takes the decoded size
+        if (it != sprites.end()) uploadDecodedImage(it->second, d, d.pixels);
+        stbi_image_free(d.pixels);
+    }
+    return pendingLoads;
+}
+
+void TextureManager::finishLoading() {
+    loaders.wait(decoding);
+    uploadDecoded();
+}
+
+void TextureManager::setLoaderThreads(int count) {
+    loaders.wait(decoding);
+    loaderThreads = count;
+    loadersStarted = false;  // Restarted with the new count by the next load
+}
+
+bool TextureManager::watchSprites(const std::string& directory) {
+    if (watchFd < 0) watchFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    // Editors either rewrite the file or save a temporary and rename it over the original
+    if (watchFd < 0 ||
+        inotify_add_watch(watchFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        fprintf(stderr, "Cannot watch %s for sprite changes\n", directory.c_str());
+        return false;
+    }
+    watchDirectory = directory;
+    return true;
+}
+
+void TextureManager::checkWatched() {
+    if (watchFd < 0) return;
+
+    std::vector<std::string> changed;
+    alignas(inotify_event) char buffer[4096];
+    ssize_t bytes;
+    while ((bytes = read(watchFd, buffer, sizeof(buffer))) > 0) {
+        for (char* p = buffer; p < buffer + bytes;) {
+            const inotify_event* event = (const inotify_event*)p;
+            p += sizeof(inotify_event) + event->len;
+
+            std::string file = event->len ? event->name : "";
+            if (file.size() <= 4 || file.compare(file.size() - 4, 4, ".png") != 0) continue;
+            std::string name = file.substr(0, file.size() - 4);
+            if (sprites.count(name) &&
+                std::find(changed.begin(), changed.end(), name) == changed.end()) {
+                changed.push_back(name);
+            }
+        }
+    }
+
+    for (const std::string& name : changed) {
+        decodeAsync(name, watchDirectory + "/" + name + ".png", ++reloadSerials[name]);
+    }
+}
+
+void TextureManager::setIndexedSprites(bool enabled) {
+    loaders.wait(decoding);  // Loader threads read the flag
+    indexing = enabled;
+}
+
+int TextureManager::definePalette(const std::string& spriteName, const std::string& variant,
+                                  const PaletteSwap& swap) {
+    PaletteVariants& rows = variants[spriteName];
+    size_t row = 0;
+    while (row < rows.size() && rows[row].first != variant) row++;
+    if (row == rows.size()) {
+        rows.push_back(std::make_pair(variant, swap));
+    } else {
+        rows[row].second = swap;
+    }
+
+    // Already uploaded: add the row now
+    auto it = sprites.find(spriteName);
+    if (it != sprites.end() && it->second.ready && it->second.indexed) {
+        Sprite& sprite = it->second;
+        size_t before = (size_t)sprite.paletteSize * sprite.paletteRows * 4;
+        uploadPalette(spriteName, sprite);
+        size_t after = (size_t)sprite.paletteSize * sprite.paletteRows * 4;
+        sprite.textureBytes += after - before;
+        stats.residentBytes += after - before;
+        stats.peakBytes = std::max(stats.peakBytes, stats.residentBytes);
+    }
+    return (int)row + 1;
+}
+
+void TextureManager::setTextureBudget(size_t bytes) {
+    stats.budgetBytes = bytes;
+}
+
+void TextureManager::nextFrame() {
+    frameNumber++;
+    while (stats.budgetBytes && stats.residentBytes > stats.budgetBytes) {
+        // Least recently drawn first, then largest
+        Sprite* victim = nullptr;
+        for (auto& pair : sprites) {
+            Sprite& sprite = pair.second;
+            if (!sprite.ready || sprite.lastUsed >= frameNumber - 1) continue;
+            if (!victim || sprite.lastUsed < victim->lastUsed ||
+                (sprite.lastUsed == victim->lastUsed &&
+                 sprite.width * sprite.height > victim->width * victim->height)) {
+                victim = &sprite;
+            }
+        }
+        if (!victim) break;  // The last frame's sprites alone are over budget
+        evict(*victim);
+    }
+}
+
+void TextureManager::evict(Sprite& sprite) {
+    glDeleteTextures(1, &sprite.textureID);
+    if (sprite.paletteID) glDeleteTextures(1, &sprite.paletteID);
+    sprite.textureID = sprite.paletteID = 0;
+    sprite.ready = false;
+    sprite.evicted = true;
+    sprite.reloadRequested = -1;
+    stats.residentBytes -= sprite.textureBytes;
+    stats.evictions++;
+}
+
+// Load an evicted sprite back from where it first came from
+void TextureManager::restore(const std::string& name, Sprite& sprite) {
+    sprite.reloadRequested = frameNumber;
+    stats.reloads++;
+    const Origin& origin = origins[name];
+    if (!origin.path.empty()) {
+        pendingLoads++;
+        decodeAsync(name, origin.path, 0);
+    } else if (origin.generator >= 0) {
+        generateAsync(origin.generator);
+    } else if (const AssetPackEntry* entry = pack.isOpen() ? pack.find(name) : nullptr) {
+        uploadPacked(sprite, name, *entry);
+    }
+}
+
+// The sprite to draw now, marked as used this frame; null if it is not resident
+Sprite* TextureManager::use(const std::string& name) {
+    auto it = sprites.find(name);
+    if (it == sprites.end()) return nullptr;
+    Sprite& sprite = it->second;
+    sprite.lastUsed = frameNumber;
+    if (sprite.evicted) {
+        if (sprite.reloadRequested < 0) restore(it->first, sprite);
+        if (!sprite.ready) stats.stalledDraws++;
+    }
+    return sprite.ready ? &sprite : nullptr;
+}
+
+// Texture state for drawing the sprite with palette row `palette`
+void TextureManager::bind(const std::string& name, const Sprite& sprite, int palette, float r,
+                          float g, float b, float a) {
+    RenderBackend& gfx = renderBackend();
+    if (sprite.indexed) {
+        if (palette < 0 || palette >= sprite.paletteRows) palette = 0;
+        gfx.bindTexture(sprite.textureID, sprite.paletteID, sprite.paletteSize,
+                        (palette + 0.5f) / sprite.paletteRows);
+    } else {
+        if (palette > 0) {
+            // Colours cannot be swapped in an RGBA texture, so only the tint applies
+            const PaletteVariants& rows = variants[name];
+            if (palette <= (int)rows.size()) {
+                const PaletteSwap& swap = rows[palette - 1].second;
+                r *= swap.r;
+                g *= swap.g;
+                b *= swap.b;
+            }
+        }
+        gfx.bindTexture(sprite.textureID);
+    }
+    gfx.color(r, g, b, a);
+}
+
 void TextureManager::drawSprite(const std::string& name, float x, float y, float scaleX,
                                 float scaleY, int frame, bool flipX, float r, float g, float b,
-                                float a) {
-    auto it = sprites.find(name);
-    if (it == sprites.end()) return;
+                                float a, int palette) {
+    const Sprite* found = use(name);
+    if (!found) return;
 
-    const Sprite& sprite = it->second;
+    const Sprite& sprite = *found;
 
     // Clamp frame
     if (frame >= sprite.frameCount) frame = frame % sprite.frameCount;
@@ -75,50 +567,73 @@ void TextureManager::drawSprite(const std::string& name, float x, float y, float
     float halfW = (sprite.frameWidth * scaleX) / 2.0f;
     float halfH = (sprite.frameHeight * scaleY) / 2.0f;
 
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, sprite.textureID);
-    glColor4f(r, g, b, a);
+    float vBottom = sprite.topDown ? 1.0f : 0.0f;
+    float vTop = 1.0f - vBottom;
 
-    glBegin(GL_QUADS);
-    glTexCoord2f(u0, 0.0f);
-    glVertex2f(x - halfW, y - halfH);  // Bottom-left
-    glTexCoord2f(u1, 0.0f);
-    glVertex2f(x + halfW, y - halfH);  // Bottom-right
-    glTexCoord2f(u1, 1.0f);
-    glVertex2f(x + halfW, y + halfH);  // Top-right
-    glTexCoord2f(u0, 1.0f);
-    glVertex2f(x - halfW, y + halfH);  // Top-left
-    glEnd();
+    RenderBackend& gfx = renderBackend();
+    bind(name, sprite, palette, r, g, b, a);
 
-    glDisable(GL_TEXTURE_2D);
+    gfx.begin(Primitive::QUADS);
+    gfx.texCoord(u0, vBottom);
+    gfx.vertex(x - halfW, y - halfH);  // Bottom-left
+    gfx.texCoord(u1, vBottom);
+    gfx.vertex(x + halfW, y - halfH);  // Bottom-right
+    gfx.texCoord(u1, vTop);
+    gfx.vertex(x + halfW, y + halfH);  // Top-right
+    gfx.texCoord(u0, vTop);
+    gfx.vertex(x - halfW, y + halfH);  // Top-left
+    gfx.end();
+
+    gfx.unbindTexture();
+}
+
+void TextureManager::drawSprites(const std::string& name, const DrawInstance* instances,
+                                 size_t count) {
+    if (count == 0) return;
+    const Sprite* found = use(name);
+    if (!found) return;
+
+    const Sprite& sprite = *found;
+    InstanceSet set;
+    set.halfWidth = sprite.frameWidth / 2.0f;
+    set.halfHeight = sprite.frameHeight / 2.0f;
+    set.frameWidth = (float)sprite.frameWidth / sprite.width;
+    set.frameCount = sprite.frameCount;
+    set.vBottom = sprite.topDown ? 1.0f : 0.0f;
+    set.vTop = 1.0f - set.vBottom;
+
+    RenderBackend& gfx = renderBackend();
+    bind(name, sprite, 0, 1.0f, 1.0f, 1.0f, 1.0f);
+    gfx.drawSprites(set, instances, count);
+    gfx.unbindTexture();
 }
 
 void TextureManager::drawTiled(const std::string& name, float x, float y, float width,
                                float height) {
-    auto it = sprites.find(name);
-    if (it == sprites.end()) return;
+    const Sprite* found = use(name);
+    if (!found) return;
 
-    const Sprite& sprite = it->second;
+    const Sprite& sprite = *found;
 
     float tilesX = width / sprite.width;
     float tilesY = height / sprite.height;
+    if (sprite.topDown) tilesY = -tilesY;  // Tiles still start at the bottom edge
 
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, sprite.textureID);
-    glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+    RenderBackend& gfx = renderBackend();
+    bind(name, sprite, 0, 1.0f, 1.0f, 1.0f, 1.0f);
 
-    glBegin(GL_QUADS);
-    glTexCoord2f(0.0f, 0.0f);
-    glVertex2f(x, y);
-    glTexCoord2f(tilesX, 0.0f);
-    glVertex2f(x + width, y);
-    glTexCoord2f(tilesX, tilesY);
-    glVertex2f(x + width, y + height);
-    glTexCoord2f(0.0f, tilesY);
-    glVertex2f(x, y + height);
-    glEnd();
+    gfx.begin(Primitive::QUADS);
+    gfx.texCoord(0.0f, 0.0f);
+    gfx.vertex(x, y);
+    gfx.texCoord(tilesX, 0.0f);
+    gfx.vertex(x + width, y);
+    gfx.texCoord(tilesX, tilesY);
+    gfx.vertex(x + width, y + height);
+    gfx.texCoord(0.0f, tilesY);
+    gfx.vertex(x, y + height);
+    gfx.end();
 
-    glDisable(GL_TEXTURE_2D);
+    gfx.unbindTexture();
 }
 
 const Sprite* TextureManager::getSprite(const std::string& name) const {
@@ -128,8 +643,25 @@ const Sprite* TextureManager::getSprite(const std::string& name) const {
 }
 
 void TextureManager::cleanup() {
+    loaders.wait(decoding);
+    for (Decoded& d : decoded) stbi_image_free(d.pixels);
+    decoded.clear();
+    pendingLoads = 0;
+
     for (auto& pair : sprites) {
+        if (!pair.second.ready) continue;
         glDeleteTextures(1, &pair.second.textureID);
+        if (pair.second.paletteID) glDeleteTextures(1, &pair.second.paletteID);
     }
     sprites.clear();
+    origins.clear();
+    palettes.clear();  // Variants stay defined for the next load
+    pack.close();
+    size_t budget = stats.budgetBytes;
+    stats = TextureStats();
+    stats.budgetBytes = budget;
+
+    if (watchFd >= 0) close(watchFd);
+    watchFd = -1;
+    reloadSerials.clear();
 }
@@ -0,0 +1,136 @@
+#include "transport.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// ─────────────────────────────────────────
+// UDP
+// ─────────────────────────────────────────
+
+UdpTransport::UdpTransport() : fd(-1), peerAddress(0), peerPort(0) {}
+
+UdpTransport::~UdpTransport() {
+    close();
+}
+
+bool UdpTransport::open(uint16_t localPort, const std::string& host, uint16_t remotePort) {
+    close();
+
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* found = nullptr;
+    if (getaddrinfo(host.c_str(), nullptr, &hints, &found) != 0 || !found) {
+        fprintf(stderr, "Unknown peer host: %s\n", host.c_str());
+        return false;
+    }
+    peerAddress = ((const sockaddr_in*)found->ai_addr)->sin_addr.s_addr;
+    peerPort = htons(remotePort);
+    freeaddrinfo(found);
+
+    fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        perror("socket");
+        return false;
+    }
+    sockaddr_in local;
+    memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    local.sin_port = htons(localPort);
+    if (bind(fd, (const sockaddr*)&local, sizeof(local)) != 0) {
+        fprintf(stderr, "Failed to bind UDP port %u\n", localPort);
+        close();
+        return false;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return true;
+}
+
+void UdpTransport::close() {
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+}
+
+void UdpTransport::send(const uint8_t* data, size_t size) {
+    if (fd < 0) return;
+    sockaddr_in to;
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_addr.s_addr = peerAddress;
+    to.sin_port = peerPort;
+    // A full socket buffer loses the datagram, which the protocol tolerates anyway
+    sendto(fd, data, size, 0, (const sockaddr*)&to, sizeof(to));
+}
+
+size_t UdpTransport::receive(uint8_t* buffer, size_t capacity) {
+    if (fd < 0) return 0;
+    for (;;) {
+        sockaddr_in from;
+        socklen_t fromSize = sizeof(from);
+        ssize_t n = recvfrom(fd, buffer, capacity, 0, (sockaddr*)&from, &fromSize);
+        if (n < 0) return 0;  // EAGAIN: nothing waiting
+        if (from.sin_addr.s_addr == peerAddress && from.sin_port == peerPort) return n;
+    }
+}
+
+// ─────────────────────────────────────────
+// In-process link simulator
+// ─────────────────────────────────────────
+
+LoopbackLink::LoopbackLink(const LinkConditions& c, uint32_t seed)
+    : conditions(c), rng(seed ? seed : 0x9E3779B9u), now(0), stats() {
+    endpoints[0].attach(this, 0);
+    endpoints[1].attach(this, 1);
+}
+
+// xorshift32, so a seed reproduces the same losses and delays everywhere
+float LoopbackLink::uniform() {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return (rng >> 8) / 16777216.0f;
+}
+
+void LoopbackLink::post(int to, const uint8_t* data, size_t size) {
+    Datagram d;
+    d.deliverAt = now + conditions.latencyMs + conditions.jitterMs * uniform();
+    d.data.assign(data, data + size);
+
+    // Keep the inbox in delivery order; equal times keep send order
+    std::vector<Datagram>& box = inbox[to];
+    auto at = std::upper_bound(box.begin(), box.end(), d.deliverAt,
+                               [](double t, const Datagram& x) { return t < x.deliverAt; });
+    box.insert(at, std::move(d));
+}
+
+void LoopbackLink::Endpoint::send(const uint8_t* data, size_t size) {
+    LinkStats& stats = link->stats;
+    stats.datagrams++;
+    stats.bytes += size;
+    if (link->uniform() < link->conditions.loss) {
+        stats.dropped++;
+        return;
+    }
+    link->post(1 - side, data, size);
+    if (link->uniform() < link->conditions.duplicate) {
+        stats.duplicated++;
+        link->post(1 - side, data, size);
+    }
+}
+
+size_t LoopbackLink::Endpoint::receive(uint8_t* buffer, size_t capacity) {
+    std::vector<Datagram>& box = link->inbox[side];
+    if (box.empty() || box.front().deliverAt > link->now) return 0;
+    size_t n = std::min(capacity, box.front().data.size());
+    memcpy(buffer, box.front().data.data(), n);
+    box.erase(box.begin());
+    return n;
+}
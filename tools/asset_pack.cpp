@@ -0,0 +1,101 @@
+// Packs sprite PNGs into a .pha asset pack of pre-decoded images
+// Build: make pack
+//
+// Usage:
+//   asset_pack [--no-flip] [--rgba] <output.pha> <name>=<image.png>[:<frames>] ...
+//   asset_pack --dump <input.pha>                 List a pack's contents
+//
+// Images are stored bottom-up, ready for glTexImage2D, unless --no-flip is given, and
+// palette-indexed if they have at most 256 colours, unless --rgba is given.
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include "assetpack.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static bool loadImage(const std::string& spec, AssetPackImage& image) {
+    size_t equals = spec.find('=');
+    if (equals == std::string::npos || equals == 0) {
+        fprintf(stderr, "Expected NAME=IMAGE[:FRAMES], got %s\n", spec.c_str());
+        return false;
+    }
+    image.name = spec.substr(0, equals);
+    std::string path = spec.substr(equals + 1);
+    image.frameCount = 1;
+    size_t colon = path.rfind(':');
+    if (colon != std::string::npos) {
+        image.frameCount = atoi(path.c_str() + colon + 1);
+        path.erase(colon);
+    }
+    if (image.frameCount < 1) {
+        fprintf(stderr, "Bad frame count in %s\n", spec.c_str());
+        return false;
+    }
+
+    int channels;
+    unsigned char* data = stbi_load(path.c_str(), &image.width, &image.height, &channels, 4);
+    if (!data) {
+        fprintf(stderr, "Failed to load %s (%s)\n", path.c_str(), stbi_failure_reason());
+        return false;
+    }
+    image.rgba.assign(data, data + (size_t)image.width * image.height * 4);
+    stbi_image_free(data);
+    return true;
+}
+
+static int dump(const char* path) {
+    AssetPack pack;
+    if (!pack.open(path)) {
+        fprintf(stderr, "Cannot open asset pack %s\n", path);
+        return 1;
+    }
+    for (size_t i = 0; i < pack.entryCount(); i++) {
+        const AssetPackEntry& e = pack.entry(i);
+        char format[16] = "rgba8";
+        if (e.flags & ASSET_FLAG_INDEXED) {
+            snprintf(format, sizeof(format), "%d colours", pack.paletteSize(e));
+        }
+        printf("%-16s %4ux%-4u %2u frames  %s  %-11s offset %llu\n", e.name, e.width, e.height,
+               e.frameCount, (e.flags & ASSET_FLAG_FLIPPED) ? "bottom-up" : "top-down ", format,
+               (unsigned long long)e.offset);
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 3 && strcmp(argv[1], "--dump") == 0) return dump(argv[2]);
+
+    int first = 1;
+    bool flip = true, indexed = true;
+    for (; first < argc && strncmp(argv[first], "--", 2) == 0; first++) {
+        if (strcmp(argv[first], "--no-flip") == 0) {
+            flip = false;
+        } else if (strcmp(argv[first], "--rgba") == 0) {
+            indexed = false;
+        } else {
+            break;
+        }
+    }
+    if (argc - first < 2) {
+        fprintf(stderr,
+                "Usage: %s [--no-flip] [--rgba] <output.pha> <name>=<image.png>[:<frames>] ...\n"
+                "       %s --dump <input.pha>\n",
+                argv[0], argv[0]);
+        return 1;
+    }
+
+    std::vector<AssetPackImage> images;
+    size_t bytes = 0;
+    for (int i = first + 1; i < argc; i++) {
+        AssetPackImage image;
+        if (!loadImage(argv[i], image)) return 1;
+        bytes += image.rgba.size();
+        images.push_back(image);
+    }
+    if (!writeAssetPack(argv[first], images, flip, indexed)) return 1;
+    printf("Packed %zu images (%zu KB of pixels) into %s\n", images.size(), bytes / 1024,
+           argv[first]);
+    return 0;
+}
@@ -0,0 +1,148 @@
+// Headless soak test: the autoplay bot (see include/bot.h) plays generated levels for many
+// seeds in parallel while every tick is checked for physics anomalies
+// Build: make soak
+//
+// Usage:
+//   autoplay [--threads N] [--seeds N] [--first-seed S] [--platforms N] [--ticks N]
+//            [--tick-rate HZ]
+//
+// --ticks is updates per seed. Wins restart the level, so long runs keep playing. Exits with
+// 1 if any anomaly was seen.
+
+#include "bot.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const size_t MAX_KEPT = 8;     // Anomalies kept per seed
+static const size_t MAX_LISTED = 20;  // Anomalies printed in total
+
+struct SoakResult {
+    unsigned int seed;
+    long long ticks;
+    int deaths, gameOvers;
+    std::vector<float> completions;  // Game seconds to collect every coin, per win
+    int bestCoins, totalCoins;
+    size_t anomalyCount;
+    std::vector<Anomaly> anomalies;  // The first MAX_KEPT
+};
+
+static void usage() {
+    fprintf(stderr,
+            "usage: autoplay [--threads N] [--seeds N] [--first-seed S] [--platforms N]\n"
+            "                [--ticks N] [--tick-rate HZ]\n");
+}
+
+static void soak(SoakResult& result, int platforms, long long ticks, int tickRate) {
+    Game game;
+    game.setTickRate(tickRate);
+    game.setGeneratedLevel(LevelGenParams(result.seed, platforms));
+    Bot bot;
+    PhysicsMonitor monitor;
+    std::vector<Anomaly> found;
+
+    int lives = 0;
+    for (long long t = 0; t < ticks; t++) {
+        bot.act(game);
+        if (game.getState() == GameState::PLAYING) lives = game.getLives();
+        game.update();
+
+        result.bestCoins = std::max(result.bestCoins, game.getCoinsCollected());
+        result.totalCoins = game.getTotalCoins();
+        if (game.getLives() < lives) result.deaths++;
+        if (game.getState() == GameState::WIN) result.completions.push_back(game.getGameTime());
+        if (game.getState() == GameState::GAME_OVER) result.gameOvers++;
+
+        found.clear();
+        monitor.check(game, found);
+        for (const Anomaly& a : found) {
+            if (result.anomalies.size() < MAX_KEPT) result.anomalies.push_back(a);
+        }
+        result.anomalyCount += found.size();
+    }
+    result.ticks = ticks;
+}
+
+int main(int argc, char** argv) {
+    int threads = JobSystem::defaultWorkerCount();
+    int seeds = 8, platforms = 200, tickRate = BASE_TICK_RATE;
+    unsigned int firstSeed = 1;
+    long long ticks = 100000;
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            usage();
+            return 2;
+        }
+        if (strcmp(argv[i], "--threads") == 0) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seeds") == 0) {
+            seeds = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--first-seed") == 0) {
+            firstSeed = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--platforms") == 0) {
+            platforms = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--ticks") == 0) {
+            ticks = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--tick-rate") == 0) {
+            tickRate = atoi(argv[++i]);
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    std::vector<SoakResult> results(std::max(seeds, 0));
+    for (int i = 0; i < seeds; i++) {
+        results[i] = SoakResult();
+        results[i].seed = firstSeed + i;
+    }
+
+    // One game per seed; each game runs its own update phases on the calling worker
+    auto start = std::chrono::steady_clock::now();
+    JobSystem jobs(threads);
+    JobCounter done;
+    jobs.parallelFor(results.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) soak(results[i], platforms, ticks, tickRate);
+    }, done);
+    jobs.wait(done);
+    double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    long long totalTicks = 0;
+    size_t anomalies = 0;
+    std::vector<float> completions;
+    for (const SoakResult& r : results) {
+        printf("seed %u: %d/%d coins best, %zu wins, %d deaths, %d game overs, %zu anomalies\n",
+               r.seed, r.bestCoins, r.totalCoins, r.completions.size(), r.deaths, r.gameOvers,
+               r.anomalyCount);
+        totalTicks += r.ticks;
+        anomalies += r.anomalyCount;
+        completions.insert(completions.end(), r.completions.begin(), r.completions.end());
+    }
+
+    printf("%lld ticks in %.2f s: %.0f ticks/s (%d worker threads, %d Hz)\n", totalTicks, seconds,
+           totalTicks / seconds, threads, tickRate);
+    if (completions.empty()) {
+        printf("completions: none\n");
+    } else {
+        std::sort(completions.begin(), completions.end());
+        printf("completions: %zu, game time min %.1f s, median %.1f s, max %.1f s\n",
+               completions.size(), completions.front(), completions[completions.size() / 2],
+               completions.back());
+    }
+
+    printf("anomalies: %zu\n", anomalies);
+    size_t listed = 0;
+    for (const SoakResult& r : results) {
+        for (size_t i = 0; i < r.anomalies.size() && listed < MAX_LISTED; i++, listed++) {
+            const Anomaly& a = r.anomalies[i];
+            printf("  seed %u tick %d: %s at (%.1f, %.1f)\n", r.seed, a.tick, a.kind.c_str(), a.x,
+                   a.y);
+        }
+    }
+    if (anomalies > listed) printf("  ...\n");
+
+    return anomalies == 0 ? 0 : 1;
+}
@@ -0,0 +1,296 @@
+// Frame time comparison of the render backends (include/backend.h): the same game, played by
+// the autoplay bot, is drawn offscreen with each backend in turn and the frame times, draw
+// calls and the last frame of each are compared. Runs without a display through EGL's
+// surfaceless platform; LIBGL_ALWAYS_SOFTWARE=1 forces llvmpipe on machines with a GPU.
+// Build: make frametime
+//
+// Usage:
+//   frametime [--frames N] [--warmup N] [--level FILE | --seed S] [--png DIR]
+//             [--particles N] [--per-sprite] [--immediate-platforms]
+//
+// --warmup is updates played before timing starts, so the camera is inside the level.
+// --png writes each backend's last frame as DIR/fixed.png and DIR/core.png.
+// --particles adds N particles spread over the screen to every frame, drawn as one
+// instanced set, or one sprite at a time with --per-sprite (coins too).
+// --immediate-platforms draws every platform anew each frame instead of static ones from
+// retained per-chunk geometry.
+
+#define GL_GLEXT_PROTOTYPES
+#include "arena.h"
+#include "backend.h"
+#include "bot.h"
+#include "constants.h"
+#include "stb_image_write.h"
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GL/glext.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct Options {
+    int frames = 600;
+    int warmup = 300;
+    std::string levelPath = "assets/levels/default.phl";
+    unsigned int seed = 0;  // Generated level if set
+    std::string pngDir;
+    int particles = 0;
+    bool perSprite = false;
+    bool immediatePlatforms = false;
+};
+
+struct RunResult {
+    bool ok;
+    std::string glRenderer;
+    std::vector<double> frameMs;   // Submit to glFinish
+    std::vector<double> submitMs;  // Submit to endFrame(): the CPU side
+    RenderStats stats;            // Of the last frame
+    std::vector<unsigned char> rgba;
+};
+
+static void usage() {
+    fprintf(stderr,
+            "usage: frametime [--frames N] [--warmup N] [--level FILE | --seed S] [--png DIR]\n"
+            "                 [--particles N] [--per-sprite] [--immediate-platforms]\n");
+}
+
+static EGLDisplay openDisplay() {
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (!getPlatformDisplay) return EGL_NO_DISPLAY;
+    EGLDisplay display =
+        getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr)) {
+        return EGL_NO_DISPLAY;
+    }
+    eglBindAPI(EGL_OPENGL_API);
+    return display;
+}
+
+// A context of the profile `kind` needs, drawing into a window-sized RGBA8 framebuffer
+static EGLContext createContext(EGLDisplay display, RendererKind kind) {
+    EGLint configAttribs[] = {EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE,
+                              EGL_OPENGL_BIT, EGL_NONE};
+    EGLConfig config;
+    EGLint configs = 0;
+    eglChooseConfig(display, configAttribs, &config, 1, &configs);
+
+    bool core = kind == RendererKind::CORE;
+    EGLint contextAttribs[] = {EGL_CONTEXT_MAJOR_VERSION,
+                               core ? 3 : 2,
+                               EGL_CONTEXT_MINOR_VERSION,
+                               core ? 3 : 1,
+                               EGL_CONTEXT_OPENGL_PROFILE_MASK,
+                               core ? EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT
+                                    : EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT,
+                               EGL_NONE};
+    EGLContext context =
+        eglCreateContext(display, configs ? config : nullptr, EGL_NO_CONTEXT, contextAttribs);
+    if (context == EGL_NO_CONTEXT) return context;
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context);
+    return context;
+}
+
+// Still particles over the whole screen, the same for every run
+static std::vector<Particle> particleField(int count) {
+    std::vector<Particle> particles;
+    particles.reserve(count);
+    srand(11);
+    for (int i = 0; i < count; i++) {
+        Color color(1.0f, 0.5f + (rand() % 50) / 100.0f, 0.2f, 0.2f + (rand() % 80) / 100.0f);
+        particles.emplace_back(rand() % WINDOW_WIDTH, rand() % WINDOW_HEIGHT, 0, 0, color, 60);
+    }
+    return particles;
+}
+
+static double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0;
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, (size_t)(p * values.size()))];
+}
+
+static RunResult run(EGLDisplay display, RendererKind kind, const Options& options) {
+    RunResult result;
+    result.ok = false;
+    result.stats = RenderStats();
+    EGLContext context = createContext(display, kind);
+    if (context == EGL_NO_CONTEXT) {
+        fprintf(stderr, "No GL context for the %s renderer (EGL error 0x%x)\n",
+                kind == RendererKind::CORE ? "core" : "fixed function", eglGetError());
+        return result;
+    }
+    result.glRenderer = (const char*)glGetString(GL_RENDERER);
+
+    GLuint framebuffer, colorBuffer;
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, WINDOW_WIDTH, WINDOW_HEIGHT);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER,
+                              colorBuffer);
+    glViewport(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
+    glClearColor(0.6f, 0.8f, 1.0f, 1.0f);
+
+    if (selectRenderBackend(kind)) {
+        RenderBackend& gfx = renderBackend();
+        Game* game = new Game();
+        if (options.seed) {
+            game->setGeneratedLevel(LevelGenParams(options.seed));
+        } else {
+            game->setLevelFile(options.levelPath);
+        }
+        game->init();
+        TextureManager::getInstance().finishLoading();
+        srand(1);  // Both backends see the same particles
+        game->handleKeyDown(13);
+        game->handleKeyUp(13);
+        game->getRenderer().setInstancing(!options.perSprite);
+        game->getRenderer().setRetainedPlatforms(!options.immediatePlatforms);
+        Renderer overlay;
+        overlay.setInstancing(!options.perSprite);
+        std::vector<Particle> field = particleField(options.particles);
+        Bot bot;
+        for (int i = 0; i < options.warmup; i++) {
+            bot.act(*game);
+            game->update();
+        }
+
+        for (int i = 0; i < options.frames; i++) {
+            bot.act(*game);
+            game->update();
+            frameArena.reset();
+            auto start = std::chrono::steady_clock::now();
+            gfx.beginFrame(WINDOW_WIDTH, WINDOW_HEIGHT);
+            game->render();
+            overlay.drawParticles(field, 0);
+            gfx.endFrame();
+            auto submitted = std::chrono::steady_clock::now();
+            glFinish();
+            auto finished = std::chrono::steady_clock::now();
+            result.submitMs.push_back(
+                std::chrono::duration<double, std::milli>(submitted - start).count());
+            result.frameMs.push_back(
+                std::chrono::duration<double, std::milli>(finished - start).count());
+        }
+        result.stats = gfx.getStats();
+        result.rgba.resize((size_t)WINDOW_WIDTH * WINDOW_HEIGHT * 4);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE,
+                     result.rgba.data());
+        result.ok = true;
+
+        delete game;
+        TextureManager::getInstance().cleanup();
+    }
+
+    glDeleteRenderbuffers(1, &colorBuffer);
+    glDeleteFramebuffers(1, &framebuffer);
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(display, context);
+    return result;
+}
+
+static void writePng(const std::string& path, const std::vector<unsigned char>& rgba) {
+    // GL rows are bottom-up
+    int stride = WINDOW_WIDTH * 4;
+    if (!stbi_write_png(path.c_str(), WINDOW_WIDTH, WINDOW_HEIGHT, 4,
+                        rgba.data() + (size_t)(WINDOW_HEIGHT - 1) * stride, -stride)) {
+        fprintf(stderr, "Cannot write %s\n", path.c_str());
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--per-sprite") == 0) {
+            options.perSprite = true;
+            continue;
+        }
+        if (strcmp(argv[i], "--immediate-platforms") == 0) {
+            options.immediatePlatforms = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            usage();
+            return 1;
+        }
+        if (strcmp(argv[i], "--frames") == 0) {
+            options.frames = std::max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--warmup") == 0) {
+            options.warmup = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--level") == 0) {
+            options.levelPath = argv[++i];
+        } else if (strcmp(argv[i], "--seed") == 0) {
+            options.seed = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--png") == 0) {
+            options.pngDir = argv[++i];
+        } else if (strcmp(argv[i], "--particles") == 0) {
+            options.particles = atoi(argv[++i]);
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    setGlutText(false);  // No glutInit here
+    EGLDisplay display = openDisplay();
+    if (display == EGL_NO_DISPLAY) {
+        fprintf(stderr, "No EGL surfaceless display\n");
+        return 1;
+    }
+
+    const RendererKind kinds[2] = {RendererKind::FIXED_FUNCTION, RendererKind::CORE};
+    const char* names[2] = {"fixed", "core"};
+    RunResult results[2];
+    for (int k = 0; k < 2; k++) {
+        results[k] = run(display, kinds[k], options);
+        if (!results[k].ok) return 1;
+    }
+    eglTerminate(display);
+
+    printf("%d frames of %dx%d on %s\n\n", options.frames, WINDOW_WIDTH, WINDOW_HEIGHT,
+           results[0].glRenderer.c_str());
+    printf("%-8s %10s %10s %10s %10s %12s %10s %8s\n", "renderer", "mean ms", "p50 ms",
+           "p95 ms", "submit ms", "draw calls", "vertices", "orphans");
+    for (int k = 0; k < 2; k++) {
+        const RunResult& r = results[k];
+        double total = 0, submit = 0;
+        for (size_t i = 0; i < r.frameMs.size(); i++) {
+            total += r.frameMs[i];
+            submit += r.submitMs[i];
+        }
+        printf("%-8s %10.3f %10.3f %10.3f %10.3f %12d %10ld %8d\n", names[k],
+               total / r.frameMs.size(), percentile(r.frameMs, 0.5),
+               percentile(r.frameMs, 0.95), submit / r.frameMs.size(), r.stats.drawCalls,
+               r.stats.vertices, r.stats.bufferOrphans);
+    }
+
+    // How far apart the two last frames are
+    const std::vector<unsigned char>& a = results[0].rgba;
+    const std::vector<unsigned char>& b = results[1].rgba;
+    long long difference = 0;
+    int differing = 0, pixels = WINDOW_WIDTH * WINDOW_HEIGHT;
+    for (int i = 0; i < pixels; i++) {
+        int largest = 0;
+        for (int c = 0; c < 3; c++) {
+            int d = abs(a[(size_t)i * 4 + c] - b[(size_t)i * 4 + c]);
+            difference += d;
+            largest = std::max(largest, d);
+        }
+        if (largest > 8) differing++;
+    }
+    printf("\nLast frames: mean channel difference %.3f, %.2f%% of pixels off by more than 8\n",
+           (double)difference / (pixels * 3.0), 100.0 * differing / pixels);
+
+    if (!options.pngDir.empty()) {
+        for (int k = 0; k < 2; k++) {
+            writePng(options.pngDir + "/" + names[k] + ".png", results[k].rgba);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,185 @@
+// Converts text level sources into binary .phl level files
+// Build: make levels
+//
+// Usage:
+//   level_pack <input.txt> <output.phl>           Pack an authored level
+//   level_pack --generate <seed> <platforms> <output.phl>
+//   level_pack --builtin <output.phl>             Export the compiled-in level
+//   level_pack --dump <input.phl>                 Print a level file as text source
+//
+// Text format (one entry per line, '#' starts a comment):
+//   bounds   <width> <height>
+//   color    <name> <r> <g> <b>
+//   platform <x> <y> <w> <h> <color> [<speed> <range>]   (speed/range make it move)
+//   coin     <x> <y>
+//   enemy    <x> <y> <patrolLeft> <patrolRight> [static]
+// Predefined colors: ground, float, high, move, goal.
+
+#include "levelfile.h"
+#include "levelgen.h"
+#include "constants.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+static std::map<std::string, Color> defaultPalette() {
+    std::map<std::string, Color> palette;
+    palette["ground"] = Color(0.2f, 0.7f, 0.2f);
+    palette["float"] = Color(0.8f, 0.5f, 0.2f);
+    palette["high"] = Color(0.6f, 0.3f, 0.8f);
+    palette["move"] = Color(0.5f, 0.4f, 0.7f);
+    palette["goal"] = Color(0.8f, 0.7f, 0.2f);
+    return palette;
+}
+
+static bool parseLevel(const char* path, float& width, float& height,
+                       std::vector<Platform>& platforms, std::vector<Collectible>& coins,
+                       std::vector<Enemy>& enemies) {
+    std::ifstream in(path);
+    if (!in) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return false;
+    }
+
+    std::map<std::string, Color> palette = defaultPalette();
+    width = DEFAULT_LEVEL_WIDTH;
+    height = WINDOW_HEIGHT;
+
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        lineNo++;
+        size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+
+        std::istringstream ss(line);
+        std::string kind;
+        if (!(ss >> kind)) continue;
+
+        bool ok = true;
+        if (kind == "bounds") {
+            ok = (bool)(ss >> width >> height);
+        } else if (kind == "color") {
+            std::string name;
+            float r, g, b;
+            ok = (bool)(ss >> name >> r >> g >> b);
+            if (ok) palette[name] = Color(r, g, b);
+        } else if (kind == "platform") {
+            float x, y, w, h;
+            std::string colorName;
+            ok = (bool)(ss >> x >> y >> w >> h >> colorName) && palette.count(colorName);
+            float speed = 0, range = 0;
+            bool moving = ok && (bool)(ss >> speed >> range);
+            if (ok) {
+                platforms.push_back(Platform(x, y, w, h, palette[colorName], moving, speed, range));
+            }
+        } else if (kind == "coin") {
+            float x, y;
+            ok = (bool)(ss >> x >> y);
+            if (ok) coins.push_back(Collectible(x, y));
+        } else if (kind == "enemy") {
+            float x, y, left, right;
+            std::string type;
+            ok = (bool)(ss >> x >> y >> left >> right);
+            EnemyType t =
+                ((ss >> type) && type == "static") ? EnemyType::STATIC : EnemyType::PATROL;
+            if (ok) enemies.push_back(Enemy(x, y, left, right, t));
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            fprintf(stderr, "%s:%d: cannot parse '%s'\n", path, lineNo, line.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+static std::string paletteName(const std::map<std::string, Color>& palette,
+                               const PlatformRecord& r) {
+    for (const auto& entry : palette) {
+        const Color& c = entry.second;
+        if (fabs(c.r - r.r) < 1e-4f && fabs(c.g - r.g) < 1e-4f && fabs(c.b - r.b) < 1e-4f) {
+            return entry.first;
+        }
+    }
+    return "";
+}
+
+static int dumpLevel(const char* path) {
+    LevelFile file;
+    if (!file.open(path)) return 1;
+
+    std::map<std::string, Color> palette = defaultPalette();
+    printf("# Dumped from %s\n", path);
+    printf("bounds %g %g\n\n", file.width(), file.height());
+
+    for (size_t i = 0; i < file.platformCount(); i++) {
+        const PlatformRecord& r = file.platforms()[i];
+        std::string name = paletteName(palette, r);
+        if (name.empty()) {
+            name = "c" + std::to_string(palette.size());
+            palette[name] = Color(r.r, r.g, r.b);
+            printf("color %s %g %g %g\n", name.c_str(), r.r, r.g, r.b);
+        }
+        printf("platform %g %g %g %g %s", r.x, r.y, r.width, r.height, name.c_str());
+        if (r.flags & PLATFORM_RECORD_MOVING) printf(" %g %g", r.moveSpeed, r.moveRange);
+        printf("\n");
+    }
+    printf("\n");
+    for (size_t i = 0; i < file.coinCount(); i++) {
+        printf("coin %g %g\n", file.coins()[i].x, file.coins()[i].y);
+    }
+    printf("\n");
+    for (size_t i = 0; i < file.enemyCount(); i++) {
+        const EnemyRecord& r = file.enemies()[i];
+        printf("enemy %g %g %g %g%s\n", r.x, r.y, r.patrolLeft, r.patrolRight,
+               r.type == (uint32_t)EnemyType::STATIC ? " static" : "");
+    }
+    return 0;
+}
+
+static void usage() {
+    fprintf(stderr,
+            "usage: level_pack <input.txt> <output.phl>\n"
+            "       level_pack --generate <seed> <platforms> <output.phl>\n"
+            "       level_pack --builtin <output.phl>\n"
+            "       level_pack --dump <input.phl>\n");
+}
+
+int main(int argc, char** argv) {
+    std::vector<Platform> platforms;
+    std::vector<Collectible> coins;
+    std::vector<Enemy> enemies;
+    float width = DEFAULT_LEVEL_WIDTH, height = WINDOW_HEIGHT;
+    const char* output = nullptr;
+
+    if (argc == 3 && strcmp(argv[1], "--dump") == 0) {
+        return dumpLevel(argv[2]);
+    } else if (argc == 5 && strcmp(argv[1], "--generate") == 0) {
+        LevelGenParams params(strtoul(argv[2], nullptr, 10), atoi(argv[3]));
+        width = generateLevel(params, platforms, coins, enemies);
+        output = argv[4];
+    } else if (argc == 3 && strcmp(argv[1], "--builtin") == 0) {
+        initializePlatforms(platforms);
+        initializeCollectibles(coins);
+        initializeEnemies(enemies);
+        output = argv[2];
+    } else if (argc == 3 && argv[1][0] != '-') {
+        if (!parseLevel(argv[1], width, height, platforms, coins, enemies)) return 1;
+        output = argv[2];
+    } else {
+        usage();
+        return 2;
+    }
+
+    if (!writeLevelFile(output, width, height, platforms, coins, enemies)) return 1;
+    printf("Packed %s: %zu platforms, %zu coins, %zu enemies, %gx%g\n", output, platforms.size(),
+           coins.size(), enemies.size(), width, height);
+    return 0;
+}
@@ -0,0 +1,85 @@
+// Checks that every coin in a level can be collected and that no reachable platform traps
+// the player, using precomputed jump envelopes (see include/reachability.h)
+// Build: make validate
+//
+// Usage:
+//   level_validate [--threads N] <level.phl>
+//   level_validate [--threads N] --generate <seed> <platforms>
+//   level_validate [--threads N] --builtin
+//
+// Exits with 1 if any coin is unreachable or any platform is a soft-lock.
+
+#include "reachability.h"
+#include "levelfile.h"
+#include "levelgen.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const size_t MAX_LISTED = 20;  // Problems printed per category
+
+static void usage() {
+    fprintf(stderr,
+            "usage: level_validate [--threads N] <level.phl>\n"
+            "       level_validate [--threads N] --generate <seed> <platforms>\n"
+            "       level_validate [--threads N] --builtin\n");
+}
+
+static void listPlatforms(const char* title, const std::vector<int>& list,
+                          const std::vector<Platform>& platforms) {
+    printf("%s: %zu\n", title, list.size());
+    for (size_t i = 0; i < list.size() && i < MAX_LISTED; i++) {
+        const Platform& p = platforms[list[i]];
+        printf("  platform %d at (%g, %g) %gx%g\n", list[i], p.originalX, p.y, p.width, p.height);
+    }
+    if (list.size() > MAX_LISTED) printf("  ...\n");
+}
+
+int main(int argc, char** argv) {
+    std::vector<Platform> platforms;
+    std::vector<Collectible> coins;
+    std::vector<Enemy> enemies;
+
+    int threads = JobSystem::defaultWorkerCount();
+    int arg = 1;
+    if (arg + 1 < argc && strcmp(argv[arg], "--threads") == 0) {
+        threads = atoi(argv[arg + 1]);
+        arg += 2;
+    }
+
+    int rest = argc - arg;
+    if (rest == 3 && strcmp(argv[arg], "--generate") == 0) {
+        LevelGenParams params(strtoul(argv[arg + 1], nullptr, 10), atoi(argv[arg + 2]));
+        generateLevel(params, platforms, coins, enemies);
+    } else if (rest == 1 && strcmp(argv[arg], "--builtin") == 0) {
+        initializePlatforms(platforms);
+        initializeCollectibles(coins);
+        initializeEnemies(enemies);
+    } else if (rest == 1 && argv[arg][0] != '-') {
+        LevelFile file;
+        if (!file.open(argv[arg])) return 1;
+        file.instantiate(platforms, coins, enemies);
+    } else {
+        usage();
+        return 2;
+    }
+
+    JobSystem jobs(threads);
+    ReachabilityReport report = validateLevel(platforms, coins, jobs);
+
+    printf("%zu platforms, %zu coins: graph of %zu nodes, %zu edges\n", platforms.size(),
+           coins.size(), report.nodes, report.edges);
+    printf("built in %.3f s, searched in %.3f s (%d worker threads)\n", report.buildSeconds,
+           report.searchSeconds, threads);
+
+    printf("unreachable coins: %zu\n", report.unreachableCoins.size());
+    for (size_t i = 0; i < report.unreachableCoins.size() && i < MAX_LISTED; i++) {
+        const Collectible& c = coins[report.unreachableCoins[i]];
+        printf("  coin %d at (%g, %g)\n", report.unreachableCoins[i], c.x, c.y);
+    }
+    if (report.unreachableCoins.size() > MAX_LISTED) printf("  ...\n");
+    listPlatforms("soft-locks", report.softLocks, platforms);
+    listPlatforms("unreachable platforms", report.unreachablePlatforms, platforms);
+
+    return report.unreachableCoins.empty() && report.softLocks.empty() ? 0 : 1;
+}
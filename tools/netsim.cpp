@@ -0,0 +1,143 @@
+// Offline rollback test: two peers play co-op over a simulated lossy link, each with its own
+// Game and an autoplay bot (include/bot.h) deciding from what that peer sees. Afterwards
+// both must agree with a reference game replaying every input on time.
+// Build: make netsim
+//
+// Usage:
+//   netsim [--ticks N] [--seed S] [--platforms N] [--latency MS] [--jitter MS] [--loss P]
+//          [--duplicate P] [--tick-rate HZ] [--threads N]
+//
+// Exits with 1 if the peers desync or disagree with the reference.
+
+#include "bot.h"
+#include "netplay.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const int SETTLE_FRAMES = 600;  // Frames allowed for the last inputs to arrive
+
+static void startGame(Game& game, const LevelGenParams& level, int tickRate, int threads) {
+    game.setWorkerThreads(threads);
+    game.setTickRate(tickRate);
+    game.setGeneratedLevel(level);
+    game.setTwoPlayer(true);
+    game.handleKeyDown(13);  // Menu to PLAYING, which loads the level
+    game.handleKeyUp(13);
+}
+
+static uint32_t checksumOf(const Game& game) {
+    GameSnapshot s;
+    game.saveState(s);
+    return stateChecksum(s);
+}
+
+static void printStats(const char* name, const SessionStats& s, int tickRate) {
+    double seconds = (double)s.ticks / tickRate;
+    printf("%s: %d ticks, %d stalls, %d rollbacks (%d ticks replayed, deepest %d, longest "
+           "%.3f ms), %d checksums compared, %d desyncs, %.0f B/s in %.0f datagrams/s\n",
+           name, s.ticks, s.stalls, s.rollbacks, s.resimulatedTicks, s.maxRollback,
+           s.maxRollbackMs, s.checksumsCompared, s.desyncs, s.bytesSent / seconds,
+           s.datagramsSent / seconds);
+}
+
+int main(int argc, char** argv) {
+    int ticks = 3600, platforms = 1000, tickRate = BASE_TICK_RATE, threads = 0;
+    uint32_t seed = 1;
+    LinkConditions conditions(40, 20, 0.05f, 0.01f);
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            fprintf(stderr, "%s needs a value\n", argv[i]);
+            return 2;
+        }
+        if (strcmp(argv[i], "--ticks") == 0) {
+            ticks = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0) {
+            seed = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--platforms") == 0) {
+            platforms = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--latency") == 0) {
+            conditions.latencyMs = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--jitter") == 0) {
+            conditions.jitterMs = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--loss") == 0) {
+            conditions.loss = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--duplicate") == 0) {
+            conditions.duplicate = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--tick-rate") == 0) {
+            tickRate = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            threads = atoi(argv[++i]);
+        } else {
+            fprintf(stderr,
+                    "usage: netsim [--ticks N] [--seed S] [--platforms N] [--latency MS]\n"
+                    "              [--jitter MS] [--loss P] [--duplicate P] [--tick-rate HZ]\n"
+                    "              [--threads N]\n");
+            return 2;
+        }
+    }
+
+    LevelGenParams level(seed, platforms);
+    Game games[2];
+    for (Game& g : games) startGame(g, level, tickRate, threads);
+    tickRate = games[0].getTickRate();
+
+    LoopbackLink link(conditions, seed);
+    RollbackSession peer0(games[0], link.endpoint(0), 0), peer1(games[1], link.endpoint(1), 1);
+    RollbackSession* peers[2] = {&peer0, &peer1};
+    Bot bot0(0), bot1(1);
+    Bot* bots[2] = {&bot0, &bot1};
+    std::vector<InputBits> inputs[2];  // Per peer, by tick
+
+    // One frame per tick of wall time; a stalled peer retries the same input next frame
+    double frameMs = 1000.0 / tickRate;
+    int frames = 0;
+    while (peer0.getTick() < ticks || peer1.getTick() < ticks) {
+        for (int p = 0; p < 2; p++) {
+            int t = peers[p]->getTick();
+            if (t >= ticks) {
+                peers[p]->poll();
+                continue;
+            }
+            if ((int)inputs[p].size() == t) inputs[p].push_back(bots[p]->decide(games[p]));
+            peers[p]->advance(inputs[p][t]);
+            if (peers[p]->hasEnded()) {
+                fprintf(stderr, "peer %d: the game state could not be saved\n", p);
+                return 1;
+            }
+        }
+        link.advance(frameMs);
+        frames++;
+    }
+    // Let the last inputs arrive and the final rollbacks land
+    for (int f = 0; f < SETTLE_FRAMES; f++) {
+        if (peer0.getConfirmedTick() == ticks && peer1.getConfirmedTick() == ticks) break;
+        peer0.poll();
+        peer1.poll();
+        link.advance(frameMs);
+    }
+
+    Game reference;
+    startGame(reference, level, tickRate, threads);
+    for (int t = 0; t < ticks; t++) {
+        reference.applyInput(0, inputs[0][t]);
+        reference.applyInput(1, inputs[1][t]);
+        reference.update();
+    }
+
+    printStats("peer 0", peer0.getStats(), tickRate);
+    printStats("peer 1", peer1.getStats(), tickRate);
+    const LinkStats& ls = link.getStats();
+    printf("link: %zu datagrams, %zu dropped, %zu duplicated; %d frames for %d ticks\n",
+           ls.datagrams, ls.dropped, ls.duplicated, frames, ticks);
+
+    uint32_t expected = checksumOf(reference);
+    bool settled = peer0.getConfirmedTick() == ticks && peer1.getConfirmedTick() == ticks;
+    bool agree = checksumOf(games[0]) == expected && checksumOf(games[1]) == expected;
+    int desyncs = peer0.getStats().desyncs + peer1.getStats().desyncs;
+    printf("final state: %s, score %d, coins %d/%d, lives %d\n",
+           !settled ? "NOT SETTLED" : agree ? "matches reference" : "DIFFERS FROM REFERENCE",
+           reference.getScore(), reference.getCoinsCollected(), reference.getTotalCoins(),
+           reference.getLives());
+    return settled && agree && desyncs == 0 ? 0 : 1;
+}
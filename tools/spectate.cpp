@@ -0,0 +1,138 @@
+// Spectator viewer: connects to a game started with --spectators and draws what it streams
+// (include/spectator.h), without simulating anything itself.
+// Build: make spectate
+//
+// Usage:
+//   spectate [unix:PATH | PORT]    default unix:/tmp/pixel_hero.sock
+//
+// Run it from the repository root so it finds the sprites and the game's level.
+
+#include <GL/glut.h>
+#include "arena.h"
+#include "backend.h"
+#include "spectator.h"
+#include <cstdio>
+#include <cstdlib>
+
+static SpectatorClient client;
+static Renderer renderer;
+static std::vector<int> visible;
+static std::vector<Platform> platforms;
+static std::vector<SpriteInstance> coinSprites, enemySprites;
+
+// What is in view at the stream's tick, posed like Game::render would
+static void gatherVisible(const SpectatorDecoder& d, float cameraX) {
+    float left = cameraX - ACTIVITY_MARGIN, right = cameraX + WINDOW_WIDTH + ACTIVITY_MARGIN;
+    int tick = d.view.tick;
+
+    platforms.clear();
+    d.platformIndex.query(left, right, visible);
+    for (int i : visible) {
+        platforms.push_back(d.platforms[i]);
+        platforms.back().advanceTo(tick);
+    }
+
+    coinSprites.clear();
+    d.coinIndex.query(left, right, visible);
+    for (int i : visible) {
+        const Collectible& c = d.collectibles[i];
+        if (c.collected) continue;
+        coinSprites.push_back(
+            poseSprite(SpriteKind::COIN, c.x, c.y, COIN_SPRITE_SCALE, tick + c.phase, false));
+    }
+
+    enemySprites.clear();
+    d.enemyIndex.query(left, right, visible);
+    for (int i : visible) {
+        const Enemy& e = d.enemies[i];
+        if (!e.alive) continue;
+        enemySprites.push_back(poseSprite(SpriteKind::ENEMY, e.x, e.y, ENEMY_SPRITE_SCALE,
+                                          tick + e.phase, !e.facingRight));
+    }
+}
+
+static void display() {
+    frameArena.reset();
+    RenderBackend& gfx = renderBackend();
+    gfx.beginFrame(WINDOW_WIDTH, WINDOW_HEIGHT);
+
+    renderer.pollAssets();
+    const SpectatorDecoder& d = client.decoder;
+    if (d.isReady()) {
+        const SpectatorView& v = d.view;
+        float cameraX = d.getCameraX();
+        Player player, partner;
+        d.posePlayer(0, player);
+        d.posePlayer(1, partner);
+        gatherVisible(d, cameraX);
+
+        switch (v.state) {
+            case GameState::MENU:
+                renderer.drawMenuScreen();
+                break;
+
+            case GameState::PLAYING:
+            case GameState::PAUSED:
+                renderer.drawBackground(cameraX);
+                renderer.drawPlatforms(platforms, cameraX);
+                renderer.drawCollectibles(coinSprites, cameraX);
+                renderer.drawEnemies(enemySprites, cameraX);
+                renderer.drawPlayer(player, cameraX);
+                if (v.twoPlayer) renderer.drawPlayer(partner, cameraX, true);
+                renderer.drawHUD(v.score, v.lives, v.seconds, player);
+                if (v.state == GameState::PAUSED) renderer.drawPauseOverlay();
+                break;
+
+            case GameState::GAME_OVER:
+                renderer.drawBackground(cameraX);
+                renderer.drawPlatforms(platforms, cameraX);
+                renderer.drawGameOverScreen(v.score, v.seconds);
+                break;
+
+            case GameState::WIN:
+                renderer.drawBackground(cameraX);
+                renderer.drawPlatforms(platforms, cameraX);
+                renderer.drawCollectibles(coinSprites, cameraX);
+                renderer.drawPlayer(player, cameraX);
+                renderer.drawWinScreen(v.score, v.seconds);
+                break;
+        }
+    }
+
+    gfx.endFrame();
+    glutSwapBuffers();
+}
+
+static void timer(int value) {
+    if (!client.poll()) {
+        printf("Stream ended after %zu bytes\n", client.bytesReceived());
+        exit(0);
+    }
+    renderer.updateGameTime(1.0f / 60);
+    glutPostRedisplay();
+    glutTimerFunc(16, timer, 0);
+}
+
+static void keyboard(unsigned char key, int x, int y) {
+    if (key == 27) exit(0);
+}
+
+int main(int argc, char** argv) {
+    glutInit(&argc, argv);
+    std::string address = argc > 1 ? argv[1] : "unix:/tmp/pixel_hero.sock";
+    if (!client.connect(address)) return 1;
+
+    glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB | GLUT_ALPHA);
+    glutInitWindowSize(WINDOW_WIDTH, WINDOW_HEIGHT);
+    glutInitWindowPosition(140, 140);
+    glutCreateWindow("PIXEL HERO - spectating");
+    selectRenderBackend(RendererKind::FIXED_FUNCTION);
+    glClearColor(0.6f, 0.8f, 1.0f, 1.0f);
+    renderer.loadAssets();
+
+    glutDisplayFunc(display);
+    glutKeyboardFunc(keyboard);
+    glutTimerFunc(0, timer, 0);
+    glutMainLoop();
+    return 0;
+}